@@ -1,5 +1,6 @@
 //#include "nfdrs4.h"
 #include "CNFDRSParams.h"
+#include <cstdio>
 
 CGSIParams::CGSIParams()
 {
@@ -54,6 +55,11 @@ CDeadFuelMoistureParams::CDeadFuelMoistureParams()
 	m_desorptionRate = 0.06;
 	m_moistureSteps = 15;
 	m_stickNodes = 11;
+	m_tabulatedDiffusivity = false;
+	m_simdDiffusivity = false;
+	m_equilibriumSkip = false;
+	m_implicitSolver = false;
+	m_updateInterval = 1;
 }
 
 CDeadFuelMoistureParams::CDeadFuelMoistureParams(const CDeadFuelMoistureParams& rhs)
@@ -65,6 +71,11 @@ CDeadFuelMoistureParams::CDeadFuelMoistureParams(const CDeadFuelMoistureParams&
 	m_desorptionRate = rhs.m_desorptionRate;
 	m_moistureSteps = rhs.m_moistureSteps;
 	m_stickNodes = rhs.m_stickNodes;
+	m_tabulatedDiffusivity = rhs.m_tabulatedDiffusivity;
+	m_simdDiffusivity = rhs.m_simdDiffusivity;
+	m_equilibriumSkip = rhs.m_equilibriumSkip;
+	m_implicitSolver = rhs.m_implicitSolver;
+	m_updateInterval = rhs.m_updateInterval;
 }
 
 CDeadFuelMoistureParams::~CDeadFuelMoistureParams()
@@ -89,6 +100,9 @@ CNFDRSParams::CNFDRSParams()
 	m_MXD = 25;
 	m_obsHour = 13;
 	m_timeZoneOffsetHours = 0;
+	m_sharedForcing = false;
+	m_parallelSticks = false;
+	m_simdIndexes = false;
 	m_herbParams.setLiveFuelMoistureMin(30);
 	m_herbParams.setLiveFuelMoistureMax(250);
 	m_woodyParams.setLiveFuelMoistureMin(60);
@@ -99,6 +113,7 @@ CNFDRSParams::CNFDRSParams(const CNFDRSParams& rhs)
 {
 //	m_stationID = rhs.m_stationID;
 	m_fuelModel = rhs.m_fuelModel;
+	m_fuelModels = rhs.m_fuelModels;
 	m_maxSC = rhs.m_maxSC;
 	m_latitude = rhs.m_latitude;
 //	m_longitude = rhs.m_longitude;
@@ -112,6 +127,9 @@ CNFDRSParams::CNFDRSParams(const CNFDRSParams& rhs)
 	m_MXD = rhs.m_MXD;
 	m_obsHour = rhs.m_obsHour;
 	m_timeZoneOffsetHours = rhs.m_timeZoneOffsetHours;
+	m_sharedForcing = rhs.m_sharedForcing;
+	m_parallelSticks = rhs.m_parallelSticks;
+	m_simdIndexes = rhs.m_simdIndexes;
 	m_gsiParams = rhs.m_gsiParams;
 	m_herbParams = rhs.m_herbParams;
 	m_woodyParams = rhs.m_woodyParams;
@@ -144,6 +162,24 @@ void CNFDRSParams::InitNFDRS(NFDRS4* pNFDRS)
 	pNFDRS->SetTenHourParams(m_10HourParams.getRadius(), m_10HourParams.getAdsorptionRate(), m_10HourParams.getMaxLocalMoisture(), m_10HourParams.getStickDensity(), m_10HourParams.getDesorptionRate());
 	pNFDRS->SetHundredHourParams(m_100HourParams.getRadius(), m_100HourParams.getAdsorptionRate(), m_100HourParams.getMaxLocalMoisture(), m_100HourParams.getStickDensity(), m_100HourParams.getDesorptionRate());
 	pNFDRS->SetThousandHourParams(m_1000HourParams.getRadius(), m_1000HourParams.getAdsorptionRate(), m_1000HourParams.getMaxLocalMoisture(), m_1000HourParams.getStickDensity(), m_1000HourParams.getDesorptionRate());
+	pNFDRS->Set1HourTabulatedDiffusivity(m_1HourParams.getTabulatedDiffusivity());
+	pNFDRS->Set10HourTabulatedDiffusivity(m_10HourParams.getTabulatedDiffusivity());
+	pNFDRS->Set100HourTabulatedDiffusivity(m_100HourParams.getTabulatedDiffusivity());
+	pNFDRS->Set1000HourTabulatedDiffusivity(m_1000HourParams.getTabulatedDiffusivity());
+	pNFDRS->Set1HourSimdDiffusivity(m_1HourParams.getSimdDiffusivity());
+	pNFDRS->Set10HourSimdDiffusivity(m_10HourParams.getSimdDiffusivity());
+	pNFDRS->Set100HourSimdDiffusivity(m_100HourParams.getSimdDiffusivity());
+	pNFDRS->Set1000HourSimdDiffusivity(m_1000HourParams.getSimdDiffusivity());
+	pNFDRS->Set1HourEquilibriumSkip(m_1HourParams.getEquilibriumSkip());
+	pNFDRS->Set1HourImplicitSolver(m_1HourParams.getImplicitSolver(), m_1HourParams.getMoistureSteps());
+	pNFDRS->Set10HourEquilibriumSkip(m_10HourParams.getEquilibriumSkip());
+	pNFDRS->Set10HourImplicitSolver(m_10HourParams.getImplicitSolver(), m_10HourParams.getMoistureSteps());
+	pNFDRS->Set100HourEquilibriumSkip(m_100HourParams.getEquilibriumSkip());
+	pNFDRS->Set100HourImplicitSolver(m_100HourParams.getImplicitSolver(), m_100HourParams.getMoistureSteps());
+	pNFDRS->Set1000HourEquilibriumSkip(m_1000HourParams.getEquilibriumSkip());
+	pNFDRS->Set1000HourImplicitSolver(m_1000HourParams.getImplicitSolver(), m_1000HourParams.getMoistureSteps());
+	pNFDRS->Set100HourUpdateInterval(m_100HourParams.getUpdateInterval());
+	pNFDRS->Set1000HourUpdateInterval(m_1000HourParams.getUpdateInterval());
 	CGSIParams gsi = getGsiParams();
 	pNFDRS->SetGSIParams(gsi.getGsiMax(), gsi.getGsiHerbGreenup(), gsi.getGsiTminMin(), gsi.getGsiTminMax(), gsi.getGsiVpdMin(),
 		gsi.getGsiVpdMax(), gsi.getGsiDaylenMin(), gsi.getGsiDaylenMax(), gsi.getGsiAveragingPeriod(),
@@ -163,4 +199,8 @@ void CNFDRSParams::InitNFDRS(NFDRS4* pNFDRS)
 		pNFDRS->SetSCMax(getMaxSC());
 	if(getMXD() > 0)
 		pNFDRS->SetMXD(getMXD());
+	pNFDRS->SetSharedForcing(getSharedForcing());
+	pNFDRS->SetParallelSticks(getParallelSticks());
+	if (!pNFDRS->SetFuelModels(getFuelModels(), getMXD(), getMaxSC()))
+		printf("Unknown fuel model in fuelModels \"%s\", only %c is computed\n", getFuelModels().c_str(), fm);
 }
@@ -73,6 +73,11 @@ public:
 	double getDesorptionRate() { return m_desorptionRate; }
 	int getMoistureSteps() { return m_moistureSteps; }
 	int getStickNodes() { return m_stickNodes; }
+	bool getTabulatedDiffusivity() { return m_tabulatedDiffusivity; }
+	bool getSimdDiffusivity() { return m_simdDiffusivity; }
+	bool getEquilibriumSkip() { return m_equilibriumSkip; }
+	bool getImplicitSolver() { return m_implicitSolver; }
+	int getUpdateInterval() { return m_updateInterval; }
 	void setRadius(double radius) { m_radius = radius; }
 	void setAdsorptionRate(double adsortionRate) { m_adsorptionRate = adsortionRate; }
 	void setStickDensity(double stickDensity) { m_stickDensity = stickDensity; }
@@ -80,6 +85,11 @@ public:
 	void setDesortionRate(double desorptionRate) { m_desorptionRate = desorptionRate; }
 	void setMoistureSteps(int moistureSteps) { m_moistureSteps = moistureSteps; }
 	void setStickNodes(int stickNodes) { m_stickNodes = stickNodes; }
+	void setTabulatedDiffusivity(bool tabulated) { m_tabulatedDiffusivity = tabulated; }
+	void setSimdDiffusivity(bool simd) { m_simdDiffusivity = simd; }
+	void setEquilibriumSkip(bool skip) { m_equilibriumSkip = skip; }
+	void setImplicitSolver(bool implicit) { m_implicitSolver = implicit; }
+	void setUpdateInterval(int hours) { m_updateInterval = hours; }
 private:
 	double m_radius;
 	double m_adsorptionRate;
@@ -88,6 +98,11 @@ private:
 	double m_desorptionRate;
 	int m_moistureSteps;
 	int m_stickNodes;
+	bool m_tabulatedDiffusivity;
+	bool m_simdDiffusivity;
+	bool m_equilibriumSkip;
+	bool m_implicitSolver;
+	int m_updateInterval;
 };
 
 class NFDRS4;
@@ -105,6 +120,7 @@ public:
 	//getters
 	//const char* getStationID() { return m_stationID; }
 	char getFuelModel() { return m_fuelModel; }
+	std::string getFuelModels() { return m_fuelModels; }
 	int getMaxSC() { return m_maxSC; }
 	double getLatitude() { return m_latitude; }
 	//double getLongitude() { return m_longitude; }
@@ -118,6 +134,9 @@ public:
 	int getMXD() { return m_MXD; }
 	int getObsHour() { return m_obsHour; }
 	int getTimeZoneOffsetHours() { return m_timeZoneOffsetHours; }
+	bool getSharedForcing() { return m_sharedForcing; }
+	bool getParallelSticks() { return m_parallelSticks; }
+	bool getSimdIndexes() { return m_simdIndexes; }
 	CGSIParams getGsiParams() { return m_gsiParams; }
 	CGSIParams getHerbParams() { return m_herbParams; }
 	CGSIParams getWoodyParams() { return m_woodyParams; }
@@ -129,6 +148,7 @@ public:
 	//setters
 	//void setStationID(const char* stationID) { m_stationID = stationID; }
 	void setFuelModel(char fuelModel) { m_fuelModel = fuelModel; }
+	void setFuelModels(std::string fuelModels) { m_fuelModels = fuelModels; }
 	void setMaxSC(int maxSC) { m_maxSC = maxSC; }
 	void setLatitude(double latitude) { m_latitude = latitude; }
 	//void setLongitude(double longitude) { m_longitude = longitude; }
@@ -143,6 +163,9 @@ public:
 	void setMXD(int mxd) { m_MXD = mxd; }
 	void setObsHour(int obsHour) { m_obsHour = obsHour; }
 	void setTimeZoneOffsetHours(int offset){m_timeZoneOffsetHours = offset;}
+	void setSharedForcing(bool shared) { m_sharedForcing = shared; }
+	void setParallelSticks(bool parallel) { m_parallelSticks = parallel; }
+	void setSimdIndexes(bool simd) { m_simdIndexes = simd; }
 		void setGsiParams(CGSIParams gsiParams) { m_gsiParams = gsiParams; }
 	void setHerbParams(CGSIParams herbParams) { m_herbParams = herbParams; }
 	void setWoodyParams(CGSIParams woodyParams) { m_woodyParams = woodyParams; }
@@ -155,6 +178,7 @@ private:
 	//init params
 	//const char* m_stationID;
 	char m_fuelModel;
+	std::string m_fuelModels;
 	int m_maxSC;
 	double m_latitude;
 	//double m_longitude;
@@ -170,6 +194,9 @@ private:
 	//necessary for Update()
 	int m_obsHour;
 	int m_timeZoneOffsetHours;
+	bool m_sharedForcing;
+	bool m_parallelSticks;
+	bool m_simdIndexes;
 	//gsi params
 	CGSIParams m_gsiParams;
 	CGSIParams m_herbParams;
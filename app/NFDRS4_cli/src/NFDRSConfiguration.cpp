@@ -72,6 +72,7 @@ void NFDRSConfiguration::parse(
 		const char *fm = cfg->lookupString(cfgScope, "fuelModel");
 		if(strlen(fm) > 0)
 			m_nfdrsParams.setFuelModel(fm[0]);
+		m_nfdrsParams.setFuelModels(cfg->lookupString(cfgScope, "fuelModels"));
 		m_nfdrsParams.setIsAnnual(cfg->lookupInt(cfgScope, "isAnnuals"));
 		m_nfdrsParams.setMXD(cfg->lookupInt(cfgScope, "MXD"));
 		m_nfdrsParams.setKbdiThreshold(cfg->lookupInt(cfgScope, "kbdiThreshold"));
@@ -84,6 +85,9 @@ void NFDRSConfiguration::parse(
 		m_nfdrsParams.setUseCure(cfg->lookupInt(cfgScope, "useCure"));
 		m_nfdrsParams.setUseLoadTransfer(cfg->lookupInt(cfgScope, "useLoadTransfer"));
 		m_nfdrsParams.setTimeZoneOffsetHours(cfg->lookupInt(cfgScope, "timeZoneOffset"));
+		m_nfdrsParams.setSharedForcing(cfg->lookupInt(cfgScope, "sharedForcing"));
+		m_nfdrsParams.setParallelSticks(cfg->lookupInt(cfgScope, "parallelSticks"));
+		m_nfdrsParams.setSimdIndexes(cfg->lookupInt(cfgScope, "simdIndexes"));
 
 		CGSIParams gsiParams;
 		gsiParams.setGsiAveragingPeriod(cfg->lookupInt(cfgScope, "gsi_opts.gsiAveragingDays"));
@@ -148,6 +152,10 @@ void NFDRSConfiguration::parse(
 		oneHourParams.setDesortionRate(cfg->lookupFloat(cfgScope, "1hr_opts.desorptionRate"));
 		oneHourParams.setMoistureSteps(cfg->lookupInt(cfgScope, "1hr_opts.moistureSteps"));
 		oneHourParams.setStickNodes(cfg->lookupInt(cfgScope, "1hr_opts.stickNodes"));
+		oneHourParams.setTabulatedDiffusivity(cfg->lookupInt(cfgScope, "1hr_opts.tabulatedDiffusivity"));
+		oneHourParams.setSimdDiffusivity(cfg->lookupInt(cfgScope, "1hr_opts.simdDiffusivity"));
+		oneHourParams.setEquilibriumSkip(cfg->lookupInt(cfgScope, "1hr_opts.equilibriumSkip"));
+		oneHourParams.setImplicitSolver(cfg->lookupInt(cfgScope, "1hr_opts.implicitSolver"));
 		m_nfdrsParams.set1HourParams(oneHourParams);
 		CDeadFuelMoistureParams tenHourParams;
 		tenHourParams.setRadius(cfg->lookupFloat(cfgScope, "10hr_opts.radius"));
@@ -157,6 +165,10 @@ void NFDRSConfiguration::parse(
 		tenHourParams.setDesortionRate(cfg->lookupFloat(cfgScope, "10hr_opts.desorptionRate"));
 		tenHourParams.setMoistureSteps(cfg->lookupInt(cfgScope, "10hr_opts.moistureSteps"));
 		tenHourParams.setStickNodes(cfg->lookupInt(cfgScope, "10hr_opts.stickNodes"));
+		tenHourParams.setTabulatedDiffusivity(cfg->lookupInt(cfgScope, "10hr_opts.tabulatedDiffusivity"));
+		tenHourParams.setSimdDiffusivity(cfg->lookupInt(cfgScope, "10hr_opts.simdDiffusivity"));
+		tenHourParams.setEquilibriumSkip(cfg->lookupInt(cfgScope, "10hr_opts.equilibriumSkip"));
+		tenHourParams.setImplicitSolver(cfg->lookupInt(cfgScope, "10hr_opts.implicitSolver"));
 		m_nfdrsParams.set10HourParams(tenHourParams);
 		CDeadFuelMoistureParams hundredHourParams;
 		hundredHourParams.setRadius(cfg->lookupFloat(cfgScope, "100hr_opts.radius"));
@@ -166,6 +178,11 @@ void NFDRSConfiguration::parse(
 		hundredHourParams.setDesortionRate(cfg->lookupFloat(cfgScope, "100hr_opts.desorptionRate"));
 		hundredHourParams.setMoistureSteps(cfg->lookupInt(cfgScope, "100hr_opts.moistureSteps"));
 		hundredHourParams.setStickNodes(cfg->lookupInt(cfgScope, "100hr_opts.stickNodes"));
+		hundredHourParams.setTabulatedDiffusivity(cfg->lookupInt(cfgScope, "100hr_opts.tabulatedDiffusivity"));
+		hundredHourParams.setSimdDiffusivity(cfg->lookupInt(cfgScope, "100hr_opts.simdDiffusivity"));
+		hundredHourParams.setEquilibriumSkip(cfg->lookupInt(cfgScope, "100hr_opts.equilibriumSkip"));
+		hundredHourParams.setImplicitSolver(cfg->lookupInt(cfgScope, "100hr_opts.implicitSolver"));
+		hundredHourParams.setUpdateInterval(cfg->lookupInt(cfgScope, "100hr_opts.updateInterval"));
 		m_nfdrsParams.set100HourParams(hundredHourParams);
 		CDeadFuelMoistureParams thousandHourParams;
 		thousandHourParams.setRadius(cfg->lookupFloat(cfgScope, "1000hr_opts.radius"));
@@ -175,6 +192,11 @@ void NFDRSConfiguration::parse(
 		thousandHourParams.setDesortionRate(cfg->lookupFloat(cfgScope, "1000hr_opts.desorptionRate"));
 		thousandHourParams.setMoistureSteps(cfg->lookupInt(cfgScope, "1000hr_opts.moistureSteps"));
 		thousandHourParams.setStickNodes(cfg->lookupInt(cfgScope, "1000hr_opts.stickNodes"));
+		thousandHourParams.setTabulatedDiffusivity(cfg->lookupInt(cfgScope, "1000hr_opts.tabulatedDiffusivity"));
+		thousandHourParams.setSimdDiffusivity(cfg->lookupInt(cfgScope, "1000hr_opts.simdDiffusivity"));
+		thousandHourParams.setEquilibriumSkip(cfg->lookupInt(cfgScope, "1000hr_opts.equilibriumSkip"));
+		thousandHourParams.setImplicitSolver(cfg->lookupInt(cfgScope, "1000hr_opts.implicitSolver"));
+		thousandHourParams.setUpdateInterval(cfg->lookupInt(cfgScope, "1000hr_opts.updateInterval"));
 		m_nfdrsParams.set1000HourParams(thousandHourParams);
 		if (m_nfdrsParams.getFuelModel() == 'C' || m_nfdrsParams.getFuelModel() == 'c')//custom fuel model expected
 		{
@@ -160,7 +160,36 @@ NFDRSInitConfig::NFDRSInitConfig()
 	m_schema[141] = "woody_opts.gsiUseVpdAvg = int";
 	m_schema[142] = "woody_opts.gsiVpdMax = int";
 	m_schema[143] = "woody_opts.gsiVpdMin = int";
-	m_schema[144] = 0;
+	m_schema[144] = "1000hr_opts.tabulatedDiffusivity = int";
+	m_schema[145] = "100hr_opts.tabulatedDiffusivity = int";
+	m_schema[146] = "10hr_opts.tabulatedDiffusivity = int";
+	m_schema[147] = "1hr_opts.tabulatedDiffusivity = int";
+	m_schema[148] = "deadFuelMoisture.defaults.tabulatedDiffusivity = int";
+	m_schema[149] = "1000hr_opts.equilibriumSkip = int";
+	m_schema[150] = "100hr_opts.equilibriumSkip = int";
+	m_schema[151] = "10hr_opts.equilibriumSkip = int";
+	m_schema[152] = "1hr_opts.equilibriumSkip = int";
+	m_schema[153] = "deadFuelMoisture.defaults.equilibriumSkip = int";
+	m_schema[154] = "sharedForcing = int";
+	m_schema[155] = "1000hr_opts.implicitSolver = int";
+	m_schema[156] = "100hr_opts.implicitSolver = int";
+	m_schema[157] = "10hr_opts.implicitSolver = int";
+	m_schema[158] = "1hr_opts.implicitSolver = int";
+	m_schema[159] = "deadFuelMoisture.defaults.implicitSolver = int";
+	m_schema[160] = "1000hr_opts.simdDiffusivity = int";
+	m_schema[161] = "100hr_opts.simdDiffusivity = int";
+	m_schema[162] = "10hr_opts.simdDiffusivity = int";
+	m_schema[163] = "1hr_opts.simdDiffusivity = int";
+	m_schema[164] = "deadFuelMoisture.defaults.simdDiffusivity = int";
+	m_schema[165] = "1000hr_opts.updateInterval = int[1, 24]";
+	m_schema[166] = "100hr_opts.updateInterval = int[1, 24]";
+	m_schema[167] = "10hr_opts.updateInterval = int";
+	m_schema[168] = "1hr_opts.updateInterval = int";
+	m_schema[169] = "deadFuelMoisture.defaults.updateInterval = int";
+	m_schema[170] = "parallelSticks = int";
+	m_schema[171] = "simdIndexes = int";
+	m_schema[172] = "fuelModels = string";
+	m_schema[173] = 0;
 
 	m_str << "#Sample NFDRS2016 initialization file\n";
 	m_str << "#contains all parameters to initialize an NFSDRS20";
@@ -183,6 +212,13 @@ NFDRSInitConfig::NFDRSInitConfig()
 	m_str << "#NFDRS2016 fuel model (one of V, W, X, Y, Z, or C ";
 	m_str << "for a custom defined model)\n";
 	m_str << "fuelModel = \"Y\";\n";
+	m_str << "#fuelModels lists fuel models whose indexes are al";
+	m_str << "l computed from the one moisture simulation (eg. \"";
+	m_str << "VWXYZ\", with the code of\n";
+	m_str << "#the custom model for C); when set, index and all ";
+	m_str << "outputs have a FuelModel column and one row per li";
+	m_str << "sted model\n";
+	m_str << "fuelModels = \"\";\n";
 	m_str << "#standard NFDRS Slope Class (1 = 0.25%, 2 = 26-40%";
 	m_str << ", 3 = 41 - 55%, 4 = 56 - 75%, 5 = 76%+)\n";
 	m_str << "slopeClass = \"1\";\n";
@@ -214,6 +250,25 @@ NFDRSInitConfig::NFDRSInitConfig()
 	m_str << "#for maxSC, any positive value other than zero (0)";
 	m_str << " will override fuel model default maxSC\n";
 	m_str << "maxSC = \"0\";\n";
+	m_str << "#for sharedForcing, 1 derives the dew point and sa";
+	m_str << "turation vapor pressures once per hour for all fou";
+	m_str << "r dead fuel sticks\n";
+	m_str << "#(faster, moisture contents within 0.0001% of the ";
+	m_str << "default), 0 has each stick derive them at every ti";
+	m_str << "me step\n";
+	m_str << "sharedForcing = \"0\";\n";
+	m_str << "#for parallelSticks, 1 runs each of the four dead ";
+	m_str << "fuel sticks on its own thread, ahead of the index ";
+	m_str << "calculations\n";
+	m_str << "#(same results, faster on multi-core hosts), 0 upd";
+	m_str << "ates the sticks one after the other\n";
+	m_str << "parallelSticks = \"0\";\n";
+	m_str << "#for simdIndexes, 1 recomputes the indexes of a us";
+	m_str << "eStoredOutputs run several records at a time with ";
+	m_str << "SIMD instructions\n";
+	m_str << "#(indexes within 1.0e-11 of the default), 0 comput";
+	m_str << "es them one record at a time\n";
+	m_str << "simdIndexes = \"0\";\n";
 	m_str << "#\n";
 	m_str << "#GSI and Live Fuel Moistures\n";
 	m_str << "#\n";
@@ -269,6 +324,27 @@ NFDRSInitConfig::NFDRSInitConfig()
 	m_str << "#added 1/9/2026 for performance optimization\n";
 	m_str << "\tmoistureSteps = \"-999\";\n";
 	m_str << "\tstickNodes = \"-999\";\n";
+	m_str << "#1 interpolates bound water diffusivity from a pre";
+	m_str << "computed table, 0 uses the exact formula\n";
+	m_str << "\ttabulatedDiffusivity = \"0\";\n";
+	m_str << "#1 evaluates the exact diffusivity formula on seve";
+	m_str << "ral nodes at once with the widest SIMD instruction";
+	m_str << "s of the host, 0 one node at a time\n";
+	m_str << "\tsimdDiffusivity = \"0\";\n";
+	m_str << "#1 skips updates once a stick has converged under ";
+	m_str << "unchanging weather (e.g. snow cover), 0 always upd";
+	m_str << "ates\n";
+	m_str << "\tequilibriumSkip = \"0\";\n";
+	m_str << "#1 propagates nodal changes with an implicit tridi";
+	m_str << "agonal solve taking moistureSteps steps per hour (";
+	m_str << "-999 keeps the derived steps), 0 uses Nelson's pro";
+	m_str << "pagation\n";
+	m_str << "\timplicitSolver = \"0\";\n";
+	m_str << "#hourly observations per update of the 100-hr and ";
+	m_str << "1000-hr sticks (e.g. 6), whose moisture is project";
+	m_str << "ed in between; 1 updates hourly. Ignored for 1-hr ";
+	m_str << "and 10-hr sticks\n";
+	m_str << "\tupdateInterval = \"1\";\n";
 	m_str << "}\n";
 	m_str << "# 1hr options\n";
 	m_str << "1hr_opts {\n";
@@ -34,7 +34,7 @@ public:
 	static void getSchema(const char **& schema, int & schemaSize)
 	{
 		schema = s_singleton.m_schema;
-		schemaSize = 144;
+		schemaSize = 173;
 	}
 	static const char ** getSchema() // null terminated array
 	{
@@ -46,7 +46,7 @@ private:
 	// Variables
 	//--------
 	CONFIG4CPP_NAMESPACE::StringBuffer m_str;
-	const char *                       m_schema[145];
+	const char *                       m_schema[174];
 	static NFDRSInitConfig s_singleton;
 
 	//--------
@@ -2,6 +2,7 @@
 //
 
 #include "nfdrs4.h"
+#include "nfdrs4ensemble.h"
 #include "RunNFDRSConfiguration.h"
 #include "NFDRSConfiguration.h"
 #include "CNFDRSParams.h"
@@ -12,6 +13,7 @@
 #include <unistd.h>
 #endif
 #include <stdlib.h>
+#include <map>
 using namespace std;
 
 string FormatToISO8061Offset(TM inTm, int offset)
@@ -32,6 +34,140 @@ bool fileExists(const char *fileName)
 }
 
  
+//runs the members of a wxFile with a Member column from the one station state
+//and writes the statistics across them for each hour to ensembleOutputFile
+int RunEnsemble(NFDRS4& fw21Calc, CNFDRSParams& params, CFW21Data& FW21data, RunNFDRSConfiguration* cfg)
+{
+	const char* ensembleOutputFileName = cfg->getEnsembleOutputFile();
+	if (strlen(ensembleOutputFileName) == 0)
+	{
+		printf("wxFile has a %s column, an ensembleOutputFile must be specified\n", CFW21Data::GetFieldName(CFW21Data::FW21_MEMBER).c_str());
+		return -6;
+	}
+	if (cfg->getUseStoredOutputs() != 0)
+	{
+		printf("useStoredOutputs is not available for an ensemble wxFile\n");
+		return -6;
+	}
+	NFDRS4Ensemble ensemble;
+	std::vector<double> percentiles;
+	for (const char* p = cfg->getEnsemblePercentiles(); *p; )
+	{
+		char* end;
+		double pct = strtod(p, &end);
+		if (end == p)
+		{
+			p++;	//separator
+			continue;
+		}
+		percentiles.push_back(pct);
+		p = end;
+	}
+	if (!ensemble.SetPercentiles(percentiles))
+	{
+		printf("ensemblePercentiles \"%s\" must be between 0 and 100\n", cfg->getEnsemblePercentiles());
+		return -6;
+	}
+	ensemble.SetSimdIndexes(params.getSimdIndexes());
+
+	//records of each member, members in order of first appearance
+	std::map<std::string, int> memberIndex;
+	std::vector<std::string> members;
+	std::vector<std::vector<int> > memberRecs;
+	int nRecs = (int)FW21data.GetNumRecs();
+	for (int r = 0; r < nRecs; r++)
+	{
+		std::string member = FW21data.GetRec(r).GetMember();
+		std::map<std::string, int>::iterator it = memberIndex.find(member);
+		if (it == memberIndex.end())
+		{
+			it = memberIndex.insert(std::make_pair(member, (int)members.size())).first;
+			members.push_back(member);
+			memberRecs.push_back(std::vector<int>());
+		}
+		memberRecs[it->second].push_back(r);
+	}
+	int nMembers = (int)members.size(), nHours = nMembers > 0 ? (int)memberRecs[0].size() : 0;
+	std::vector<NFDRS4Observation> obs((size_t)nMembers * nHours);
+	for (int m = 0; m < nMembers; m++)
+	{
+		if ((int)memberRecs[m].size() != nHours)
+		{
+			printf("Error, member %s has %d records, member %s has %d\n", members[m].c_str(), (int)memberRecs[m].size(), members[0].c_str(), nHours);
+			return -6;
+		}
+		for (int i = 0; i < nHours; i++)
+		{
+			FW21Record fw21Rec = FW21data.GetRec(memberRecs[m][i]);
+			NFDRS4Observation& o = obs[(size_t)m * nHours + i];
+			o.Year = fw21Rec.GetYear();
+			o.Month = fw21Rec.GetMonth();
+			o.Day = fw21Rec.GetDay();
+			o.Hour = fw21Rec.GetHour();
+			o.Temp = fw21Rec.GetTemp();
+			o.RH = fw21Rec.GetRH();
+			o.PPTAmt = fw21Rec.GetPrecip();
+			o.SolarRad = fw21Rec.GetSolarRadiation();
+			o.WS = fw21Rec.GetWindSpeed();
+			o.SnowDay = fw21Rec.GetSnowFlag();
+			const NFDRS4Observation& first = obs[i];
+			if (o.Year != first.Year || o.Month != first.Month || o.Day != first.Day || o.Hour != first.Hour)
+			{
+				printf("Error, record %d of member %s is not at the date and hour of member %s\n", i + 1, members[m].c_str(), members[0].c_str());
+				return -6;
+			}
+		}
+	}
+
+	FILE* ensOut = fopen(ensembleOutputFileName, "wt");
+	if (!ensOut)
+	{
+		printf("Error opening %s as output.\n", ensembleOutputFileName);
+		return -3;
+	}
+	const char* varNames[EnsembleVariables] = { "MC1", "ERC", "BI", "SC", "IC" };
+	fprintf(ensOut, "%s,%s,Members", CFW21Data::GetFieldName(CFW21Data::FW21_STATION).c_str(), CFW21Data::GetFieldName(CFW21Data::FW21_DATE).c_str());
+	for (int v = 0; v < EnsembleVariables; v++)
+	{
+		fprintf(ensOut, ",%sMean,%sMin,%sMax", varNames[v], varNames[v], varNames[v]);
+		for (size_t p = 0; p < percentiles.size(); p++)
+			fprintf(ensOut, ",%sP%g", varNames[v], percentiles[p]);
+	}
+	fprintf(ensOut, "\n");
+
+	//each hour is reduced and written as soon as all members are past it
+	time_t startTime = clock();
+	int nStats = ensemble.GetNumStats();
+	std::vector<double> stats(EnsembleVariables * nStats);
+	std::vector<NFDRS4Observation> hour(nMembers);
+	ensemble.Start(fw21Calc, nMembers);
+	for (int i = 0; i < nHours; i++)
+	{
+		for (int m = 0; m < nMembers; m++)
+			hour[m] = obs[(size_t)m * nHours + i];
+		ensemble.Step(hour.data(), stats.data());
+		if (cfg->getOutputInterval() == 1 && hour[0].Hour != params.getObsHour())
+			continue;
+		FW21Record fw21Rec = FW21data.GetRec(memberRecs[0][i]);
+		fprintf(ensOut, "%s,%s,%d", fw21Rec.GetStation().c_str(),
+			FW21data.DateToOriginal(fw21Rec.GetDateTime(), fw21Rec.GetTimeZoneOffset()).c_str(), nMembers);
+		for (int v = 0; v < EnsembleVariables; v++)
+		{
+			for (int s = 0; s < nStats; s++)
+				fprintf(ensOut, v == EnsembleMC1 ? ",%.10f" : ",%.2f", stats[v * nStats + s]);
+		}
+		fprintf(ensOut, "\n");
+	}
+	fclose(ensOut);
+	time_t endTime = clock();
+	double total = endTime - startTime;
+	printf("Total seconds time for NFDRS: %.2f\n", total / (double)CLOCKS_PER_SEC);
+	printf("Ran %d members of %d hours\n", nMembers, nHours);
+	if (strlen(cfg->getSaveStateFile()) > 0)
+		printf("saveToStateFile is not written for an ensemble wxFile\n");
+	return 0;
+}
+
 int main(int argc, char* argv[])
 {
 	//routine for testing NFDRS
@@ -124,8 +260,13 @@ int main(int argc, char* argv[])
 	if (strlen(loadStateFileName) > 0)
 	{
 		NFDRS4State state;
-		state.LoadState(loadStateFileName);
-		fw21Calc.LoadState(state);
+		if (!state.LoadState(loadStateFileName) || !fw21Calc.LoadState(state))
+		{
+			printf("Error reading NFDRS State file %s\n", loadStateFileName);
+			delete nfdrsCfg;
+			delete cfg;
+			return -1;
+		}
 	}
 	CFW21Data FW21data;
 	int status = FW21data.LoadFile(wxFileName, cfg->getStationID(), params.getTimeZoneOffsetHours(), cfg->getUseStoredOutputs() != 0 ? true : false);
@@ -138,6 +279,15 @@ int main(int argc, char* argv[])
 		delete cfg;
 		return -5;
 	}
+	if (FW21data.HasMembers())
+	{
+		exitStatus = RunEnsemble(fw21Calc, params, FW21data, cfg);
+		delete nfdrsCfg;
+		delete cfg;
+		return exitStatus;
+	}
+	if (strlen(cfg->getEnsembleOutputFile()) > 0)
+		printf("Warning: wxFile has no %s column, ensembleOutputFile %s is ignored\n", CFW21Data::GetFieldName(CFW21Data::FW21_MEMBER).c_str(), cfg->getEnsembleOutputFile());
 	//also need any output files for dumping data
 	FILE* allOut = NULL, * indexOut = NULL, * moistOut = NULL, * wxAllOut = NULL;// , * fw21Out = NULL;
 
@@ -158,6 +308,8 @@ int main(int argc, char* argv[])
 			else
 				fprintf(allOut, ",%s", CFW21Data::GetFieldName((CFW21Data::FW21FIELDS)fieldNum).c_str());
 		}
+		if (fw21Calc.GetNumFuelModels() > 0)
+			fprintf(allOut, ",FuelModel");
 		fprintf(allOut, "\n");
 	}
 	if (indexOutputsFileName && strlen(indexOutputsFileName) > 0)
@@ -176,6 +328,8 @@ int main(int argc, char* argv[])
 		fprintf(indexOut, "%s,%s", CFW21Data::GetFieldName(CFW21Data::FW21_STATION).c_str(),CFW21Data::GetFieldName(CFW21Data::FW21_DATE).c_str());
 		for (int f = CFW21Data::FW21_BI; f < CFW21Data::FW21_TEMPC; f++)
 			fprintf(indexOut, ",%s", CFW21Data::GetFieldName((CFW21Data::FW21FIELDS)f).c_str());
+		if (fw21Calc.GetNumFuelModels() > 0)
+			fprintf(indexOut, ",FuelModel");
 		fprintf(indexOut, "\n");
 	}
 	if (fuelMoistureOutputsFileName && strlen(fuelMoistureOutputsFileName) > 0)
@@ -201,54 +355,180 @@ int main(int argc, char* argv[])
 
 	//now need to read the wxFile and process the records
 	time_t startTime = clock();
-	for (size_t r = 0; r < FW21data.GetNumRecs(); r++)
+	int nRecs = (int)FW21data.GetNumRecs();
+	std::vector<double> vMC1(nRecs), vMC10(nRecs), vMC100(nRecs), vMC1000(nRecs), vMCHerb(nRecs), vMCWood(nRecs), vFuelTemp(nRecs);
+	std::vector<double> vBI(nRecs), vERC(nRecs), vSC(nRecs), vIC(nRecs), vGSI(nRecs);
+	std::vector<int> vKBDI(nRecs);
+	NFDRS4Outputs outs;
+	outs.MC1 = vMC1.data();
+	outs.MC10 = vMC10.data();
+	outs.MC100 = vMC100.data();
+	outs.MC1000 = vMC1000.data();
+	outs.MCHERB = vMCHerb.data();
+	outs.MCWOOD = vMCWood.data();
+	outs.FuelTemperature = vFuelTemp.data();
+	outs.BI = vBI.data();
+	outs.ERC = vERC.data();
+	outs.SC = vSC.data();
+	outs.IC = vIC.data();
+	outs.GSI = vGSI.data();
+	outs.KBDI = vKBDI.data();
+	//indexes of the fuelModels models, nModels per record
+	int nModels = fw21Calc.GetNumFuelModels();
+	std::vector<double> vModelBI(nRecs * nModels), vModelERC(nRecs * nModels), vModelSC(nRecs * nModels), vModelIC(nRecs * nModels);
+	if (nModels > 0)
 	{
-		FW21Record fw21Rec = FW21data.GetRec(r);
-		if (cfg->getUseStoredOutputs() != 0)
+		outs.ModelBI = vModelBI.data();
+		outs.ModelERC = vModelERC.data();
+		outs.ModelSC = vModelSC.data();
+		outs.ModelIC = vModelIC.data();
+	}
+	//only the indexes of the records written out are calculated
+	if (cfg->getOutputInterval() == 1)
+		outs.IndexHour = params.getObsHour();
+	fw21Calc.SetLazyIndexes(true);
+	if (cfg->getUseStoredOutputs() != 0)
+	{
+		//indexes only, from the stored fuel moistures, GSI and KBDI, in one batch
+		//a record without a valid KBDI or GSI uses the previous record's, as iCalcIndexes() does
+		std::vector<double> vWS(nRecs), vCalcKBDI(nRecs), vCalcGSI(nRecs);
+		double prevKBDI = fw21Calc.KBDI, prevGSI = fw21Calc.m_GSI;
+		for (int r = 0; r < nRecs; r++)
 		{
-			fw21Calc.iSetFuelMoistures(fw21Rec.GetMx1(), fw21Rec.GetMx10(),
-				fw21Rec.GetMx100(), fw21Rec.GetMx1000(), fw21Rec.GetMxWood(), fw21Rec.GetMxHerb(),
-				fw21Rec.GetFuelTTempC());
-			double tSC, tERC, tBI, tIC;
-			fw21Calc.iCalcIndexes(fw21Rec.GetWindSpeed(), params.getSlopeClass(), &tSC, &tERC, &tBI, &tIC, fw21Rec.GetGSI(), fw21Rec.GetKBDI());
-			//are these even necessary????????? Yes - Stu 10/24/2024
-			fw21Calc.SC = tSC;
-			fw21Calc.ERC = tERC;
-			fw21Calc.BI = tBI;
-			fw21Calc.IC = tIC;
-			fw21Calc.KBDI = fw21Rec.GetKBDI();
-			fw21Calc.m_GSI = fw21Rec.GetGSI();
+			FW21Record fw21Rec = FW21data.GetRec(r);
+			vMC1[r] = fw21Rec.GetMx1();
+			vMC10[r] = fw21Rec.GetMx10();
+			vMC100[r] = fw21Rec.GetMx100();
+			vMC1000[r] = fw21Rec.GetMx1000();
+			vMCHerb[r] = fw21Rec.GetMxHerb();
+			vMCWood[r] = fw21Rec.GetMxWood();
+			vFuelTemp[r] = fw21Rec.GetFuelTTempC();
+			vWS[r] = (int)fw21Rec.GetWindSpeed();
+			if (outs.IndexHour >= 0 && fw21Rec.GetHour() != outs.IndexHour && r != nRecs - 1)
+				vWS[r] = -1;	//skipped, as it is not written out
+			vKBDI[r] = fw21Rec.GetKBDI();
+			vGSI[r] = fw21Rec.GetGSI();
+			vCalcKBDI[r] = (vKBDI[r] >= 0 && vKBDI[r] <= 800) ? vKBDI[r] : prevKBDI;
+			vCalcGSI[r] = (vGSI[r] >= 0.0) ? vGSI[r] : prevGSI;
+			prevKBDI = vKBDI[r];
+			prevGSI = vGSI[r];
 		}
-		else
-			fw21Calc.Update(fw21Rec.GetYear(), fw21Rec.GetMonth(), fw21Rec.GetDay(), fw21Rec.GetHour(), fw21Rec.GetTemp(), fw21Rec.GetRH(), fw21Rec.GetPrecip(),
-				fw21Rec.GetSolarRadiation(), fw21Rec.GetWindSpeed(), fw21Rec.GetSnowFlag());
-		if (cfg->getOutputInterval() == 0 || (cfg->getOutputInterval() == 1 && fw21Rec.GetHour() == params.getObsHour()))
+		NFDRS4IndexInputs idxIn;
+		idxIn.MC1 = vMC1.data();
+		idxIn.MC10 = vMC10.data();
+		idxIn.MC100 = vMC100.data();
+		idxIn.MC1000 = vMC1000.data();
+		idxIn.MCHERB = vMCHerb.data();
+		idxIn.MCWOOD = vMCWood.data();
+		idxIn.FuelTemperature = vFuelTemp.data();
+		idxIn.WS = vWS.data();
+		idxIn.KBDI = vCalcKBDI.data();
+		idxIn.GSI = vCalcGSI.data();
+		NFDRS4IndexOutputs idxOut;
+		idxOut.BI = vBI.data();
+		idxOut.ERC = vERC.data();
+		idxOut.SC = vSC.data();
+		idxOut.IC = vIC.data();
+		NFDRS4CalcIndexes(fw21Calc.GetFuelBed(), params.getSlopeClass(), nRecs, idxIn, idxOut, params.getSimdIndexes());
+		std::vector<double> vBedBI(nModels > 0 ? nRecs : 0), vBedERC(vBedBI.size()), vBedSC(vBedBI.size()), vBedIC(vBedBI.size());
+		for (int m = 0; m < nModels; m++)
 		{
-			//output to open csv files
-			if (allOut)
+			NFDRS4FuelBed bed;
+			fw21Calc.GetModelFuelBed(m, &bed);
+			NFDRS4IndexOutputs bedOut;
+			bedOut.BI = vBedBI.data();
+			bedOut.ERC = vBedERC.data();
+			bedOut.SC = vBedSC.data();
+			bedOut.IC = vBedIC.data();
+			NFDRS4CalcIndexes(bed, params.getSlopeClass(), nRecs, idxIn, bedOut, params.getSimdIndexes());
+			for (int r = 0; r < nRecs; r++)
 			{
-				fprintf(allOut, "%s,%s,%.1f,%.1f,%.3f,%.1f,%d,%.1f,%d,%.1f,%d,%.10f,"
-					"%.10f,%.10f,%.10f,%.10f,%.10f,%.10f,%.2f,%.2f,%.2f,%.2f,%.10f,%d\n",
-					fw21Rec.GetStation().c_str(),
-					FW21data.DateToOriginal(fw21Rec.GetDateTime(), fw21Rec.GetTimeZoneOffset()).c_str(),
-					fw21Rec.GetTemp(), fw21Rec.GetRH(), fw21Rec.GetPrecip(), fw21Rec.GetWindSpeed(), fw21Rec.GetWindAzimuth(), fw21Rec.GetSolarRadiation(),
-					fw21Rec.GetSnowFlag(), fw21Rec.GetGustSpeed(), fw21Rec.GetGustAzimuth(), 
-					fw21Calc.MC1, fw21Calc.MC10, fw21Calc.MC100, fw21Calc.MC1000, fw21Calc.MCHERB, fw21Calc.MCWOOD, fw21Calc.GetFuelTemperature(),
-					fw21Calc.BI, fw21Calc.ERC, fw21Calc.SC, fw21Calc.IC, fw21Calc.m_GSI, fw21Calc.KBDI);
+				vModelBI[r * nModels + m] = vBedBI[r];
+				vModelERC[r * nModels + m] = vBedERC[r];
+				vModelSC[r * nModels + m] = vBedSC[r];
+				vModelIC[r * nModels + m] = vBedIC[r];
 			}
-			if (indexOut)
+		}
+		//leave the calculator as the last record left it, for the state file
+		if (nRecs > 0)
+		{
+			int last = nRecs - 1;
+			fw21Calc.iSetFuelMoistures(vMC1[last], vMC10[last], vMC100[last], vMC1000[last], vMCWood[last], vMCHerb[last], vFuelTemp[last]);
+			fw21Calc.SC = vSC[last];
+			fw21Calc.ERC = vERC[last];
+			fw21Calc.BI = vBI[last];
+			fw21Calc.IC = vIC[last];
+			fw21Calc.KBDI = vKBDI[last];
+			fw21Calc.m_GSI = vGSI[last];
+		}
+	}
+	else
+	{
+		std::vector<NFDRS4Observation> obs(nRecs);
+		for (int r = 0; r < nRecs; r++)
+		{
+			FW21Record fw21Rec = FW21data.GetRec(r);
+			NFDRS4Observation& o = obs[r];
+			o.Year = fw21Rec.GetYear();
+			o.Month = fw21Rec.GetMonth();
+			o.Day = fw21Rec.GetDay();
+			o.Hour = fw21Rec.GetHour();
+			o.Temp = fw21Rec.GetTemp();
+			o.RH = fw21Rec.GetRH();
+			o.PPTAmt = fw21Rec.GetPrecip();
+			o.SolarRad = fw21Rec.GetSolarRadiation();
+			o.WS = fw21Rec.GetWindSpeed();
+			o.SnowDay = fw21Rec.GetSnowFlag();
+		}
+		fw21Calc.Run(obs.data(), nRecs, outs);
+	}
+	for (int r = 0; r < nRecs; r++)
+	{
+		FW21Record fw21Rec = FW21data.GetRec(r);
+		if (cfg->getOutputInterval() == 0 || (cfg->getOutputInterval() == 1 && fw21Rec.GetHour() == params.getObsHour()))
+		{
+			//output to open csv files, one row per fuelModels model if any
+			for (int m = 0; m < (nModels > 0 ? nModels : 1); m++)
 			{
-				fprintf(indexOut, "%s,%s,%.2f,%.2f,%.2f,%.2f,%.10f,%d\n",
-					fw21Rec.GetStation().c_str(),
-					FW21data.DateToOriginal(fw21Rec.GetDateTime(), fw21Rec.GetTimeZoneOffset()).c_str(),
-					fw21Calc.BI, fw21Calc.ERC, fw21Calc.SC, fw21Calc.IC, fw21Calc.m_GSI, fw21Calc.KBDI);
+				double bi = vBI[r], erc = vERC[r], sc = vSC[r], ic = vIC[r];
+				if (nModels > 0)
+				{
+					bi = vModelBI[r * nModels + m];
+					erc = vModelERC[r * nModels + m];
+					sc = vModelSC[r * nModels + m];
+					ic = vModelIC[r * nModels + m];
+				}
+				if (allOut)
+				{
+					fprintf(allOut, "%s,%s,%.1f,%.1f,%.3f,%.1f,%d,%.1f,%d,%.1f,%d,%.10f,"
+						"%.10f,%.10f,%.10f,%.10f,%.10f,%.10f,%.2f,%.2f,%.2f,%.2f,%.10f,%d",
+						fw21Rec.GetStation().c_str(),
+						FW21data.DateToOriginal(fw21Rec.GetDateTime(), fw21Rec.GetTimeZoneOffset()).c_str(),
+						fw21Rec.GetTemp(), fw21Rec.GetRH(), fw21Rec.GetPrecip(), fw21Rec.GetWindSpeed(), fw21Rec.GetWindAzimuth(), fw21Rec.GetSolarRadiation(),
+						fw21Rec.GetSnowFlag(), fw21Rec.GetGustSpeed(), fw21Rec.GetGustAzimuth(), 
+						vMC1[r], vMC10[r], vMC100[r], vMC1000[r], vMCHerb[r], vMCWood[r], vFuelTemp[r],
+						bi, erc, sc, ic, vGSI[r], vKBDI[r]);
+					if (nModels > 0)
+						fprintf(allOut, ",%c", fw21Calc.GetFuelModel(m));
+					fprintf(allOut, "\n");
+				}
+				if (indexOut)
+				{
+					fprintf(indexOut, "%s,%s,%.2f,%.2f,%.2f,%.2f,%.10f,%d",
+						fw21Rec.GetStation().c_str(),
+						FW21data.DateToOriginal(fw21Rec.GetDateTime(), fw21Rec.GetTimeZoneOffset()).c_str(),
+						bi, erc, sc, ic, vGSI[r], vKBDI[r]);
+					if (nModels > 0)
+						fprintf(indexOut, ",%c", fw21Calc.GetFuelModel(m));
+					fprintf(indexOut, "\n");
+				}
 			}
 			if (moistOut)
 			{
 				fprintf(moistOut, "%s,%s,%.10f,%.10f,%.10f,%.10f,%.10f,%.10f,%.10f\n",
 					fw21Rec.GetStation().c_str(),
 					FW21data.DateToOriginal(fw21Rec.GetDateTime(), fw21Rec.GetTimeZoneOffset()).c_str(),
-					fw21Calc.MC1, fw21Calc.MC10, fw21Calc.MC100, fw21Calc.MC1000, fw21Calc.MCHERB, fw21Calc.MCWOOD, fw21Calc.GetFuelTemperature());
+					vMC1[r], vMC10[r], vMC100[r], vMC1000[r], vMCHerb[r], vMCWood[r], vFuelTemp[r]);
 			}
 		}
 	}
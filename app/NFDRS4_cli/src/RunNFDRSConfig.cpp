@@ -20,7 +20,9 @@ RunNFDRSConfig::RunNFDRSConfig()
 	m_schema[7] = "stationID = string";
 	m_schema[8] = "useStoredOutputs = int";
 	m_schema[9] = "wxFile = string";
-	m_schema[10] = 0;
+	m_schema[10] = "ensembleOutputFile = string";
+	m_schema[11] = "ensemblePercentiles = string";
+	m_schema[12] = 0;
 
 	m_str << "# Sample RunNFDRS configuration file\n";
 	m_str << "# required to initialize RunNFDRS program\n";
@@ -36,9 +38,13 @@ RunNFDRSConfig::RunNFDRSConfig()
 	m_str << "nal)\n";
 	m_str << "#loadFromState will load the state file and begin ";
 	m_str << "any calculations from the saved state\n";
+	m_str << "#if no loadFromState is desired, use \"\";\n";
+	m_str << "#e.g. loadFromState = \"\";\n";
 	m_str << "loadFromStateFile = \"/someSavedState.nfdrs\";\n";
 	m_str << "#saveToStateFile will save the state when calculat";
 	m_str << "ion is complete to the indicated file\n";
+	m_str << "#if no saveToStateFile is desired, use \"\";\n";
+	m_str << "#e.g. saveToStateFile = \"\";\n";
 	m_str << "saveToStateFile = \"/newSavedState.nfdrs\";\n";
 	m_str << "# output files (csv) can be designated, otherwise ";
 	m_str << "nothing is output \n";
@@ -75,7 +81,27 @@ RunNFDRSConfig::RunNFDRSConfig()
 	m_str << " NFDRS4_cli config file\n";
 	m_str << "#this stationID will be used when StationID is not";
 	m_str << " present in FW21\n";
-	m_str << "stationID = \"some_stationID\";";
+	m_str << "stationID = \"some_stationID\";\n";
+	m_str << "#Weather ensembles (optional)\n";
+	m_str << "#a wxFile with a Member column holds several serie";
+	m_str << "s of the same hours, eg. the members of an NWP ens";
+	m_str << "emble forecast\n";
+	m_str << "#each member is run from the one station state (in";
+	m_str << "itFile or loadFromStateFile) and ensembleOutputFil";
+	m_str << "e receives\n";
+	m_str << "#the mean, minimum, maximum and ensemblePercentile";
+	m_str << "s of MC1, ERC, BI, SC and IC across the members fo";
+	m_str << "r each hour\n";
+	m_str << "#allOutputsFile, indexOutputFile, fuelMoisturesOut";
+	m_str << "putFile and saveToStateFile are not written for an";
+	m_str << " ensemble\n";
+	m_str << "#required for a wxFile with a Member column (eg. \"";
+	m_str << "/NFDRSEnsemble.csv\"); for any other wxFile it is i";
+	m_str << "gnored with a warning\n";
+	m_str << "ensembleOutputFile = \"\";\n";
+	m_str << "#comma separated percentiles (0-100) of the ensemb";
+	m_str << "le statistics, \"\" for none\n";
+	m_str << "ensemblePercentiles = \"10,50,90\";";
 }
 
 
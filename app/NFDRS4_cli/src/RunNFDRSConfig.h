@@ -33,7 +33,7 @@ public:
 	void getSchema(const char **& schema, int & schemaSize)
 	{
 		schema = m_schema;
-		schemaSize = 10;
+		schemaSize = 12;
 	}
 	const char ** getSchema() // null terminated array
 	{
@@ -45,7 +45,7 @@ private:
 	// Variables
 	//--------
 	CONFIG4CPP_NAMESPACE::StringBuffer m_str;
-	const char *                       m_schema[11];
+	const char *                       m_schema[13];
 
 	//--------
 	// The following are not implemented
@@ -54,6 +54,8 @@ RunNFDRSConfiguration::~RunNFDRSConfiguration()
 	m_fuelMoisturesOutputsFile = "";
 	m_outputInterval = 0;//default to hourly
 	m_bUseStoredOutputs = 0;
+	m_ensembleOutputFile = "";
+	m_ensemblePercentiles = "";
 }
 
 void RunNFDRSConfiguration::parse(
@@ -88,6 +90,9 @@ void RunNFDRSConfiguration::parse(
 		m_fuelMoisturesOutputsFile = cfg->lookupString(cfgScope, "fuelMoisturesOutputFile");
 		m_outputInterval = cfg->lookupInt(cfgScope, "outputInterval");
 		m_bUseStoredOutputs = cfg->lookupInt(cfgScope, "useStoredOutputs");
+		//optional, added for weather ensembles
+		m_ensembleOutputFile = cfg->lookupString(cfgScope, "ensembleOutputFile", "");
+		m_ensemblePercentiles = cfg->lookupString(cfgScope, "ensemblePercentiles", "");
 	}
 	catch (const ConfigurationException & ex) {
 		//do nothing but print the message
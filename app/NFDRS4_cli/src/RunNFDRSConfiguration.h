@@ -42,6 +42,8 @@ public:
 	const char *	getFuelMoisturesOutputsFile() { return m_fuelMoisturesOutputsFile; }
 	int getOutputInterval() { return m_outputInterval; }
 	int getUseStoredOutputs() { return m_bUseStoredOutputs; }
+	const char *	getEnsembleOutputFile() { return m_ensembleOutputFile; }
+	const char *	getEnsemblePercentiles() { return m_ensemblePercentiles; }
 private:
 	void * m_cfg;
 	bool m_wantDiagnostics;
@@ -57,6 +59,8 @@ private:
 	const char * m_fuelMoisturesOutputsFile;
 	int m_outputInterval;//0 = hourly(each record), 1 = daily
 	int m_bUseStoredOutputs; //non-zero value causes NFDRS4_cli to bypass Nelson and GSI models
+	const char * m_ensembleOutputFile;//statistics across the members of a wxFile with a Member column
+	const char * m_ensemblePercentiles;//comma separated percentiles of the ensemble statistics
 	//--------
 	// Not implemented
 	//--------
@@ -27,8 +27,15 @@
 #define _DEADFUELMOISTURE_H_INCLUDED_
 
 #include "dfmcalcstate.h"
+#include "dfmdiffusivitytable.h"
+#include "dfmforcing.h"
+#include "dfmmultirate.h"
+#include "dfmnodearray.h"
+#include "dfmsimd.h"
+#include "nfdrs4statesizes.h"
 // Standard include files
 #include <cmath>
+#include <ctime>
 #include <iomanip>
 #include <iostream>
 #include <ostream>
@@ -109,6 +116,7 @@
     -- void setMoistureSteps( int moistureSteps );
     -- void setRainfallRunoffFactor( double rainfallRunoffFactor );
     -- void setRandomSeed( int randseed=0 ) ;
+    -- void setRandomStream( const std::string& stream ) ;
     -- void setStickDensity( double stickDensity=0.4 );
     -- void setStickLength( double stickLength=41.0 );
     -- void setStickNodes( int stickNodes=11 ) ;
@@ -167,6 +175,46 @@
 
 
 
+//------------------------------------------------------------------------------
+/*! \var DFM_SnapshotNodes
+    \brief Most stick nodes a DFMSnapshot holds.
+ */
+static const int DFM_SnapshotNodes = 16;
+
+//------------------------------------------------------------------------------
+/*! \struct DFMSnapshot
+    \brief The complete dynamic state of a DeadFuelMoisture stick, as taken
+    by DeadFuelMoisture::snapshot().
+
+    Unlike DFMCalcState, a snapshot is flat and trivially copyable, keeps
+    the nodal arrays at full precision and holds the previous observation
+    and time step state as well, so restore() followed by update() gives
+    the same results as the stick it was taken from.  Stick parameters are
+    not part of it.
+ */
+
+struct DFMSnapshot
+{
+    int     nodes;                          //!< Number of stick nodes.
+    FP_COMPUTE_TYPE t[DFM_SnapshotNodes];   //!< Nodal temperatures (oC).
+    FP_COMPUTE_TYPE s[DFM_SnapshotNodes];   //!< Nodal fiber saturation points (g/g).
+    FP_COMPUTE_TYPE d[DFM_SnapshotNodes];   //!< Nodal bound water diffusivities (cm2/h).
+    FP_COMPUTE_TYPE w[DFM_SnapshotNodes];   //!< Nodal moisture contents (g/g).
+    double  Jday, Year, Month, Day, Hour, Min, Sec;
+    time_t  obstime;
+    double  bp0, ha0, rc0, sv0, ta0;
+    double  bp1, et, ha1, rc1, sv1, ta1;
+    double  ddt, mdt, mdt_2, pptrate, ra0, ra1, rdur, sf;
+    double  hf, wsa, sem, wfilm, elapsed;
+    long    updates;
+    int     state;
+    int     substeps;
+    unsigned long long rngKey;
+    unsigned long long rngCounter;
+    bool    init;
+    bool    equilibrium;
+};
+
 //------------------------------------------------------------------------------
 /*! \class DeadFuelMoisture DeadFuelMoisture.h
     \brief Determines moisture content of dead and down woody fuels
@@ -199,93 +247,93 @@ class DeadFuelMoisture
 /*! \var Aks
     \brief Permeability of a water saturated stick (2.0e-13 cm2).
  */
-static const double Aks;    // = 2.0e-13;
+static constexpr double Aks = 2.0e-13;
 
 /*! \var Alb
     \brief Shortwave albido (0.6 dl).
  */
-static const double Alb;    // = 0.6;
+static constexpr double Alb = 0.6;
 
 /*! \var Alpha
     \brief Fraction of cell length that overlaps adjacent cells (0.25 cm/cm).
  */
-static const double Alpha;  // = 0.25;
+static constexpr double Alpha = 0.25;
 
 /*! \var Ap
     \brief Psychrometric constant (0.000772 / oC).
  */
-static const double Ap;     // = 0.000772;
+static constexpr double Ap = 0.000772;
 
 /*! \var Aw
     \brief Ratio of cell cavity to total cell width (0.8 cm/cm).
  */
-static const double Aw;     // = 0.8;
+static constexpr double Aw = 0.8;
 
 /*! \var Eps
     \brief Longwave emissivity of stick surface (0.85 dl).
  */
-static const double Eps;    // = 0.85;
+static constexpr double Eps = 0.85;
 
 /*! \var Hfs
     \brief Saturation value of the stick surface humidity (0.99 g/g).
  */
-static const double Hfs;    // = 0.99;
+static constexpr double Hfs = 0.99;
 
 /*! \var Kelvin
     \brief Celcius-to-Kelvin offset (273.2 oC).
  */
-static const double Kelvin; // = 273.2;
+static constexpr double Kelvin = 273.2;
 
 /*! \var Pi
     \brief A well-rounded number (dl).
  */
-static const double Pi;     // = 3.141592654;
+static constexpr double Pi = 3.141592654;
 
 /*! \var Pr
     \brief Prandtl number (0.7 dl).
  */
-static const double Pr;     // = 0.7;
+static constexpr double Pr = 0.7;
 
 /*! \var Sbc
     \brief Stefan-Boltzmann constant (1.37e-12 cal/cm2-s-K4).
  */
-static const double Sbc;    // = 1.37e-12;
+static constexpr double Sbc = 1.37e-12;
 
 /*! \var Sc
     \brief Schmidt number (0.58 dl).
  */
-static const double Sc;     // = 0.58;
+static constexpr double Sc = 0.58;
 
 /*! \var Smv
     \brief Factor to convert solar radiation from W/m2 to milliVolts
     \f$mv = \frac {W / m^{2}} {94.743}\f$
  */
-static const double Smv;    // = 94.743;
+static constexpr double Smv = 94.743;
 
 /*! \var St
     \brief Surface tension (72.8).
  */
-static const double St;     // = 72.8;
+static constexpr double St = 72.8;
 
 /*! \var Tcd
     \brief Day time clear sky temperature (6 oC).
  */
-static const double Tcd;    // = 6.;
+static constexpr double Tcd = 6.;
 
 /*! \var Tcn
     \brief Night time clear sky temperature (3 oC).
  */
-static const double Tcn;    // = 3.;
+static constexpr double Tcn = 3.;
 
 /*! \var Thdiff
     \brief Thermal diffusivity ( 8.0 cms/h).
  */
-static const double Thdiff; // = 8.0;
+static constexpr double Thdiff = 8.0;
 
 /*! \var Wl
     \brief Diameter of interior cell cavity ( 0.0023 cm).
  */
-static const double Wl;     // = 0.0023;
+static constexpr double Wl = 0.0023;
 
 //------------------------------------------------------------------------------
 // Stick-independent intermediates derived in Fms_CreateConstant().
@@ -294,12 +342,12 @@ static const double Wl;     // = 0.0023;
 /*! \var Srf
     \brief Factor to derive "sr", solar radiation received (14.82052 cal/cm2-h).
  */
-static const double Srf;    // = 14.82052;
+static constexpr double Srf = 14.82052;
 
 /*! \var Wsf
     \brief Manifest constant equal to -log(1.0 - 0.99)
  */
-static const double Wsf;    // = 4.60517;
+static constexpr double Wsf = 4.60517;
 
 /*! \var Hrd
     \brief Factor to derive daytime long wave radiative surface heat transfer.
@@ -308,7 +356,7 @@ static const double Wsf;    // = 4.60517;
     \arg Then Hrd = Sb * tsk * tsk * tsk / Pi;
     \arg And Hrd = 0.116171;
  */
-static const double Hrd;    // = 0.116171;
+static constexpr double Hrd = 0.116171;
 
 /*! \var Hrn
     \brief Factor to derive nighttime long wave radiative surface heat transfer.
@@ -317,20 +365,20 @@ static const double Hrd;    // = 0.116171;
     \arg Then Hrn = Sb * tsk * tsk * tsk / Pi;
     \arg And Hrn = 0.112467;
  */
-static const double Hrn;    // = 0.112467;
+static constexpr double Hrn = 0.112467;
 
 /*! \var Sir
     \brief Saturation value below which liquid water columns no longer exist.
     \arg Sir = Aw * Alpha / (4. * (1.-(2.-Aw) * Alpha));
  */
-static const double Sir;    // = 0.0714285;
+static constexpr double Sir = 0.0714285;
 
 /*! \var Scr
     \brief Saturation value at which liquid miniscus first enters the tapered
     portion of wood cells.
     \arg Scr = 4. * Sir = 0.285714;
  */
-static const double Scr;    // = 0.285714;
+static constexpr double Scr = 0.285714;
 
 //------------------------------------------------------------------------------
 /*! \enum DFM_State
@@ -347,6 +395,7 @@ static const int DFM_States = 11;
 public:
     friend std::ostream &operator<<(std::ostream& output, const DeadFuelMoisture& r );
     friend std::istream &operator>>(std::istream& input, DeadFuelMoisture& r );
+    friend class DeadFuelMoistureBatch;
 
 // Public methods
 public:
@@ -377,7 +426,6 @@ public:
     static double  derivePlanarHeatTransferRate( double radius ) ;
     static double  deriveRainfallRunoffFactor( double radius ) ;
     static int     deriveStickNodes( double radius ) ;
-    static double  uniformRandom( double min, double max ) ;
 
     // Methods for initializing the dead fuel stick and its environment
     void initializeEnvironment(
@@ -431,9 +479,18 @@ public:
         double  bpr=0.0218,
         bool prcpAsAmnt = false
     ) ;
+    bool updateSeries(
+        int     year,
+        int     month,
+        int     day,
+        int     hour,
+        const DFMMultiRate& series,
+        double  bpr=0.0218
+    ) ;
     void zero( void ) ;
 
     // Methods to access update() results
+    bool   atEquilibrium( void ) const ;
     double elapsedTime( void ) const ;
     bool   initialized( void ) const ;
     std::string name( void ) const ;
@@ -447,20 +504,26 @@ public:
     const char* stateName( void ) const;
     double surfaceMoisture( void ) const ;
     double surfaceTemperature( void ) const;
+    int    substeps( void ) const;
     long   updates( void ) const;
 
     // Methods to access model parameters
     double adsorptionRate( void ) const ;
     double desorptionRate( void ) const ;
     int    diffusivitySteps( void ) const ;
+    bool   equilibriumSkip( void ) const ;
+    const DFMForcing* forcing( void ) const ;
+    bool   implicitSolver( void ) const ;
     double maximumLocalMoisture( void ) const ;
     int    moistureSteps( void ) const ;
 
     double planarHeatTransferRate( void ) const ;
     double rainfallRunoffFactor( void ) const ;
+    bool   simdDiffusivity( void ) const ;
     double stickDensity( void ) const ;
     double stickLength( void ) const ;
     int    stickNodes( void ) const ;
+    bool   tabulatedDiffusivity( void ) const ;
     double waterFilmContribution( void ) const ;
 
     // For those who want to experiment with the model parameters...
@@ -470,25 +533,43 @@ public:
     void setAllowRainfall2( bool allow=true ) ;
     void setDesorptionRate( double desorptionRate=0.06 ) ;
     void setDiffusivitySteps( int diffusivitySteps );
+    void setEquilibriumSkip( bool skip=true, double moistureTolerance=1.0e-7, double temperatureTolerance=1.0e-5 ) ;
+    void setForcing( const DFMForcing* forcing ) ;
+    void setImplicitSolver( bool implicit=true, int moistureSteps=0 ) ;
     void setMaximumLocalMoisture( double localMaxMc=0.6 ) ;
     void setMoistureSteps( int moistureSteps );
     void setPertubateColumn( bool pertubate=true ) ;
     void setPlanarHeatTransferRate( double planarHeatTransferRate ) ;
     void setRainfallRunoffFactor( double rainfallRunoffFactor );
     void setRandomSeed( int randseed=0 ) ;
+    void setRandomStream( const std::string& stream ) ;
     void setRampRai0( bool ramp=true ) ;
+    void setSimdDiffusivity( bool simd=true ) ;
     void setStickDensity( double stickDensity=0.4 );
     void setStickLength( double stickLength=41.0 );
     void setStickNodes( int stickNodes=11 ) ;
+    void setTabulatedDiffusivity( bool tabulated=true ) ;
     void setWaterFilmContribution( double waterFilm=0.0 ) ;
 	void setMoisture(float initFM);
 	double eqmc(double fTemp, double fRH);
 	void initializeParameters( double radius, const std::string& name ) ;
 	DFMCalcState GetState();
 	bool SetState(DFMCalcState state);
+    bool snapshot( DFMSnapshot* snap ) const ;
+    bool restore( const DFMSnapshot& snap ) ;
 // Protected methods
 protected:
     void diffusivity( double bp ) ;
+    int  activeMoistureSteps( void ) const ;
+    bool steadyForcing( void ) const ;
+    void runoffFactors( double ha0, double ha1, double* rai0, double* rai1 ) const ;
+    void seriesForcing( double tfract, double* ta, double* ha, double* sv, double* rai0, double* rai1 ) ;
+    virtual void integrate( double et, double rai0, double rai1, int* tstate ) ;
+    template <class Nodal> void diffusivityNodes( Nodal& n, double bp ) ;
+    template <class Nodal> void integrateNodes( Nodal& n, double et, double rai0, double rai1, int* tstate ) ;
+    template <class Nodal> void interpolateDiffusivityNodes( Nodal& n, double bp ) ;
+    double streamRandom( double min, double max ) ;
+    static unsigned long long mixRandom( unsigned long long z ) ;
 
     void initializeParameters(
             const std::string& name,
@@ -547,12 +628,24 @@ protected:
     bool    m_allowRainstorm;   // If TRUE, applies Nelson's logic for rainstorm transition and state
     bool    m_pertubateColumn;  // If TRUE, the continuous liquid column condition get pertubated
     bool    m_rampRai0;         // If TRUE, used Bevins' ramping of rainfall runoff factor rather than Nelsons rai0 *= 0.15
+    bool    m_tabulatedDiffusivity; // If TRUE, diffusivity() interpolates from a DFMDiffusivityTable
+    const DFMDiffusivityTable* m_dTable; //!< Shared diffusivity table for \a m_density, or NULL until first used.
+    bool    m_simdDiffusivity;  // If TRUE, diffusivity() runs the DFMSimd kernels
+    int     m_substeps; //!< Number of moisture time steps taken by the last update().
+    bool    m_equilibriumSkip;  // If TRUE, update() skips the computation once the stick has converged under steady forcing
+    double  m_equilibriumMoistureTol;       //!< Largest nodal moisture change over an update at equilibrium (g/g).
+    double  m_equilibriumTemperatureTol;    //!< Largest nodal temperature change over an update at equilibrium (oC).
+    bool    m_equilibrium;  //!< The nodal profile has converged under the current forcing.
+    const DFMForcing* m_forcing;    //!< Shared atmospheric forcing, or NULL to derive it at each time step.
+    const DFMMultiRate* m_series;   //!< Hourly observations of the updateSeries() in progress, or NULL.
+    bool    m_implicitSolver;   // If TRUE, update() propagates nodal changes with an implicit tridiagonal solve
+    int     m_implicitSteps;    //!< Moisture time steps per observation with the implicit solver, or 0 for \a m_mSteps.
 
     // Intermediate stick variables derived in initializeStick()
     double  m_dx;       //!< Internodal radial distance (cm).
     double  m_wmax;     //!< Maximum possible stick moisture content (g water/g dry fuel).
-    std::vector<double> m_x; //!< Array of nodal radial distances from stick center (cm).
-    std::vector<double> m_v; //!< Array of nodal volume weighting fractions (cm3 node/cm3 stick).
+    DFMNodeArray<FP_COMPUTE_TYPE> m_x; //!< Array of nodal radial distances from stick center (cm).
+    std::vector<FP_COMPUTE_TYPE> m_v; //!< Array of nodal volume weighting fractions (cm3 node/cm3 stick).
 
     // Optimization factors derived in initializeStick()
     double  m_amlf;     //!< \a aml optimization factor.
@@ -593,19 +686,27 @@ protected:
     double  m_sem;      //!< Stick equilibrium moisture content (g water/g dry fuel).
     double  m_wfilm;    //!< Amount of water film (0 or \a m_wfilmk) (g water/g dry fuel).
     double  m_elapsed;  //!< Total simulation elapsed time (h).
-    std::vector<double> m_t; //!< Array of nodal temperatures (oC).
-    std::vector<double> m_s; //!< Array of nodal fiber saturation points (g water/g dry fuel).
-    std::vector<double> m_d; //!< Array of nodal bound water diffusivities (cm2/h).
-    std::vector<double> m_w; //!< Array of nodal moisture contents (g water/g dry fuel).
+    DFMNodeArray<FP_COMPUTE_TYPE> m_t; //!< Array of nodal temperatures (oC).
+    DFMNodeArray<FP_COMPUTE_TYPE> m_s; //!< Array of nodal fiber saturation points (g water/g dry fuel).
+    DFMNodeArray<FP_COMPUTE_TYPE> m_d; //!< Array of nodal bound water diffusivities (cm2/h).
+    DFMNodeArray<FP_COMPUTE_TYPE> m_w; //!< Array of nodal moisture contents (g water/g dry fuel).
     long    m_updates;  //!< Number of calls made to update().
     int m_state;  //!< Prevailing dead fuel moisture state.
     int     m_randseed; //!< If not zero, nodal temperature, saturation, and moisture contents are pertubated by some small amount. If < 0, uses system clock for seed.
-    std::vector<double> m_Ttold; //!< Temporary array of nodal temperatures (oC).
-    std::vector<double> m_Tsold; //!< Temporary array of nodal fiber saturation points (g water/g dry fuel).
-    std::vector<double> m_Twold; //!< Temporary array of nodal moisture contents (g water/g dry fuel).
-    std::vector<double> m_Tv;    //!< Temporary array used to redistribute nodal temperatures
-    std::vector<double> m_To;    //!< Temporary array used to redistribute moisture contents
-    std::vector<double> m_Tg;    //!< Temporary array of nodal free water transport coefficients
+    std::string m_rngStream;        //!< Identity of the stick's random stream (e.g. station id).
+    unsigned long long m_rngKey;    //!< Random stream key derived from the seed, stick name and stream identity.
+    unsigned long long m_rngCounter; //!< Number of draws made from the random stream.
+    std::vector<FP_COMPUTE_TYPE> m_Ttold; //!< Temporary array of nodal temperatures (oC).
+    std::vector<FP_COMPUTE_TYPE> m_Tsold; //!< Temporary array of nodal fiber saturation points (g water/g dry fuel).
+    std::vector<FP_COMPUTE_TYPE> m_Twold; //!< Temporary array of nodal moisture contents (g water/g dry fuel).
+    std::vector<FP_COMPUTE_TYPE> m_Tv;    //!< Temporary array used to redistribute nodal temperatures
+    std::vector<FP_COMPUTE_TYPE> m_To;    //!< Temporary array used to redistribute moisture contents
+    std::vector<FP_COMPUTE_TYPE> m_Tg;    //!< Temporary array of nodal free water transport coefficients
+    std::vector<FP_COMPUTE_TYPE> m_Tc;    //!< Cached nodal propagation coefficients (see integrateNodes())
+    std::vector<FP_COMPUTE_TYPE> m_Tw0;   //!< Nodal moisture contents before an equilibriumSkip update (g/g)
+    std::vector<FP_COMPUTE_TYPE> m_Tt0;   //!< Nodal temperatures before an equilibriumSkip update (oC)
+    FP_COMPUTE_TYPE m_coefStep;           //!< Time step of the coefficients in \a m_Tc (h), 0 if none
+    FP_COMPUTE_TYPE m_coefDx;             //!< Internodal distance of the coefficients in \a m_Tc (cm)
 };
 
 
@@ -0,0 +1,195 @@
+//------------------------------------------------------------------------------
+/*! \file deadfuelmoisturebatch.h
+    \brief DeadFuelMoistureBatch class interface and declarations.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifndef _DEADFUELMOISTUREBATCH_H_INCLUDED_
+#define _DEADFUELMOISTUREBATCH_H_INCLUDED_
+
+#include "deadfuelmoisture.h"
+#include <ctime>
+#include <vector>
+
+//------------------------------------------------------------------------------
+/*! \class DeadFuelMoistureBatch deadfuelmoisturebatch.h
+    \brief Advances many dead fuel moisture sticks of the same size class
+    (one per station) together.
+
+    The nodal arrays of all sticks are held in structure-of-arrays layout,
+    node-major and lane-minor, so element \a (node, lane) lives at
+    \a node * lanes() + lane.  Every node loop of the Nelson model
+    (free water transport, saturation, moisture and temperature propagation,
+    and the bound water diffusivity) then runs over contiguous lanes and is
+    vectorized by the compiler, one SIMD lane per station.  The surface
+    state branches (rainfall, condensation, evaporation, desorption,
+    adsorption) are evaluated lane by lane.
+
+    All lanes share the stick geometry and step counts (radius, nodes,
+    moisture and diffusivity steps, length and the rainfall/rainstorm
+    switches) and the observation clock.  Stick density, surface mass
+    transfer rates, maximum local moisture, heat transfer and runoff factors
+    may differ per lane, so sticks configured through
+    NFDRS4::SetOneHourParams() and friends can share a batch.
+
+    \par Tolerance
+    Each lane performs exactly the operations of DeadFuelMoisture::update()
+    in the same order, so results are bit-for-bit identical to the scalar
+    class in the default build.  When the library is compiled with
+    floating-point contraction or fast-math (e.g. -march=native -ffast-math)
+    the compiler may fuse or reorder the lane arithmetic differently from
+    the scalar code; the batch then agrees with the scalar class to within
+    1.0e-12 g/g in stick moisture and 1.0e-12 oC in stick temperature over
+    a year of hourly updates.  The batch always computes in double, so in
+    builds with FP_COMPUTE_TYPE float it agrees with the scalar class only
+    to within the single precision drift of that build.
+
+    Sticks using tabulated diffusivity (see
+    DeadFuelMoisture::setTabulatedDiffusivity()) interpolate from the same
+    shared tables as the scalar class and remain bit-for-bit identical to it;
+    every lane must use the same diffusivity mode as the prototype.
+
+    \note Sticks that use random perturbation (a non-zero random seed or
+    setPertubateColumn()) draw from their own random streams in the middle
+    of the node loops, which the batch does not replicate; setStick()
+    rejects them.  Such sticks are reproducible on their own, so ensembles
+    of them can instead be spread over threads one stick per task.  Lanes
+    always take the full moistureSteps(), so sticks using
+    DeadFuelMoisture::setEquilibriumSkip() are rejected as well, as are
+    sticks given a DFMForcing with DeadFuelMoisture::setForcing() and
+    sticks using DeadFuelMoisture::setImplicitSolver().
+
+    Typical use:
+
+    -- DeadFuelMoisture proto; proto.initDeadFuelMoisture1();
+    -- DeadFuelMoistureBatch batch( proto, nStations );
+    -- batch.update( year, month, day, hour, 0, 0, at, rh, sW, rcum, 0.0218, true );
+    -- double mc1 = batch.medianRadialMoisture( station ) * 100.;
+ */
+
+class DeadFuelMoistureBatch
+{
+// Public methods
+public:
+    DeadFuelMoistureBatch( void ) ;
+    DeadFuelMoistureBatch( const DeadFuelMoisture& prototype, int lanes ) ;
+    ~DeadFuelMoistureBatch( void ) ;
+
+    // Batch setup
+    void initialize( const DeadFuelMoisture& prototype, int lanes ) ;
+    bool compatible( const DeadFuelMoisture& stick ) const ;
+    bool setStick( int lane, const DeadFuelMoisture& stick ) ;
+    bool getStick( int lane, DeadFuelMoisture& stick ) const ;
+
+    // Methods for updating the fuel moisture condition of every lane
+    int update(
+        int     year,
+        int     month,
+        int     day,
+        int     hour,
+        int     minute,
+        int     second,
+        const double* at,
+        const double* rh,
+        const double* sW,
+        const double* rcum,
+        double  bpr=0.0218,
+        bool    prcpAsAmnt=false,
+        bool*   updated=NULL
+    ) ;
+    int update(
+        double  et,
+        const double* at,
+        const double* rh,
+        const double* sW,
+        const double* rcum,
+        double  bpr=0.0218,
+        bool    prcpAsAmnt=false,
+        bool*   updated=NULL
+    ) ;
+
+    // Methods to access update() results for a single lane
+    int    lanes( void ) const ;
+    int    stickNodes( void ) const ;
+    long   updates( void ) const ;
+    double elapsedTime( void ) const ;
+    double meanWtdMoisture( int lane ) const ;
+    double medianRadialMoisture( int lane ) const ;
+    double meanWtdTemperature( int lane ) const ;
+    double surfaceMoisture( int lane ) const ;
+    double surfaceTemperature( int lane ) const ;
+    int    state( int lane ) const ;
+
+// Protected methods
+protected:
+    void diffusivity( const double* bp ) ;
+    void interpolateDiffusivity( const double* bp ) ;
+
+// Protected data members
+protected:
+    DeadFuelMoisture m_proto;   //!< Stick that supplies the shared geometry and parameters.
+    int     m_lanes;    //!< Number of sticks (stations) in the batch.
+    int     m_nodes;    //!< Number of stick nodes in the radial direction.
+    int     m_mSteps;   //!< Number of moisture content computation steps per observation.
+    int     m_dSteps;   //!< Number of diffusivity computation steps per observation.
+    double  m_dx;       //!< Internodal radial distance (cm).
+    bool    m_allowRainfall2;   //!< Nelson's rainfall runoff logic after the first hour.
+    bool    m_allowRainstorm;   //!< Nelson's rainstorm transition logic.
+    bool    m_rampRai0;         //!< Bevins' ramping of the rainfall runoff factor.
+    std::vector<double> m_x;    //!< Nodal radial distances from stick center (cm).
+    std::vector<double> m_v;    //!< Nodal volume weighting fractions.
+    std::vector<double> m_Tv;   //!< Thermal diffusivity weighted by radial distance.
+
+    // Shared observation clock
+    double  m_Jday;
+    double  m_Year;
+    double  m_Month;
+    double  m_Day;
+    double  m_Hour;
+    time_t  m_obstime;
+    long    m_updates;  //!< Number of calls made to update().
+    double  m_elapsed;  //!< Total simulation elapsed time (h).
+
+    // Per-lane stick parameters (size m_lanes)
+    std::vector<double> m_density, m_hc, m_rai0, m_rai1, m_stca, m_stcd, m_stv;
+    std::vector<double> m_wfilmk, m_wmx, m_wmax, m_amlf, m_capf, m_hwf, m_vf;
+
+    // Per-lane environment (size m_lanes)
+    std::vector<double> m_bp0, m_ha0, m_rc0, m_sv0, m_ta0;
+    std::vector<double> m_bp1, m_et, m_ha1, m_rc1, m_sv1, m_ta1;
+    std::vector<double> m_pptrate, m_ra0, m_ra1, m_rdur;
+    std::vector<double> m_hf, m_wsa, m_sem, m_wfilm;
+    std::vector<int>    m_state;
+    std::vector<char>   m_init;
+
+    // Per-lane nodal arrays (size m_nodes * m_lanes, node-major)
+    std::vector<double> m_t;    //!< Nodal temperatures (oC).
+    std::vector<double> m_s;    //!< Nodal fiber saturation points (g/g).
+    std::vector<double> m_d;    //!< Nodal bound water diffusivities (cm2/h).
+    std::vector<double> m_w;    //!< Nodal moisture contents (g/g).
+    std::vector<double> m_Ttold, m_Tsold, m_Twold, m_To, m_Tg;
+
+    // Per-lane update() scratch (size m_lanes)
+    std::vector<char>   m_active;   //!< Lane accepted the current observation.
+    std::vector<char>   m_moving;   //!< Lane is active and not stagnant this step.
+    std::vector<char>   m_column;   //!< Lane has continuous liquid columns this step.
+    std::vector<double> m_bp, m_wdiff, m_gnu, m_rai0Step, m_rai1Step;
+    std::vector<int>    m_tstate;   //!< State counters (size DFM_States * m_lanes).
+    std::vector<const DFMDiffusivityTable*> m_dTable;   //!< Per-lane tables when the prototype uses tabulated diffusivity.
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of deadfuelmoisturebatch.h
+//------------------------------------------------------------------------------
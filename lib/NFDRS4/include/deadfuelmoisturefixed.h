@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+/*! \file deadfuelmoisturefixed.h
+    \brief DeadFuelMoistureFixed class template interface and declarations.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifndef _DEADFUELMOISTUREFIXED_H_INCLUDED_
+#define _DEADFUELMOISTUREFIXED_H_INCLUDED_
+
+#include "deadfuelmoisture.h"
+#include <array>
+
+//------------------------------------------------------------------------------
+/*! \var DFM_StandardNodes
+    \brief Number of stick nodes derived by DeadFuelMoisture::deriveStickNodes()
+    for the 1-h, 10-h, 100-h and 1000-h sticks (and any radius above 0.137 cm).
+ */
+static const int DFM_StandardNodes = 11;
+
+//------------------------------------------------------------------------------
+/*! \struct DFMFixedNodes
+    \brief Nodal arrays of a stick with \a Nodes nodes, as passed to
+    DeadFuelMoisture::integrateNodes().
+ */
+
+template <int Nodes>
+struct DFMFixedNodes
+{
+    static constexpr int size( void ) { return( Nodes ); }
+    std::array<FP_COMPUTE_TYPE, Nodes> x;        //!< Nodal radial distances from stick center (cm).
+    std::array<FP_COMPUTE_TYPE, Nodes> t;        //!< Nodal temperatures (oC).
+    std::array<FP_COMPUTE_TYPE, Nodes> s;        //!< Nodal fiber saturation points (g/g).
+    std::array<FP_COMPUTE_TYPE, Nodes> d;        //!< Nodal bound water diffusivities (cm2/h).
+    std::array<FP_COMPUTE_TYPE, Nodes> w;        //!< Nodal moisture contents (g/g).
+    std::array<FP_COMPUTE_TYPE, Nodes> Ttold;    //!< Nodal temperatures at the previous time step (oC).
+    std::array<FP_COMPUTE_TYPE, Nodes> Tsold;    //!< Nodal fiber saturation points at the previous time step (g/g).
+    std::array<FP_COMPUTE_TYPE, Nodes> Twold;    //!< Nodal moisture contents at the previous time step (g/g).
+    std::array<FP_COMPUTE_TYPE, Nodes> Tv;       //!< Used to redistribute nodal temperatures.
+    std::array<FP_COMPUTE_TYPE, Nodes> To;       //!< Used to redistribute moisture contents.
+    std::array<FP_COMPUTE_TYPE, Nodes> Tg;       //!< Nodal free water transport coefficients.
+    std::array<FP_COMPUTE_TYPE, Nodes> Ar;       //!< Cached nodal storage coefficients.
+    std::array<FP_COMPUTE_TYPE, Nodes> Tve;      //!< Cached east temperature coefficients.
+    std::array<FP_COMPUTE_TYPE, Nodes> Tvw;      //!< Cached west temperature coefficients.
+    std::array<FP_COMPUTE_TYPE, Nodes> Tvp;      //!< Cached temperature coefficient sums.
+    std::array<FP_COMPUTE_TYPE, Nodes> Toe;      //!< Cached east moisture coefficients.
+    std::array<FP_COMPUTE_TYPE, Nodes> Tow;      //!< Cached west moisture coefficients.
+    std::array<FP_COMPUTE_TYPE, Nodes> Top;      //!< Cached moisture coefficient sums.
+    FP_COMPUTE_TYPE coefStep;                    //!< Time step of the cached coefficients (h), 0 if none.
+    FP_COMPUTE_TYPE coefDx;                      //!< Internodal distance of the cached coefficients (cm).
+};
+
+//------------------------------------------------------------------------------
+/*! \class DeadFuelMoistureFixed deadfuelmoisturefixed.h
+    \brief DeadFuelMoisture whose moisture computation time steps run on
+    \a Nodes nodes known at compile time.
+
+    The nodal distances, temperatures, saturations, diffusivities and
+    moisture contents are held in the std::array members of \a m_fixed,
+    which the inherited DeadFuelMoisture arrays are bound to (see
+    DFMNodeArray::bind()), so the accessors, GetState(), the stream
+    operators and update() all read and write the same values.  update()
+    runs the moisture and diffusivity computations directly on them, where
+    the node loops have constant bounds and the model constants fold into
+    them.  Results are identical to the DeadFuelMoisture class.
+
+    Sticks whose node count differs from \a Nodes (e.g. after
+    initializeParameters() with a radius of 0.137 cm or less, or
+    setStickNodes()) keep their nodal arrays on the heap and run the
+    DeadFuelMoisture computations, with the same results; fixedNodes()
+    tells which applies.
+
+    \note The time step kernel is compiled into the library for
+    \a Nodes = DFM_StandardNodes only.  Other instantiations need an
+    explicit instantiation of DeadFuelMoisture::integrateNodes() for
+    DFMFixedNodes<\a Nodes> in deadfuelmoisture.cpp.
+ */
+
+template <int Nodes>
+class DeadFuelMoistureFixed : public DeadFuelMoisture
+{
+// Public methods
+public:
+    DeadFuelMoistureFixed( double radius=0.64, const std::string& name="" ) :
+        DeadFuelMoisture( radius, name )
+    {
+        m_fixed.coefStep = m_fixed.coefDx = 0;
+        bindNodes();
+    }
+
+    DeadFuelMoistureFixed( const DeadFuelMoistureFixed& r ) :
+        DeadFuelMoisture( r ),
+        m_fixed( r.m_fixed )
+    {
+        bindNodes();
+    }
+
+    DeadFuelMoistureFixed& operator=( const DeadFuelMoistureFixed& r )
+    {
+        if ( this != &r )
+        {
+            DeadFuelMoisture::operator=( r );
+            m_fixed.coefStep = m_fixed.coefDx = 0;
+        }
+        return( *this );
+    }
+
+    //! Returns TRUE if update() runs on the \a Nodes node std::array storage.
+    bool fixedNodes( void ) const { return( m_nodes == Nodes ); }
+
+// Protected methods
+protected:
+    virtual void integrate( double et, double rai0, double rai1, int* tstate )
+    {
+        if ( m_nodes != Nodes )
+        {
+            DeadFuelMoisture::integrate( et, rai0, rai1, tstate );
+            return;
+        }
+        integrateNodes( m_fixed, et, rai0, rai1, tstate );
+        return;
+    }
+
+    //! Binds the inherited nodal arrays to the std::array members of \a m_fixed.
+    void bindNodes( void )
+    {
+        m_x.bind( m_fixed.x.data(), Nodes );
+        m_t.bind( m_fixed.t.data(), Nodes );
+        m_s.bind( m_fixed.s.data(), Nodes );
+        m_d.bind( m_fixed.d.data(), Nodes );
+        m_w.bind( m_fixed.w.data(), Nodes );
+        return;
+    }
+
+// Protected data members
+protected:
+    DFMFixedNodes<Nodes> m_fixed;   //!< Nodal arrays and time step temporaries.
+};
+
+//------------------------------------------------------------------------------
+/*! \typedef DeadFuelMoistureStandard
+    \brief Fixed node count stick used by NFDRS4 for the standard size classes.
+ */
+typedef DeadFuelMoistureFixed<DFM_StandardNodes> DeadFuelMoistureStandard;
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of deadfuelmoisturefixed.h
+//------------------------------------------------------------------------------
@@ -13,6 +13,8 @@ public:
 
 	bool  ReadState(FILE *in);
 	bool SaveState(FILE *out);
+	bool ReadRandomState(FILE *in);
+	bool SaveRandomState(FILE *out);
 
 	//use to construct obstime member
 	short m_JDay;
@@ -52,5 +54,11 @@ public:
 	std::vector<FP_STORAGE_TYPE> m_d; //!< Array of nodal bound water diffusivities (cm2/h).
 	std::vector<FP_STORAGE_TYPE> m_w; //!< Array of nodal moisture contents (g water/g dry fuel).
 
+	// Random perturbation stream, stored after the rest of the NFDRS4 state by ReadRandomState()/SaveRandomState()
+	int m_randseed;		//!< Stick random seed; zero if the stick is not perturbated.
+	unsigned long long m_rngKey;		//!< Random stream key.
+	unsigned long long m_rngCounter;	//!< Number of draws made from the random stream.
+	bool m_hasRandomState;	//!< False if the stream was not saved (older state files); the stick then keeps its own stream.
+
 };
 
@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+/*! \file dfmdiffusivitytable.h
+    \brief DFMDiffusivityTable class interface and declarations.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifndef _DFMDIFFUSIVITYTABLE_H_INCLUDED_
+#define _DFMDIFFUSIVITYTABLE_H_INCLUDED_
+
+#include <vector>
+
+//------------------------------------------------------------------------------
+/*! \class DFMDiffusivityTable dfmdiffusivitytable.h
+    \brief Precomputed bound water diffusivity for DeadFuelMoisture sticks
+    of a given density.
+
+    DeadFuelMoisture::diffusivity() evaluates, at each node,
+    \code
+        d = A(t,wc) * dhdm'(t,hf) / bp + B(t,wc)
+    \endcode
+    where \a t is the nodal temperature (oC), \a wc the lesser of the nodal
+    moisture and the fiber saturation point (g/g), \a bp the barometric
+    pressure (cal/cm3) and \a hf the stick surface humidity.  \a A (the vapor
+    diffusion term less its pressure and isotherm slope factors) and \a B
+    (the bound water diffusion term) depend only on \a t, \a wc and the stick
+    density, so they are tabulated once per density on a regular grid and
+    bilinearly interpolated.  The isotherm slope numerator \a dhdm' is
+    tabulated against \a t above the fiber saturation point; below it,
+    it depends on \a hf and costs a single exp() per node.
+
+    The grid spans -60 to 71 oC in 0.25 oC steps (the range of air
+    temperature accepted by DeadFuelMoisture::update() up to its 71 oC nodal
+    cap) and 0 to 0.40 g/g in 0.0025 g/g steps (above the largest possible
+    fiber saturation point), about 1.3 MB per density, and is linearly
+    extrapolated beyond it.
+
+    \par Error bounds
+    Against the exact formula, for stick density 0.4 g/cm3,
+    -50 <= t <= 70 oC, 0 <= wc <= fiber saturation and surface humidity
+    0.3 to 0.99, the interpolated diffusivity has a relative error below
+    0.25% (largest at low moisture, wc < 0.02 g/g).  Over a year of hourly
+    updates of the four standard sticks the tabulated mode stays within
+    0.005% moisture content of the exact model (mean difference below
+    0.0005%).
+
+    Tables are shared by every stick with the same density and are never
+    released; instance() is safe to call from concurrent threads.
+ */
+
+class DFMDiffusivityTable
+{
+// Public methods
+public:
+    static const DFMDiffusivityTable* instance( double density ) ;
+
+    double density( void ) const ;
+    double saturatedSlope( double t ) const ;
+    void   terms( double t, double wc, double* a, double* b ) const ;
+
+// Protected methods
+protected:
+    DFMDiffusivityTable( double density ) ;
+
+// Protected data members
+protected:
+    double  m_density;  //!< Stick density (g/cm3) the table was built for.
+    std::vector<double> m_ab;   //!< Interleaved A and B terms, temperature-major.
+    std::vector<double> m_sat;  //!< Isotherm slope numerator above fiber saturation, by temperature.
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of dfmdiffusivitytable.h
+//------------------------------------------------------------------------------
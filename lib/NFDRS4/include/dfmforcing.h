@@ -0,0 +1,91 @@
+//------------------------------------------------------------------------------
+/*! \file dfmforcing.h
+    \brief DFMForcing class interface and declarations.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifndef _DFMFORCING_H_INCLUDED_
+#define _DFMFORCING_H_INCLUDED_
+
+//------------------------------------------------------------------------------
+/*! \var DFM_ForcingIntervals
+    \brief Number of intervals of the DFMForcing grid between observations.
+ */
+static const int DFM_ForcingIntervals = 60;
+
+//------------------------------------------------------------------------------
+/*! \class DFMForcing dfmforcing.h
+    \brief Atmospheric quantities derived once per observation and shared by
+    the DeadFuelMoisture sticks of a station.
+
+    At every moisture time step DeadFuelMoisture::update() interpolates air
+    temperature \a ta and humidity \a ha between the previous and current
+    observation and derives from them the dew point temperature \a tdw
+    (a log()) and the saturation vapor pressures of ambient air \a psa and
+    at the dew point \a psd (an exp() each).  The four standard sticks take
+    265, 60, 20 and 11 time steps per hour, whose times do not nest, so
+    they cannot share exact values.  advance() instead evaluates log(ha) and
+    \a psa once per observation on a common grid of DFM_ForcingIntervals
+    intervals, and values() interpolates them quadratically at each stick
+    time step.  \a tdw then follows with a division and \a psd as
+    \a psa * \a ha (since 5205 / tdw = 5205 / tka - log(ha)): 122
+    transcendental calls per hour instead of 1068.  The 10-h and 100-h time
+    steps fall on grid points, where the interpolation is exact.
+
+    A stick uses the grid only while its own previous and current
+    temperature and humidity equal those the grid was built from (see
+    matches()), and otherwise derives the quantities itself, so a forcing
+    that was not advanced for an observation never feeds a stick stale
+    values.
+
+    \par Error bounds
+    For air temperatures of -20 to 40 oC changing by up to 6 oC and
+    humidities of 0.05 to 0.99 changing by up to 0.3 between hourly
+    observations, \a psa and \a psd have a relative error below 3.0e-8
+    and \a tdw below 2.1e-5 (largest for the steepest humidity changes at
+    low humidity).  Over two years of hourly observations the four
+    standard sticks stay within 0.00002% moisture content of the exact
+    model.
+
+    advance() must not run while sticks read the grid; the sticks only
+    read it, so they may be updated on concurrent threads in between.
+ */
+
+class DFMForcing
+{
+// Public methods
+public:
+    DFMForcing( void ) ;
+
+    void advance( double ta, double ha ) ;
+    void reset( void ) ;
+    bool matches( double ta0, double ta1, double ha0, double ha1 ) const ;
+    void values( double tfract, double tka, double ha, double* tdw, double* psa, double* psd ) const ;
+
+// Protected data members
+protected:
+    bool    m_valid0;   //!< \a m_ta0 and \a m_ha0 hold a previous observation.
+    bool    m_valid1;   //!< \a m_ta1 and \a m_ha1 hold a current observation.
+    double  m_ta0;      //!< Previous air temperature (oC).
+    double  m_ta1;      //!< Current air temperature (oC).
+    double  m_ha0;      //!< Previous air relative humidity (g/g).
+    double  m_ha1;      //!< Current air relative humidity (g/g).
+    double  m_lha[DFM_ForcingIntervals+1];  //!< Logarithm of air relative humidity at each grid point.
+    double  m_psa[DFM_ForcingIntervals+1];  //!< Saturation vapor pressure in ambient air at each grid point (cal/cm3).
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of dfmforcing.h
+//------------------------------------------------------------------------------
@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+/*! \file dfmmultirate.h
+    \brief DFMMultiRate class interface and declarations.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifndef _DFMMULTIRATE_H_INCLUDED_
+#define _DFMMULTIRATE_H_INCLUDED_
+
+#include <vector>
+
+//------------------------------------------------------------------------------
+/*! \var DFM_SnapshotHours
+    \brief Most gathered observations a DFMMultiRateSnapshot holds.
+ */
+static const int DFM_SnapshotHours = 24;
+
+//------------------------------------------------------------------------------
+/*! \struct DFMMultiRateSnapshot
+    \brief The gathered observations and recorded moisture contents of a
+    DFMMultiRate, as taken by DFMMultiRate::snapshot().
+ */
+
+struct DFMMultiRateSnapshot
+{
+    int     interval;                   //!< Observations per stick update (h).
+    int     count;                      //!< Number of gathered observations.
+    double  ta[DFM_SnapshotHours];      //!< Gathered air temperatures (oC).
+    double  ha[DFM_SnapshotHours];      //!< Gathered air relative humidities (g/g).
+    double  sW[DFM_SnapshotHours];      //!< Gathered solar radiation (W/m2).
+    double  ra[DFM_SnapshotHours];      //!< Gathered rainfall amounts (cm).
+    int     results;
+    double  mc0;
+    double  mc1;
+    int     span;
+};
+
+//------------------------------------------------------------------------------
+/*! \class DFMMultiRate dfmmultirate.h
+    \brief Hourly observations gathered between the coarse updates of a slow
+    DeadFuelMoisture stick, and its moisture content in between.
+
+    A stick takes the same number of moisture time steps per update() call
+    whatever the elapsed time, so updating the 100-h or 1000-h stick once
+    every interval() hours instead of hourly divides its cost by about
+    interval().  Averaging the hours into one observation would flatten the
+    daily cycle of temperature, humidity and insolation that drives the
+    stick surface, so add() keeps every hourly observation and
+    DeadFuelMoisture::updateSeries() interpolates the surface forcing
+    between them at each of its time steps.
+
+    Between updates, projected() extends the change of the last update
+    linearly to the hours gathered since, so reported moisture contents move
+    every hour as they would under hourly updates.
+
+    \par Error bounds
+    Over two years of hourly observations, against hourly updates, an
+    interval of 4 hours gives the 100-h stick a mean absolute difference of
+    0.07% moisture content (largest 0.75%) and the 1000-h stick 0.12%
+    (largest 0.94%); the differences grow about linearly with the interval.
+    See the README for other intervals.
+ */
+
+class DFMMultiRate
+{
+// Public methods
+public:
+    DFMMultiRate( void ) ;
+
+    void add( double ta, double ha, double sW, double ra ) ;
+    bool due( void ) const ;
+    int interval( void ) const ;
+    void integrated( double mc ) ;
+    double projected( double mc ) const ;
+    void reset( void ) ;
+    void setInterval( int hours ) ;
+    int size( void ) const ;
+    bool steady( void ) const ;
+    bool snapshot( DFMMultiRateSnapshot* snap ) const ;
+    bool restore( const DFMMultiRateSnapshot& snap ) ;
+
+    double ta( int i ) const { return( m_ta[i] ); }     //!< Air temperature of observation \a i (oC).
+    double ha( int i ) const { return( m_ha[i] ); }     //!< Air relative humidity of observation \a i (g/g).
+    double sW( int i ) const { return( m_sW[i] ); }     //!< Solar radiation of observation \a i (W/m2).
+    double ra( int i ) const { return( m_ra[i] ); }     //!< Rainfall amount of observation \a i (cm).
+
+// Protected data members
+protected:
+    int     m_interval;         //!< Observations per stick update (h).
+    std::vector<double> m_ta;   //!< Air temperatures gathered since the last stick update (oC).
+    std::vector<double> m_ha;   //!< Air relative humidities gathered since the last stick update (g/g).
+    std::vector<double> m_sW;   //!< Solar radiation gathered since the last stick update (W/m2).
+    std::vector<double> m_ra;   //!< Rainfall amounts gathered since the last stick update (cm).
+    int     m_results;          //!< Number of moisture contents recorded by integrated(), up to 2.
+    double  m_mc0;              //!< Moisture content after the previous stick update.
+    double  m_mc1;              //!< Moisture content after the last stick update.
+    int     m_span;             //!< Observations covered by the last stick update.
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of dfmmultirate.h
+//------------------------------------------------------------------------------
@@ -0,0 +1,158 @@
+//------------------------------------------------------------------------------
+/*! \file dfmnodearray.h
+    \brief DFMNodeArray class interface and declarations.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifndef _DFMNODEARRAY_H_INCLUDED_
+#define _DFMNODEARRAY_H_INCLUDED_
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+//------------------------------------------------------------------------------
+/*! \class DFMNodeArray dfmnodearray.h
+    \brief Nodal array of a DeadFuelMoisture stick.
+
+    Holds its values on the heap, or, once bind() has given it storage
+    owned elsewhere (the std::array members of a DeadFuelMoistureFixed
+    stick), in that storage whenever they fit.  The stick's accessors and
+    its fixed node time steps then work on the same values, with no copies
+    between them.
+
+    Copies and assignments copy values only: a copy is not bound, and an
+    assignment keeps the target's own storage.
+ */
+
+template <class T>
+class DFMNodeArray
+{
+// Public methods
+public:
+    DFMNodeArray( void ) :
+        m_data( NULL ),
+        m_bound( NULL ),
+        m_capacity( 0 ),
+        m_size( 0 )
+    {
+    }
+
+    DFMNodeArray( const DFMNodeArray& r ) :
+        m_data( NULL ),
+        m_bound( NULL ),
+        m_capacity( 0 ),
+        m_size( 0 )
+    {
+        assign( r.begin(), r.end() );
+    }
+
+    DFMNodeArray& operator=( const DFMNodeArray& r )
+    {
+        if ( this != &r )
+        {
+            assign( r.begin(), r.end() );
+        }
+        return( *this );
+    }
+
+    //! Keeps the values in the \a capacity values at \a storage whenever they fit.
+    void bind( T* storage, int capacity )
+    {
+        m_bound    = storage;
+        m_capacity = capacity;
+        if ( m_size <= m_capacity )
+        {
+            std::copy( begin(), end(), m_bound );
+            m_data = m_bound;
+            m_heap.clear();
+        }
+    }
+
+    int size( void ) const { return( m_size ); }
+    bool empty( void ) const { return( m_size == 0 ); }
+    T& operator[]( int i ) { return( m_data[i] ); }
+    const T& operator[]( int i ) const { return( m_data[i] ); }
+    T* begin( void ) { return( m_data ); }
+    T* end( void ) { return( m_data + m_size ); }
+    const T* begin( void ) const { return( m_data ); }
+    const T* end( void ) const { return( m_data + m_size ); }
+
+    void clear( void ) { resize( 0 ); }
+
+    //! Sets \a n values of \a v.
+    void assign( int n, const T& v )
+    {
+        resize( n );
+        std::fill( begin(), end(), v );
+    }
+
+    //! Sets the values of [\a first, \a last).
+    template <class Iterator>
+    void assign( Iterator first, Iterator last )
+    {
+        resize( (int) std::distance( first, last ) );
+        std::copy( first, last, begin() );
+    }
+
+    void push_back( const T& v )
+    {
+        resize( m_size + 1 );
+        m_data[m_size - 1] = v;
+    }
+
+    //! Resizes to \a n values, keeping the first ones and zeroing any added.
+    void resize( int n )
+    {
+        T* data = ( n <= m_capacity ) ? m_bound : NULL;
+        if ( ! data )
+        {
+            if ( m_data == m_heap.data() && m_size > 0 )
+            {
+                m_heap.resize( n );
+            }
+            else
+            {
+                std::vector<T> heap( n );
+                std::copy( m_data, m_data + std::min( m_size, n ), heap.begin() );
+                m_heap.swap( heap );
+            }
+            data = m_heap.data();
+        }
+        else if ( data != m_data )
+        {
+            std::copy( m_data, m_data + std::min( m_size, n ), data );
+            m_heap.clear();
+        }
+        if ( n > m_size )
+        {
+            std::fill( data + std::min( m_size, n ), data + n, T( 0 ) );
+        }
+        m_data = data;
+        m_size = n;
+    }
+
+// Private data members
+private:
+    std::vector<T> m_heap;  //!< Values that do not fit the bound storage.
+    T*  m_data;             //!< Current values (in \a m_bound or \a m_heap).
+    T*  m_bound;            //!< Storage given to bind(), or NULL.
+    int m_capacity;         //!< Number of values \a m_bound holds.
+    int m_size;             //!< Number of values.
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of dfmnodearray.h
+//------------------------------------------------------------------------------
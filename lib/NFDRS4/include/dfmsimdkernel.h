@@ -0,0 +1,321 @@
+//------------------------------------------------------------------------------
+/*! \file dfmsimdkernel.h
+    \brief DFMSimd kernels, written once for every instruction set.
+
+    Included by the DFMSimd sources only.  Each defines, in an anonymous
+    namespace so that nothing compiled for a wider instruction set can be
+    shared with the rest of the program, a vector type \a V with
+    - V::Lanes, the number of doubles per vector, and V::Mask;
+    - V::set(), V::load() and V::store();
+    - operators +, -, * and /, and V::min(), V::max(), V::sqrt();
+    - V::lt(), V::gt(), V::ne(), V::both() and V::select() on masks;
+    - V::pow2(k), the power of two 2^(k - 1.5*2^52) for integral k - 1.5*2^52;
+    - V::split(a, &e, &m), a = m * 2^e with 1 <= m < 2 for normal a > 0;
+
+    and instantiates dfmDiffusivity<V>() and dfmIndexes<V>().  The operations are IEEE
+    arithmetic without fused multiply-adds, so every \a V gives identical
+    results.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifndef _DFMSIMDKERNEL_H_INCLUDED_
+#define _DFMSIMDKERNEL_H_INCLUDED_
+
+#include "dfmsimd.h"
+
+// 1.5 * 2^52: adding it rounds a double below 2^51 to an integer
+static const double DFMSimdRound = 6755399441055744.0;
+
+//------------------------------------------------------------------------------
+/*! \brief Natural exponential of each lane of \a x.
+
+    Reduces \a x to r = x - n ln(2), |r| <= ln(2)/2, and sums the Taylor
+    series of exp(r) to r^13 (truncation error below 4e-18) by Estrin's
+    scheme, whose short dependency chains keep the vector units busy.
+    Arguments below -708 give 0, above 709 give exp(709).
+ */
+
+template <class V>
+inline V dfmExp( const V& x )
+{
+    const V lo = V::set( -708. );
+    const V xc = V::min( V::max( x, lo ), V::set( 709. ) );
+    const V k  = xc * V::set( 1.4426950408889634 ) + V::set( DFMSimdRound );
+    const V n  = k - V::set( DFMSimdRound );
+    // ln(2) split so that n * 6.93145751953125E-1 is exact (Cody and Waite)
+    const V r  = ( xc - n * V::set( 6.93145751953125E-1 ) )
+                      - n * V::set( 1.42860682030941723212E-6 );
+    const V r2 = r * r;
+    const V r4 = r2 * r2;
+    const V p0 = ( V::set( 1. ) + r )
+               + ( V::set( 0.5 ) + V::set( 1. / 6. ) * r ) * r2;
+    const V p1 = ( V::set( 1. / 24. ) + V::set( 1. / 120. ) * r )
+               + ( V::set( 1. / 720. ) + V::set( 1. / 5040. ) * r ) * r2;
+    const V p2 = ( V::set( 1. / 40320. ) + V::set( 1. / 362880. ) * r )
+               + ( V::set( 1. / 3628800. ) + V::set( 1. / 39916800. ) * r ) * r2;
+    const V p3 = V::set( 1. / 479001600. ) + V::set( 1. / 6227020800. ) * r;
+    const V p  = ( p0 + p1 * r4 ) + ( p2 + p3 * r4 ) * ( r4 * r4 );
+    return( V::select( V::lt( x, lo ), V::set( 0. ), p * V::pow2( k ) ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Natural logarithm of each lane of \a a, a positive normal number.
+
+    Splits \a a into m 2^e with sqrt(1/2) < m <= sqrt(2) and sums the
+    series log(m) = 2 atanh(z), z = (m-1)/(m+1), to z^23 (truncation error
+    below 1e-18) by Estrin's scheme.
+ */
+
+template <class V>
+inline V dfmLog( const V& a )
+{
+    const V one = V::set( 1. );
+    V e, m;
+    V::split( a, &e, &m );
+    typename V::Mask big = V::gt( m, V::set( 1.4142135623730951 ) );
+    m = V::select( big, m * V::set( 0.5 ), m );
+    e = V::select( big, e + one, e );
+    const V z  = ( m - one ) / ( m + one );
+    const V z2 = z * z;
+    const V z4 = z2 * z2;
+    const V p0 = ( one + V::set( 1. / 3. ) * z2 )
+               + ( V::set( 1. / 5. ) + V::set( 1. / 7. ) * z2 ) * z4;
+    const V p1 = ( V::set( 1. / 9. ) + V::set( 1. / 11. ) * z2 )
+               + ( V::set( 1. / 13. ) + V::set( 1. / 15. ) * z2 ) * z4;
+    const V p2 = ( V::set( 1. / 17. ) + V::set( 1. / 19. ) * z2 )
+               + ( V::set( 1. / 21. ) + V::set( 1. / 23. ) * z2 ) * z4;
+    const V z8 = z4 * z4;
+    const V p  = p0 + ( p1 + p2 * z8 ) * z8;
+    return( e * V::set( 6.93145751953125E-1 )
+        + ( e * V::set( 1.42860682030941723212E-6 ) + V::set( 2. ) * z * p ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Bound water diffusivity of \a nodes nodes, a multiple of V::Lanes.
+
+    Same formula as DeadFuelMoisture::diffusivityNodes(), except that the
+    vapor diffusivity power, saturation vapor pressure exponential and
+    isotherm slope power of the vapor term are multiplied as a single
+    exp() of the sum of their logarithms.
+
+    \param[in]  in    Quantities shared by all nodes.
+    \param[in]  nodes Number of nodes.
+    \param[in]  t     Nodal temperatures (oC).
+    \param[in]  w     Nodal moisture contents (g/g).
+    \param[out] d     Nodal bound water diffusivities (cm2/h).
+ */
+
+template <class V>
+inline void dfmDiffusivity( const DFMSimdDiffusivity& in, int nodes,
+        const double* t, const double* w, double* d )
+{
+    const V one  = V::set( 1. );
+    const V zero = V::set( 0. );
+    const V kel  = V::set( 273.2 );
+    const V wsa  = V::set( in.wsa );
+    const V rden = V::set( 1.0 / in.density );
+    for ( int i=0; i<nodes; i+=V::Lanes )
+    {
+        const V tn = V::load( t + i );
+        const V wn = V::load( w + i );
+        // Stick temperature (oK)
+        V tk  = tn + kel;
+        // Latent heat of vaporization of water (cal/mol)
+        V qv  = V::set( 13550. ) - V::set( 10.22 ) * tk;
+        // Specific heat of water vapor (cal/(mol*K))
+        V cpv = V::set( 7.22 ) + V::set( .002374 ) * tk + V::set( 2.67e-07 ) * tk * tk;
+        // Emc sorption isotherm parameters (g/g)
+        V c1  = V::set( 0.1617 ) - V::set( 0.001419 ) * tn;
+        V c2  = V::set( 0.4657 ) + V::set( 0.003578 ) * tn;
+        // Lesser of nodal or fiber saturation moisture (g/g)
+        typename V::Mask below = V::lt( wn, wsa );
+        V wc  = V::select( below, wn, wsa );
+        // Vapor diffusivity times the water saturation vapor pressure at
+        // the node temperature (cal/cm3) times the reciprocal slope of the
+        // sorption isotherm
+        V vapor = V::set( 1.75 ) * dfmLog( tk / kel )
+            + ( V::set( 20.58 ) - ( V::set( 5205. ) / tk ) )
+            + ( one - c2 ) * V::select( below, V::set( in.hfLog ), V::set( in.satLog ) );
+        V slope = V::set( in.dv0 * 0.0000239 )
+            * V::select( below, V::set( in.hf1 ), V::set( in.sat1 ) )
+            * dfmExp( vapor ) / ( c1 * c2 );
+        typename V::Mask valid = V::both( V::ne( c2, one ),
+            V::both( V::ne( c1, zero ), V::ne( c2, zero ) ) );
+        V dvps = V::select( valid, slope, zero );
+        // Density of adsorbed water (g/cm3)
+        V daw  = V::set( 1.3 ) - V::set( 0.64 ) * wc;
+        // Specific volume of adsorbed water (cm3/g)
+        V svaw = one / daw;
+        // Volume fraction of adborbed water (dl)
+        V vfaw = svaw * wc / ( V::set( 0.685 ) + svaw * wc );
+        // Volume fraction of moist cell wall (dl)
+        V vfcw = ( V::set( 0.685 ) + svaw * wc ) / ( rden + svaw * wc );
+        // Converts D from wood substance to whole wood basis
+        V rfcw = one - V::sqrt( one - vfcw );
+        V fac  = one / ( rfcw * vfcw );
+        // Correction for tortuous paths in cell wall
+        V con  = one / ( V::set( 2.0 ) - vfaw );
+        // Differential heat of sorption of water (cal/mol)
+        V qw   = V::set( 5040. ) * dfmExp( V::set( -14.0 ) * wc );
+        // Activation energy for bound water diffusion (cal/mol)
+        V e    = ( qv + qw - cpv * tk ) / V::set( 1.2 );
+        V dvpr = V::set( 18.0 * 0.016 ) * ( one - vfcw ) * dvps
+               / ( V::set( in.density * 1.987 ) * tk );
+        V::store( d + i, dvpr + V::set( 3600. * 0.0985 ) * con * fac
+            * dfmExp( ( zero - e ) / ( V::set( 1.987 ) * tk ) ) );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief \a a to the power \a b in each lane, 0 where \a a is not
+    positive (for b > 0, as in the fire behavior formulas).
+ */
+
+template <class V>
+inline V dfmPow( const V& a, const V& b )
+{
+    typename V::Mask positive = V::gt( a, V::set( 0. ) );
+    return( V::select( positive,
+        dfmExp( b * dfmLog( V::select( positive, a, V::set( 1. ) ) ) ), V::set( 0. ) ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief \a x clamped to [0, 1] in each lane.
+ */
+
+template <class V>
+inline V dfmUnit( const V& x )
+{
+    const V lo = V::select( V::lt( x, V::set( 0. ) ), V::set( 0. ), x );
+    return( V::select( V::gt( lo, V::set( 1. ) ), V::set( 1. ), lo ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief NFDRS4 indexes of \a records records, a multiple of V::Lanes,
+    on one fuel bed.
+
+    Same formula as the per record part of NFDRS4CalcIndexes(), with its
+    integral powers multiplied out, pow(x, 0.5) as a square root and
+    divisions by fuel bed constants as multiplications by their
+    reciprocals.
+
+    \param[in]  bed     Fuel bed quantities shared by all records.
+    \param[in]  records Number of records.
+    \param[in]  in      Input arrays, in DFMSimdIndexInput order.
+    \param[out] out     Output arrays, in DFMSimdIndexOutput order.
+ */
+
+template <class V>
+inline void dfmIndexes( const DFMSimdIndexBed& bed, int records,
+        const double* const* in, double* const* out )
+{
+    const V one  = V::set( 1. );
+    const V zero = V::set( 0. );
+    const V mxd  = V::set( bed.mxd );
+    const V rmxd = V::set( 1. / bed.mxd );
+    const V hund = V::set( 100. );
+    for ( int i=0; i<records; i+=V::Lanes )
+    {
+        const V mc1    = V::load( in[DFM_IndexMC1] + i );
+        const V mc10   = V::load( in[DFM_IndexMC10] + i );
+        const V mc100  = V::load( in[DFM_IndexMC100] + i );
+        const V mc1000 = V::load( in[DFM_IndexMC1000] + i );
+        const V mcherb = V::load( in[DFM_IndexMCHERB] + i );
+        const V mcwood = V::load( in[DFM_IndexMCWOOD] + i );
+        const V ws     = V::load( in[DFM_IndexWS] + i );
+        const V tmpprm = V::load( in[DFM_IndexFuelTemp] + i );
+        // Live fuel moisture of extinction (%)
+        V mxl = zero;
+        if ( bed.live )
+        {
+            V mclfe = ( ( mc1 * V::set( bed.hn1 ) ) + ( mc10 * V::set( bed.hn10 ) )
+                + ( mc100 * V::set( bed.hn100 ) ) ) * V::set( 1. / bed.hnSum );
+            mxl = ( V::set( bed.wrat ) * ( one - mclfe * rmxd ) - V::set( 0.226 ) ) * hund;
+        }
+        mxl = V::select( V::lt( mxl, mxd ), mxd, mxl );
+        const V rmxl = one / mxl;
+        // Moisture damping coefficients, surface area weighted
+        V wtmcd = ( V::set( bed.f1 ) * mc1 ) + ( V::set( bed.f10 ) * mc10 )
+            + ( V::set( bed.f100 ) * mc100 );
+        V wtmcl = ( V::set( bed.fherb ) * mcherb ) + ( V::set( bed.fwood ) * mcwood );
+        V dedrt = wtmcd * rmxd;
+        V livrt = wtmcl * rmxl;
+        V etamd = dfmUnit( one - V::set( 2.59 ) * dedrt + V::set( 5.11 ) * ( dedrt * dedrt )
+            - V::set( 3.52 ) * ( dedrt * dedrt * dedrt ) );
+        V etaml = dfmUnit( one - V::set( 2.59 ) * livrt + V::set( 5.11 ) * ( livrt * livrt )
+            - V::set( 3.52 ) * ( livrt * livrt * livrt ) );
+        // Reaction intensity and wind factor
+        V ir    = V::set( bed.gmaop )
+            * ( ( V::set( bed.ird ) * etamd ) + ( V::set( bed.irl ) * etaml ) );
+        V ir9   = V::set( 0.9 ) * ir;
+        V wind  = ws * V::set( 88.0 ) * V::set( bed.wndfc );
+        V phiwnd = V::set( bed.ufact )
+            * dfmPow( V::select( V::gt( wind, ir9 ), ir9, wind ), V::set( bed.b ) );
+        // Heat sink and spread component
+        V htsink = V::set( bed.rhobed ) * ( V::set( bed.fdead )
+            * ( V::set( bed.xf1 ) * ( V::set( 250.0 ) + V::set( 11.16 ) * mc1 )
+              + V::set( bed.xf10 ) * ( V::set( 250.0 ) + V::set( 11.16 ) * mc10 )
+              + V::set( bed.xf100 ) * ( V::set( 250.0 ) + V::set( 11.16 ) * mc100 ) )
+            + V::set( bed.flive )
+            * ( V::set( bed.xfherb ) * ( V::set( 250.0 ) + V::set( 11.16 ) * mcherb )
+              + V::set( bed.xfwood ) * ( V::set( 250.0 ) + V::set( 11.16 ) * mcwood ) ) );
+        V sc = ir * V::set( bed.zeta ) * ( V::set( bed.slope1 ) + phiwnd ) / htsink;
+        // Moisture damping coefficients, loading weighted
+        V wtmcde = ( V::set( bed.f1e ) * mc1 ) + ( V::set( bed.f10e ) * mc10 )
+            + ( V::set( bed.f100e ) * mc100 ) + ( V::set( bed.f1000e ) * mc1000 );
+        V wtmcle = ( V::set( bed.fherbe ) * mcherb ) + ( V::set( bed.fwoode ) * mcwood );
+        V dedrte = wtmcde * rmxd;
+        V livrte = wtmcle * rmxl;
+        V etamde = dfmUnit( one - V::set( 2.0 ) * dedrte + V::set( 1.5 ) * ( dedrte * dedrte )
+            - V::set( 0.5 ) * ( dedrte * dedrte * dedrte ) );
+        V etamle = dfmUnit( one - V::set( 2.0 ) * livrte + V::set( 1.5 ) * ( livrte * livrte )
+            - V::set( 0.5 ) * ( livrte * livrte * livrte ) );
+        // Energy release component and burning index
+        V ire = V::set( bed.gmaope )
+            * ( ( V::set( bed.ired ) * etamde ) + ( V::set( bed.irel ) * etamle ) );
+        V erc = V::set( 0.04 ) * ire * V::set( bed.tau );
+        V bi  = ( V::set( .301 ) * dfmPow( sc * erc, V::set( 0.46 ) ) ) * V::set( 10.0 );
+        // Ignition component, from the heat of ignition at the fuel surface temperature
+        V qign = V::set( 144.5 ) - ( V::set( 0.266 ) * tmpprm )
+            - ( V::set( 0.00058 ) * tmpprm * tmpprm ) - ( V::set( 0.01 ) * tmpprm * mc1 )
+            + V::set( 18.54 ) * ( one - dfmExp( V::set( -0.151 ) * mc1 ) )
+            + V::set( 6.4 ) * mc1;
+        V chi = ( V::set( 344.0 ) - qign ) * V::set( 0.1 );
+        V p   = dfmPow( chi, V::set( 3.66 ) ) * V::set( 0.000923 / 50.0 );
+        V pi  = ( p - V::set( 0.00232 ) ) * V::set( 100.0 / 0.99767 );
+        pi = V::select( V::lt( pi, zero ), zero, pi );
+        pi = V::select( V::gt( pi, hund ), hund, pi );
+        V scn = sc * V::set( 100.0 / bed.scm );
+        scn = V::select( V::gt( scn, hund ), hund, scn );
+        V ic  = V::set( 0.10 ) * pi * V::sqrt( scn );
+        ic = V::select( V::both( V::lt( qign, V::set( 344.0 ) ),
+            V::gt( p, V::set( 0.00232 ) ) ), ic, zero );
+        ic = V::select( V::lt( sc, V::set( 0.00001 ) ), zero, ic );
+        V::store( out[DFM_IndexSC] + i, sc );
+        V::store( out[DFM_IndexERC] + i, erc );
+        V::store( out[DFM_IndexBI] + i, bi );
+        V::store( out[DFM_IndexIC] + i, ic );
+        V::store( out[DFM_IndexWTMCD] + i, wtmcd );
+        V::store( out[DFM_IndexWTMCL] + i, wtmcl );
+        V::store( out[DFM_IndexWTMCDE] + i, wtmcde );
+        V::store( out[DFM_IndexWTMCLE] + i, wtmcle );
+    }
+    return;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of dfmsimdkernel.h
+//------------------------------------------------------------------------------
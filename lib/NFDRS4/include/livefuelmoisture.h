@@ -4,6 +4,7 @@
 #include <vector>
 #include <deque>
 #include "lfmcalcstate.h"
+#include "nfdrs4rollingwindow.h"
 
 #define NOVALUE -9999.9
 #define RADPERDAY 0.017214
@@ -20,6 +21,25 @@
     <i>Glob. Chan. Biol.</i> 11<b>(4)</b>: 619-632.
  */
 
+// Longest GSI averaging period an LFMSnapshot holds (days)
+static const int LFM_SnapshotDays = 60;
+
+//------------------------------------------------------------------------------
+/*! \struct LFMSnapshot
+    \brief The dynamic state of a LiveFuelMoisture model, as taken by
+    LiveFuelMoisture::GetSnapshot().  Flat and trivially copyable; the model
+    parameters are not part of it.
+ */
+struct LFMSnapshot
+{
+	NFDRS4RollingWindowSnapshot<LFM_SnapshotDays> GSI;	// Daily GSI of the averaging period
+	double lastHerbFM;
+	time_t lastUpdateTime;
+	bool hasGreenedUpThisYear;
+	bool hasExceeded120ThisYear;
+	bool canIncreaseHerb;
+};
+
 //------------------------------------------------------------------------------
 /*! \class LiveFuelMoisture LiveFuelMoisture.h
     \brief Determines moisture content of live herbaceous and woody fuels
@@ -39,6 +59,7 @@ class LiveFuelMoisture
         void SetLimits(double,double,double,double, double, double, double, double);
 		void Update(double TempF, double MaxTempF, double MinTempF, double RH, double minRH, int Jday, double RTPrcp, time_t thisTime);
         void SetMAPeriod(unsigned int MAPeriod);
+        int GetMAPeriod();
         void SetLFMParameters(double MaxGSI,double GreenupThreshold,double MinLFMVal, double MaxLFMVal);
         void GetLFMParameters(double * MaxGSI,double * GreenupThreshold ,double * MinLFMVal, double * MaxLFMVal);
 		void SetNumPrecipDays(int numDays);
@@ -71,6 +92,8 @@ class LiveFuelMoisture
 		bool GetIsAnnual();
 		LFMCalcState GetState();
 		bool SetState(LFMCalcState state);
+		bool GetSnapshot(LFMSnapshot* Snap);
+		bool SetSnapshot(const LFMSnapshot& Snap);
 
         void SetUseRTPrecip(bool set);
         bool GetUseRTPrecip();
@@ -80,7 +103,7 @@ class LiveFuelMoisture
         bool m_IsAnnual;
         int m_LFIdaysAvg;
         double m_Lat;
-		std::deque<double> qGSI;
+		NFDRS4RollingWindow qGSI;	// Daily GSI of the last m_LFIdaysAvg days
         double m_TminMin;
         double m_TminMax;
         double m_VPDMin;
@@ -15,10 +15,15 @@
 #include <numeric>
 #include <algorithm>
 #include <deque>
+#include <memory>
+#include <type_traits>
 #include <unordered_map>
-#include "deadfuelmoisture.h"
+#include "deadfuelmoisturefixed.h"
 #include "livefuelmoisture.h"
 #include "nfdrs4calcstate.h"
+#include "nfdrs4indexes.h"
+#include "nfdrs4rollingwindow.h"
+#include "nfdrs4stickpipeline.h"
 #include "utctime.h"
 
 /*Fuel Model Definition*/
@@ -152,6 +157,114 @@ Functions:
 
 ***************************************************************************/
 
+/// Day of the year (1-366) of a date whose month is 0 based
+int CalcJulianDay(int year, int month, int day);
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4Observation
+    \brief One hourly weather observation, as passed to NFDRS4::Update(),
+    for NFDRS4::Run().
+*/
+struct NFDRS4Observation
+{
+	int Year;
+	int Month;
+	int Day;
+	int Hour;
+	double Temp;		// Hourly temperature (deg F)
+	double RH;			// Hourly relative humidity (%)
+	double PPTAmt;		// Hourly precipitation amount (inches)
+	double SolarRad;	// Hourly solar radiation (W/m2)
+	double WS;			// Hourly windspeed (mph)
+	bool SnowDay;		// Snow flag
+};
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4DailyWeather
+    \brief 24 hour weather and regular observation hour given to the 16
+    argument NFDRS4::Update(), in place of those the calculator keeps itself.
+*/
+struct NFDRS4DailyWeather
+{
+	double MinTemp;		// Minimum temperature of the last 24 hours (deg F)
+	double MaxTemp;		// Maximum temperature of the last 24 hours (deg F)
+	double MinRH;		// Minimum relative humidity of the last 24 hours (%)
+	double pcp24;		// Precipitation of the last 24 hours (inches)
+	int RegObsHr;		// Regular observation hour
+};
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4Outputs
+    \brief Caller provided output arrays for NFDRS4::Run(), one element per
+    observation.  Outputs left NULL are not written.
+*/
+struct NFDRS4Outputs
+{
+	double* MC1 = NULL;
+	double* MC10 = NULL;
+	double* MC100 = NULL;
+	double* MC1000 = NULL;
+	double* MCHERB = NULL;
+	double* MCWOOD = NULL;
+	double* FuelTemperature = NULL;
+	double* BI = NULL;
+	double* ERC = NULL;
+	double* SC = NULL;
+	double* IC = NULL;
+	double* GSI = NULL;
+	int* KBDI = NULL;
+	int IndexHour = -1;		// If 0-23, BI, ERC, SC and IC are only written for observations at this hour
+	double* ModelBI = NULL;		// Indexes of the NFDRS4::SetFuelModels() models, NFDRS4::GetNumFuelModels()
+	double* ModelERC = NULL;	// elements per observation, in the order of the models
+	double* ModelSC = NULL;
+	double* ModelIC = NULL;
+};
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4ModelIndexes
+    \brief One of the fuel models of NFDRS4::SetFuelModels(), with its
+    compiled fuel, fuel bed cache and indexes after the last update.
+*/
+struct NFDRS4ModelIndexes
+{
+	char FuelModel;
+	std::shared_ptr<const NFDRS4CompiledFuel> Fuel;
+	NFDRS4IndexBedCache Cache;
+	double SC = 0, ERC = 0, BI = 0, IC = 0;
+};
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4Snapshot
+    \brief The complete dynamic state of an NFDRS4 station, its dead fuel
+    sticks and live fuel models, as taken by NFDRS4::Snapshot().
+
+    A snapshot is flat and trivially copyable, so it can be copied with
+    memcpy(), kept in arrays and passed between threads.  Restoring it with
+    NFDRS4::Restore() does not allocate.  Settings such as the fuel model,
+    latitude, stick parameters and update intervals are not part of it.
+*/
+struct NFDRS4Snapshot
+{
+	DFMSnapshot OneHour, TenHour, HundredHour, ThousandHour;
+	DFMMultiRateSnapshot HundredHourRate, ThousandHourRate;
+	DFMForcing Forcing;
+	LFMSnapshot Herb, Woody;
+	NFDRS4RollingWindowSnapshot<90> Precip;		// NFDRS4::nPrecipQueueDays days
+	NFDRS4RollingWindowSnapshot<24> HourlyPrecip, HourlyTemp, HourlyRH;	// NFDRS4::nHoursPerDay hours
+	utctime::UTCTime LastUtcUpdateTime, LastDailyUpdateTime;
+	double MC1, MC10, MC100, MC1000, MCWOOD, MCHERB, FuelTemperature;
+	double BI, ERC, SC, IC;
+	double W1, W10, W100, W1000, WWOOD, WHERB, WDROUGHT, W1P, WHERBP, WTOT;
+	double DroughtUnit, fctCur;
+	double WTMCD, WTMCL, WTMCDE, WTMCLE;
+	double CummPrecip, GSI;
+	int KBDI, YKBDI, PrevYear, YesterdayJDay, nConsectiveSnowDays, RegObsHour;
+	int PendingIndexes, PendingWS, PendingSlopeCls;
+	bool SnowCovered;
+};
+
+static_assert(std::is_trivially_copyable<NFDRS4Snapshot>::value, "NFDRS4Snapshot must be trivially copyable");
+
 //------------------------------------------------------------------------------
 /*! \class NFDRS4
     \brief Main calculator for the US National Fire Danger Rating System components
@@ -184,7 +297,7 @@ class NFDRS4
         NFDRS4(double Lat,char FuelModel,int SlopeClass, double AvgAnnPrecip,bool LT,bool Cure, bool IsAnnual);
         ~NFDRS4();
         // Member functions
-		//CreateFuelModels called in constructors
+		//CreateFuelModels called in constructors; shares the standard fuel models
 		void CreateFuelModels();
 
 		/// @brief NFDRS4 class initialization function.
@@ -221,11 +334,54 @@ class NFDRS4
 		/// /// @return None
 		/// 
        void Update(int Year, int Month, int Day, int Hour, double Temp, double RH, double PPTAmt, double SolarRad, double WS, bool SnowDay);
+		/// @brief NFDRS4 class series update function
+		/// Runs Update() for each of a series of hourly observations and stores the requested outputs of each.
+		///
+		/// @param Obs Array of hourly observations, in time order
+		/// @param nObs Number of observations
+		/// @param Out Output arrays of at least nObs elements (NULL outputs are skipped)
+		/// @return Number of observations processed
+		///
+       int Run(const NFDRS4Observation* Obs, int nObs, const NFDRS4Outputs& Out);
+       int RunParallelSticks(const NFDRS4Observation* Obs, int nObs, const NFDRS4Outputs& Out);
+       void UpdateIndexes(int iWS);
        void UpdateDaily(int Year, int Month, int Day, int Julian, double Temp, double MinTemp, double MaxTemp, double RH, double MinRH, double pcp24, double WS, double fMC1, double fMC10, double fMC100, double fMC1000, double fuelTemp, bool SnowDay/* = false*/);
  		bool iSetFuelModel(char cFM);
         int iSetFuelMoistures (double fMC1, double fMC10,double fMC100, double fMC1000, double fMCWood, double fMCHerb, double fuelTempC);
 		int iCalcIndexes(int iWS, int iSlopeCls, double* fSC, double* fERC, double* fBI, double* fIC, double fGSI = -999, double fKBDI = -999);
 		int iCalcIndexes(int iWS, int iSlopeCls, double fGSI = -999, double fKBDI = -999);
+		/// @brief Calculates SC, BI and IC of the current fuel moistures over a table of wind speeds and slope classes.
+		/// Each cell equals what iCalcIndexes() with that wind speed and slope class would give, but the terms that
+		/// depend on neither are computed once for the table.  The station's indexes and loads are left unchanged.
+		///
+		/// @param nWinds Number of wind speeds
+		/// @param iWS Wind speeds (mph); columns of negative speeds are not written
+		/// @param nSlopes Number of slope classes
+		/// @param iSlopeCls Slope classes (1-5); rows of other classes are not written
+		/// @param fSC, fBI, fIC Tables of at least nSlopes * nWinds elements, the wind speeds of the first slope class first (NULL tables are skipped)
+		/// @param fGSI, fKBDI As for iCalcIndexes(), but fGSI is not kept
+		/// @return Number of cells computed
+		///
+		int iCalcIndexSweep(int nWinds, const int* iWS, int nSlopes, const int* iSlopeCls, double* fSC, double* fBI, double* fIC, double fGSI = -999, double fKBDI = -999);
+		NFDRS4FuelBed GetFuelBed();
+
+		enum IndexFlags { IndexSC = 1, IndexERC = 2, IndexBI = 4, IndexIC = 8, AllIndexes = 15 };
+		/// @brief Defers the index calculations of Update() and UpdateDaily() to the first read of each index.
+		/// While set, an update only advances the fuel moistures, and GetSC(), GetERC(), GetBI() and GetIC()
+		/// calculate their index from the state the update left, skipping the spread component stage when
+		/// only ERC is read and the ignition stage when IC is not.  The values equal those of eager updates,
+		/// but the SC, ERC, BI and IC members are only current once read through the getters or
+		/// CalcPendingIndexes().
+		///
+		/// @param Lazy true to defer, false (the default) to calculate all indexes on every update
+		///
+		void SetLazyIndexes(bool Lazy);
+		bool GetLazyIndexes();
+		void CalcPendingIndexes(int Indexes = AllIndexes);
+		double GetSC();
+		double GetERC();
+		double GetBI();
+		double GetIC();
 		int iCalcKBDI (double fPrecipAmt, int iMaxTemp,double fCummPrecip, int iYKBDI, double fAvgPrecip);
 		double Cure(double fGSI = -999, double fGreenupThreshold = 0.5, double fGSIMax = 1.0);
 
@@ -250,21 +406,63 @@ class NFDRS4
         void Set1HourStickDensity(double stickDensity);
         void Set1HourMaxLocalMoisture(double maxLocalMoisture);
         void Set1HourDesorptionRate(double desorptionRate);
+        void Set1HourTabulatedDiffusivity(bool tabulated);
+        void Set1HourSimdDiffusivity(bool simd);
+        void Set1HourEquilibriumSkip(bool skip);
+        void Set1HourImplicitSolver(bool implicit, int moistureSteps);
         void Set10HourRadius(double radius);
         void Set10HourAdsorptionRate(double adsorptionRate);
         void Set10HourStickDensity(double stickDensity);
         void Set10HourMaxLocalMoisture(double maxLocalMoisture);
         void Set10HourDesorptionRate(double desorptionRate);
+        void Set10HourTabulatedDiffusivity(bool tabulated);
+        void Set10HourSimdDiffusivity(bool simd);
+        void Set10HourEquilibriumSkip(bool skip);
+        void Set10HourImplicitSolver(bool implicit, int moistureSteps);
         void Set100HourRadius(double radius);
         void Set100HourAdsorptionRate(double adsorptionRate);
         void Set100HourStickDensity(double stickDensity);
         void Set100HourMaxLocalMoisture(double maxLocalMoisture);
         void Set100HourDesorptionRate(double desorptionRate);
+        void Set100HourTabulatedDiffusivity(bool tabulated);
+        void Set100HourSimdDiffusivity(bool simd);
+        void Set100HourEquilibriumSkip(bool skip);
+        void Set100HourImplicitSolver(bool implicit, int moistureSteps);
         void Set1000HourRadius(double radius);
         void Set1000HourAdsorptionRate(double adsorptionRate);
         void Set1000HourStickDensity(double stickDensity);
         void Set1000HourMaxLocalMoisture(double maxLocalMoisture);
         void Set1000HourDesorptionRate(double desorptionRate);
+        void Set1000HourTabulatedDiffusivity(bool tabulated);
+        void Set1000HourSimdDiffusivity(bool simd);
+        void Set1000HourEquilibriumSkip(bool skip);
+        void Set1000HourImplicitSolver(bool implicit, int moistureSteps);
+        void SetDeadFuelRandomSeed(int randseed, std::string stationID = "");
+        /// @brief Shares the atmospheric quantities of each Update() among the four dead fuel sticks.
+        /// The dew point and saturation vapor pressures are derived once per hour on a common grid and
+        /// interpolated by each stick (see DFMForcing), instead of at every stick time step.
+        /// Moisture contents then differ from the default by less than 0.0001%.
+        /// @param shared true to share the forcing, false (the default) for each stick to derive it
+        void SetSharedForcing(bool shared);
+        bool GetSharedForcing();
+        /// @brief Runs each dead fuel stick on its own persistent thread in Run().
+        /// The sticks run ahead of the index calculations over windows of hours, and each hour's
+        /// indexes are computed once all four sticks are done with it. Results are unchanged.
+        /// Meant for long single station runs; Update() is not affected.
+        /// @param parallel true to run the sticks in parallel, false (the default) to stop the threads
+        void SetParallelSticks(bool parallel);
+        bool GetParallelSticks();
+        /// @brief Updates the 100-hour stick once every \p hours Update() calls instead of every hour.
+        /// The stick surface still follows each hourly observation (see DFMMultiRate), the stick is also
+        /// updated at the regular observation hour, and MC100 is projected from its last update in between.
+        /// @param hours observations per stick update; 1 (the default) updates the stick hourly
+        void Set100HourUpdateInterval(int hours);
+        int Get100HourUpdateInterval();
+        /// @brief Updates the 1000-hour stick once every \p hours Update() calls instead of every hour.
+        /// @see Set100HourUpdateInterval()
+        /// @param hours observations per stick update; 1 (the default) updates the stick hourly
+        void Set1000HourUpdateInterval(int hours);
+        int Get1000HourUpdateInterval();
 
         void SetStartKBDI(int sKBDI);
 		int GetStartKBDI();
@@ -278,6 +476,25 @@ class NFDRS4
 		bool ReadState(std::string fileName);
 		bool SaveState(std::string fileName);
 		bool LoadState(NFDRS4State state);
+		/// @brief Takes the complete dynamic state of the station into a flat snapshot.
+		/// Together with Restore(), forks a station into any number of scenarios from
+		/// one state, without SaveState() files or copies of the whole instance.
+		///
+		/// @param Snap Snapshot to fill
+		/// @return false if a stick has more than DFM_SnapshotNodes nodes, a GSI averaging period
+		/// is longer than LFM_SnapshotDays, or an update interval is longer than DFM_SnapshotHours
+		///
+		bool Snapshot(NFDRS4Snapshot* Snap);
+		/// @brief Replaces the dynamic state of the station with a Snapshot(), without allocating.
+		/// The snapshot may come from this or another station with the same stick node counts,
+		/// GSI averaging periods and update intervals; settings are left as they are.  Updates
+		/// from the restored state give the same results as updates of the station the snapshot
+		/// was taken from.  The indexes of SetFuelModels() models are recalculated on their next read.
+		///
+		/// @param Snap Snapshot to restore
+		/// @return false, leaving the station unchanged, if the snapshot does not fit it
+		///
+		bool Restore(const NFDRS4Snapshot& Snap);
 		const int nPrecipQueueDays = 90;
         const int nHoursPerDay = 24;
         double GetMinTemp();
@@ -286,16 +503,34 @@ class NFDRS4
         double GetPcp24();
 
 		void AddCustomFuel(CFuelModelParams fmParams);
+		/// @brief Fuel models known to the station: the standard V, W, X, Y and Z and those of AddCustomFuel()
+		const std::unordered_map<char, CFuelModelParams>& GetFuelModelMap() const;
+		/// @brief Sets fuel models whose indexes are evaluated on the station's moisture simulation.
+		/// Each update then calculates the dead and live fuel moistures and KBDI once, and the indexes
+		/// of the station's own fuel model and of each of these.  Each model's indexes equal those of a
+		/// separate station on that model with the same overrides.
+		///
+		/// @param Models Fuel model codes (eg. "VWXYZ"), standard or added by AddCustomFuel(); empty for none
+		/// @param MXD If positive, the dead fuel moisture of extinction of every model, as SetMXD()
+		/// @param SCMax If positive, the spread component of every model at which all ignitions are reportable, as SetSCMax()
+		/// @return false, leaving the models unchanged, if a code is not a known fuel model
+		///
+		bool SetFuelModels(const std::string& Models, int MXD = 0, int SCMax = 0);
+		int GetNumFuelModels();
+		char GetFuelModel(int Model);
+		bool GetModelFuelBed(int Model, NFDRS4FuelBed* Bed);
+		bool GetModelIndexes(int Model, double* fSC, double* fERC, double* fBI, double* fIC);
+		void CalcModelIndexes(int iWS, int iSlopeCls);
 		double CTA;
         double Lat;
         int NFDRSVersion;
         int YesterdayJDay;
         int SlopeClass;
        // double AvgAnnPrecip;        // Average Annual Precipitation (inches)
-        DeadFuelMoisture OneHourFM;
-        DeadFuelMoisture TenHourFM;
-        DeadFuelMoisture HundredHourFM;
-        DeadFuelMoisture ThousandHourFM;
+        DeadFuelMoistureStandard OneHourFM;
+        DeadFuelMoistureStandard TenHourFM;
+        DeadFuelMoistureStandard HundredHourFM;
+        DeadFuelMoistureStandard ThousandHourFM;
 		//LiveFuelMoisture GsiFM;
 		LiveFuelMoisture HerbFM;
 		LiveFuelMoisture WoodyFM;
@@ -320,14 +555,42 @@ class NFDRS4
 		double m_GSI;
 		int nConsectiveSnowDays;
         int m_regObsHour;
+        bool m_sharedForcing;       // If TRUE, the dead fuel sticks share m_forcing
+        DFMForcing m_forcing;       // Atmospheric forcing derived once per Update() for the dead fuel sticks
+        DFMMultiRate m_fm100Rate;   // Hourly observations gathered between updates of the 100-hour stick
+        DFMMultiRate m_fm1000Rate;  // Hourly observations gathered between updates of the 1000-hour stick
+        bool m_parallelSticks;      // If TRUE, Run() updates the dead fuel sticks on m_stickPipeline
+        NFDRS4StickPipeline m_stickPipeline;    // Dead fuel stick threads of Run()
+        bool m_lazyIndexes;         // If TRUE, updates defer their indexes to the getters
+        int m_pendingIndexes;       // IndexFlags of the indexes deferred by the last update
+        int m_pendingWS;            // Wind speed (mph) of the deferred indexes
+        int m_pendingSlopeCls;      // Slope class of the deferred indexes
+        std::vector<NFDRS4ModelIndexes> m_models;  // Fuel models of SetFuelModels()
+        int m_modelMXD, m_modelSCM;  // Overrides of SetFuelModels(), 0 if none
+        bool m_modelsPending;       // Model indexes deferred by the last update
         time_t utcHourDiff;
         utctime::UTCTime lastUtcUpdateTime;
         utctime::UTCTime lastDailyUpdateTime;
-        std::deque<double> qPrecip;
-        std::deque<double> qHourlyPrecip;
-        std::deque<double> qHourlyTemp;
-        std::deque<double> qHourlyRH;
-		std::unordered_map<char, CFuelModelParams> mapFuels;
+        NFDRS4RollingWindow qPrecip;        // Daily rainfall of the last nPrecipQueueDays days
+        NFDRS4RollingWindow qHourlyPrecip;  // Hourly rainfall, temperature and RH of the last nHoursPerDay hours
+        NFDRS4RollingWindow qHourlyTemp;
+        NFDRS4RollingWindow qHourlyRH;
+		std::shared_ptr<const NFDRS4CompiledFuel> m_compiledFuel;	// Fuel bed and slope class of the last index calculation
+		NFDRS4IndexBedCache m_indexBedCache;	// Fuel bed of m_compiledFuel at the last KBDI and GSI
+
+    private:
+		// Steps of Update(), also run by Run(), the stick pipeline and ensembles
+		friend class NFDRS4StickPipeline;
+		friend class NFDRS4Ensemble;
+		void StartUpdate(int Year, int Julian, bool SnowDay);
+		NFDRS4StickInput DeadFuelInput(int Year, int Month, int Day, int Hour, double Temp, double RH, double PPTAmt, double SolarRad, bool SnowDay);
+		double UpdateDeadFuel(int Stick, const NFDRS4StickInput& in, const DFMForcing* forcing = NULL);
+		void FinishUpdate(int Year, int Month, int Day, int Hour, int Julian, double Temp, double RH, double PPTAmt, double WS, bool SnowDay, const NFDRS4DailyWeather* Daily = NULL);
+		void AdvanceSharedForcing(double temp, double rh);
+		double UpdateMultiRate(DeadFuelMoisture& fm, DFMMultiRate& rate, int Year, int Month, int Day, int Hour,
+			double temp, double rh, double sr, double ppt, bool regObs);
+
+		std::shared_ptr<const std::unordered_map<char, CFuelModelParams> > m_fuels;	// Fuel models, shared until AddCustomFuel() copies them
 };
 
 
@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4ensemble.h
+    \brief NFDRS4Ensemble class interface and declarations.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifndef _NFDRS4ENSEMBLE_H_INCLUDED_
+#define _NFDRS4ENSEMBLE_H_INCLUDED_
+
+#include "nfdrs4.h"
+#include "deadfuelmoisturebatch.h"
+#include <vector>
+
+/// Variables summarized by NFDRS4Ensemble, in the order of their statistics
+enum NFDRS4EnsembleVariable { EnsembleMC1, EnsembleERC, EnsembleBI, EnsembleSC, EnsembleIC, EnsembleVariables };
+
+//------------------------------------------------------------------------------
+/*! \class NFDRS4Ensemble
+    \brief Runs the members of a weather ensemble, such as the 30 to 50
+    members of an NWP forecast, from one station state and reduces them hour
+    by hour to statistics across the members.
+
+    Start() makes each member a copy of the station.  Each Step() then
+    advances every member by its own observation for the same hour and
+    reduces their MC1, ERC, BI, SC and IC to the mean, minimum, maximum and
+    the percentiles of SetPercentiles(), so only one hour of member results
+    is ever kept.
+
+    The indexes of all members are calculated in one NFDRS4CalcIndexes()
+    call.  With SetBatchSticks(), the dead fuel sticks of each size class
+    are also advanced for all members at once in a DeadFuelMoistureBatch,
+    one lane per member; a class whose sticks the batch does not take (see
+    DeadFuelMoistureBatch::compatible()), shares its forcing or is updated
+    less than hourly still runs member by member.  Each member's values are
+    those of NFDRS4::Update() on a copy of the station, in the default build.
+ */
+
+class NFDRS4Ensemble
+{
+    public:
+        NFDRS4Ensemble();
+        ~NFDRS4Ensemble();
+
+        /// @brief Sets the percentiles reported after the mean, minimum and maximum.
+        /// Percentiles interpolate linearly between the sorted member values.
+        /// @param Percentiles Percentiles (0-100), eg. { 10, 50, 90 }; empty for none
+        /// @return false, leaving the percentiles unchanged, if one is outside 0-100
+        bool SetPercentiles(const std::vector<double>& Percentiles);
+        const std::vector<double>& GetPercentiles() const;
+        /// @brief Statistics per variable: mean, minimum, maximum, then each percentile.
+        int GetNumStats() const;
+        /// @brief Advances the sticks of all members together, or member by member (the default).
+        /// The fixed node sticks of NFDRS4 are as fast member by member as in a batch.
+        void SetBatchSticks(bool Batch);
+        bool GetBatchSticks() const;
+        /// @brief Calculates the indexes on the SIMD path of NFDRS4CalcIndexes(), false (the default) for the exact one.
+        void SetSimdIndexes(bool Simd);
+        bool GetSimdIndexes() const;
+
+        /// @brief Starts an ensemble of members, each a copy of a station.
+        /// @param Station Station whose state and settings every member starts from
+        /// @param nMembers Number of members
+        /// @return false if nMembers is less than 1
+        bool Start(const NFDRS4& Station, int nMembers);
+        /// @brief Advances every member by one hour and reduces the hour to statistics.
+        /// @param Obs One observation per member, all for the same date and hour
+        /// @param Stats EnsembleVariables * GetNumStats() elements, the statistics of MC1 first
+        /// @return false if the ensemble is not started or the observations differ in date or hour
+        bool Step(const NFDRS4Observation* Obs, double* Stats);
+        /// @brief Start() followed by one Step() per hour of a series.
+        /// @param Station Station whose state and settings every member starts from
+        /// @param nMembers Number of members
+        /// @param nObs Hours per member
+        /// @param Obs nMembers * nObs observations, the hours of the first member first
+        /// @param Stats nObs * EnsembleVariables * GetNumStats() elements, the statistics of the first hour first
+        /// @return Number of hours processed, which is less than nObs if a Step() failed
+        int Run(const NFDRS4& Station, int nMembers, int nObs, const NFDRS4Observation* Obs, double* Stats);
+
+        int GetNumMembers() const;
+        /// @brief Member Index as left by the last Step(), its sticks brought up to date with the batches.
+        NFDRS4& Member(int Index);
+
+    private:
+        NFDRS4Ensemble(const NFDRS4Ensemble&);
+        NFDRS4Ensemble& operator=(const NFDRS4Ensemble&);
+
+        DeadFuelMoisture& Stick(int Member, int Class);
+        bool LoadBatch(int Class);
+        void Reduce(const double* Values, double* Stats);
+
+        std::vector<NFDRS4> m_members;
+        std::vector<double> m_percentiles;
+        bool m_batchSticks;
+        bool m_simdIndexes;
+        DeadFuelMoistureBatch m_batch[4];       // Sticks of each size class, one lane per member
+        bool m_batched[4];                      // Size class is advanced in m_batch
+        bool m_batchStale;                      // Member sticks lag m_batch
+        std::shared_ptr<const NFDRS4CompiledFuel> m_fuel;
+        NFDRS4IndexBedCache m_cache;
+        std::vector<NFDRS4StickInput> m_in;     // Per member inputs, outputs and scratch of Step()
+        std::vector<double> m_at, m_rh, m_sw, m_ppt;
+        std::vector<double> m_mc1, m_mc10, m_mc100, m_mc1000, m_mcherb, m_mcwood, m_fuelTemp;
+        std::vector<double> m_ws, m_kbdi, m_gsi;
+        std::vector<double> m_sc, m_erc, m_bi, m_ic;
+        std::vector<double> m_sorted;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of nfdrs4ensemble.h
+//------------------------------------------------------------------------------
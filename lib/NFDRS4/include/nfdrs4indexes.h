@@ -0,0 +1,235 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4indexes.h
+    \brief Stateless NFDRS4 index calculations for batches of records.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifndef _NFDRS4INDEXES_H_INCLUDED_
+#define _NFDRS4INDEXES_H_INCLUDED_
+
+#include <cstddef>
+#include <memory>
+#include "dfmsimd.h"
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4FuelBed
+    \brief The fuel model and load transfer settings the indexes of an NFDRS4
+    station are computed on, as returned by NFDRS4::GetFuelBed().
+*/
+struct NFDRS4FuelBed
+{
+	int SG1, SG10, SG100, SG1000, SGHERB, SGWOOD;		// Surface area to volume ratios (1/ft)
+	double L1, L10, L100, L1000, LHERB, LWOOD, LDROUGHT;	// Fuel loads (tons/acre)
+	double DEPTH;			// Fuel bed depth (ft)
+	double MXD;				// Dead fuel moisture of extinction (%)
+	double HD;				// Heat of combustion (BTU/lb)
+	double SCM;				// Spread component at which all ignitions are reportable
+	double WNDFC;			// Wind reduction factor
+	double CTA;				// Load conversion (tons/acre to lb/ft2)
+	int KBDIThreshold;		// KBDI above which drought fuel is added to the dead loads
+	double GreenupThreshold;	// GSI at which herbaceous curing starts
+	double MaxGSI;			// GSI of fully green herbs
+};
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4FuelLoads
+    \brief Fuel loads of an NFDRS4FuelBed after the drought load transfer at
+    a KBDI and the herbaceous load transfer at a GSI (lb/ft2).
+*/
+struct NFDRS4FuelLoads
+{
+	double W1, W10, W100, W1000, WHERB, WWOOD, WDROUGHT;	// Loads after the drought transfer
+	double W1P, WHERBP;		// 1-h and herbaceous loads after curing
+	double WTOTD, WTOTL, WTOT;	// Total dead, live and overall loads after curing
+	double DEPTH;			// Fuel bed depth after the drought transfer (ft)
+	double DroughtUnit;		// Drought load per KBDI unit, if Drought
+	double fctCur;			// Fraction of the herbaceous load cured
+	bool Drought;			// KBDI was above the threshold
+};
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4IndexInputs
+    \brief Per record inputs of NFDRS4CalcIndexes(), one element per record.
+    All are required.
+*/
+struct NFDRS4IndexInputs
+{
+	const double* MC1 = NULL;		// 1-h dead fuel moisture (%)
+	const double* MC10 = NULL;		// 10-h dead fuel moisture (%)
+	const double* MC100 = NULL;		// 100-h dead fuel moisture (%)
+	const double* MC1000 = NULL;	// 1000-h dead fuel moisture (%)
+	const double* MCHERB = NULL;	// Herbaceous fuel moisture (%)
+	const double* MCWOOD = NULL;	// Woody fuel moisture (%)
+	const double* FuelTemperature = NULL;	// Fuel surface temperature (C)
+	const double* WS = NULL;		// Wind speed (whole mph); records with a negative speed are skipped
+	const double* KBDI = NULL;		// Keetch-Byram drought index
+	const double* GSI = NULL;		// Growing season index
+};
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4IndexOutputs
+    \brief Per record outputs of NFDRS4CalcIndexes(), one element per
+    record.  Outputs left NULL are not written, and the exact path skips the
+    stages only they need: the spread component if SC, BI and IC are all
+    NULL, the probability of ignition if IC is.
+*/
+struct NFDRS4IndexOutputs
+{
+	double* SC = NULL;			// Spread component
+	double* ERC = NULL;			// Energy release component
+	double* BI = NULL;			// Burning index
+	double* IC = NULL;			// Ignition component
+	double* WTMCD = NULL;		// Surface area weighted dead fuel moisture (%)
+	double* WTMCL = NULL;		// Surface area weighted live fuel moisture (%)
+	double* WTMCDE = NULL;		// Loading weighted dead fuel moisture (%)
+	double* WTMCLE = NULL;		// Loading weighted live fuel moisture (%)
+};
+
+//------------------------------------------------------------------------------
+/*! \class NFDRS4CompiledFuel
+    \brief An NFDRS4FuelBed on one slope class, with the quantities of its
+    index calculations that depend on neither the KBDI, the GSI nor the
+    records worked out once.
+
+    A compiled fuel is immutable, so one instance may be used by any number
+    of stations and threads at once.  Get() returns the instance shared by
+    every caller with the same fuel bed and slope class.
+*/
+class NFDRS4CompiledFuel
+{
+	public:
+		NFDRS4CompiledFuel(const NFDRS4FuelBed& Bed, int SlopeClass);
+
+		static std::shared_ptr<const NFDRS4CompiledFuel> Get(const NFDRS4FuelBed& Bed, int SlopeClass);
+
+		bool Matches(const NFDRS4FuelBed& Bed, int SlopeClass) const;
+		bool IsValid() const;
+		bool CalcBed(const NFDRS4FuelLoads& Loads, DFMSimdIndexBed* b) const;
+		const NFDRS4FuelBed& GetBed() const;
+		int GetSlopeClass() const;
+		unsigned long GetId() const;
+
+	private:
+		NFDRS4FuelBed m_bed;
+		int m_slopeClass;
+		unsigned long m_id;         // Unique to each compiled fuel, shared by its copies
+		bool m_valid;               // Slope class is 1-5 and the fuel bed has depth
+		double m_x1, m_x10, m_x100, m_xherb, m_xwood;  // Heating numbers exp(-138/SG)
+		double m_hnherb, m_hnwood;  // exp(-500/SG) of the live classes, 0 if it underflows
+		double m_slopeFactor;       // Slope factor of the slope class
+		bool m_liveTotal;           // Net live loading is the whole net live load
+};
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4IndexBedCache
+    \brief The transferred loads and fuel bed an NFDRS4CompiledFuel last
+    derived at a KBDI and GSI, kept from one NFDRS4CalcIndexes() call to the
+    next.  Both change only with the daily KBDI and GSI, so hourly calls
+    reuse them and only work out the moisture dependent terms.
+*/
+struct NFDRS4IndexBedCache
+{
+	unsigned long FuelId = 0;	// NFDRS4CompiledFuel::GetId() of the fuel, 0 if empty
+	double KBDI = 0;			// KBDI the bed was derived at
+	double GSI = 0;				// GSI the bed was derived at
+	bool Valid = false;			// The bed has dead fuel
+	NFDRS4FuelLoads Loads;		// Loads after the drought and herbaceous transfers
+	DFMSimdIndexBed Bed;
+};
+
+/// @brief Derives the loads and fuel bed of a compiled fuel at a KBDI and GSI into a cache,
+/// unless the cache already holds them.
+/// @param Fuel Compiled fuel
+/// @param KBDI Keetch-Byram drought index
+/// @param GSI Growing season index
+/// @param Cache Cache to derive into
+/// @return true if the fuel bed has dead fuel
+bool NFDRS4UpdateIndexBed(const NFDRS4CompiledFuel& Fuel, double KBDI, double GSI, NFDRS4IndexBedCache* Cache);
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4SweepOutputs
+    \brief Outputs of NFDRS4CalcIndexSweep().  The tables hold one element per
+    slope class and wind speed, the wind speeds of the first slope class first.
+    Outputs left NULL are not written.
+*/
+struct NFDRS4SweepOutputs
+{
+	double* SC = NULL;			// Spread component table
+	double* BI = NULL;			// Burning index table
+	double* IC = NULL;			// Ignition component table
+	double* ERC = NULL;			// Energy release component, which depends on neither wind nor slope
+};
+
+/// @brief Applies the drought and herbaceous load transfers of NFDRS4::iCalcIndexes() to a fuel bed.
+/// @param Bed Fuel bed
+/// @param KBDI Keetch-Byram drought index
+/// @param GSI Growing season index
+/// @return Transferred loads
+NFDRS4FuelLoads NFDRS4CalcFuelLoads(const NFDRS4FuelBed& Bed, double KBDI, double GSI);
+
+/// @brief Calculates the NFDRS4 components and indexes of a batch of records on one fuel bed.
+/// Uses no NFDRS4 instance: the fuel bed, slope class and inputs determine the outputs, so
+/// records may come from any period or station sharing the fuel model.  The fuel bed is
+/// derived once per run of consecutive records with the same KBDI and GSI.
+///
+/// The exact path performs the operations of NFDRS4::iCalcIndexes() in the same order and
+/// gives identical results.  The SIMD path evaluates the records of each run several at a
+/// time with DFMSimd::indexes(), at the widest instruction set of the host; its indexes differ
+/// from the exact path by less than 1.0e-11, relative to the index or to 1 if the index is smaller.
+/// @param Bed Fuel bed
+/// @param SlopeClass Slope class (1-5)
+/// @param n Number of records
+/// @param In Input arrays of at least n elements
+/// @param Out Output arrays of at least n elements; elements of skipped records are not written
+/// @param Simd true for the SIMD path, false (the default) for the exact one
+/// @return Number of records computed, 0 if the slope class or fuel bed is invalid
+int NFDRS4CalcIndexes(const NFDRS4FuelBed& Bed, int SlopeClass, int n, const NFDRS4IndexInputs& In,
+	const NFDRS4IndexOutputs& Out, bool Simd = false);
+
+/// @brief Calculates the NFDRS4 components and indexes of a batch of records on a compiled fuel.
+/// As NFDRS4CalcIndexes() on the fuel bed and slope class of Fuel, without deriving their
+/// invariants again.
+/// @param Fuel Compiled fuel bed and slope class
+/// @param n Number of records
+/// @param In Input arrays of at least n elements
+/// @param Out Output arrays of at least n elements; elements of skipped records are not written
+/// @param Simd true for the SIMD path, false (the default) for the exact one
+/// @param Cache If not NULL, supplies the fuel bed of the first record when it was derived from
+/// Fuel at the same KBDI and GSI, and receives the fuel bed of the last record
+/// @return Number of records computed, 0 if the slope class or fuel bed is invalid
+int NFDRS4CalcIndexes(const NFDRS4CompiledFuel& Fuel, int n, const NFDRS4IndexInputs& In,
+	const NFDRS4IndexOutputs& Out, bool Simd = false, NFDRS4IndexBedCache* Cache = NULL);
+
+/// @brief Calculates the spread component, burning index and ignition component of one record
+/// over a table of wind speeds and slope classes.  The reaction intensity, heat sink, energy
+/// release component and probability of ignition do not depend on wind or slope, so they are
+/// computed once for the table; each cell then costs the wind and slope factors and the terms
+/// downstream of them.  Cells equal NFDRS4CalcIndexes() of the record at that wind speed and
+/// slope class.
+/// @param Fuel Compiled fuel bed; its own slope class is not used, but must be valid
+/// @param In Inputs of the record, in element 0; WS is not used
+/// @param nWinds Number of wind speeds
+/// @param WindSpeeds Wind speeds (whole mph); columns of negative speeds are not written
+/// @param nSlopes Number of slope classes
+/// @param SlopeClasses Slope classes; rows of classes outside 1-5 are not written
+/// @param Out Output tables of at least nSlopes * nWinds elements
+/// @param Cache As for NFDRS4CalcIndexes()
+/// @return Number of cells computed, 0 if the fuel bed is invalid
+int NFDRS4CalcIndexSweep(const NFDRS4CompiledFuel& Fuel, const NFDRS4IndexInputs& In, int nWinds, const double* WindSpeeds,
+	int nSlopes, const int* SlopeClasses, const NFDRS4SweepOutputs& Out, NFDRS4IndexBedCache* Cache = NULL);
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of nfdrs4indexes.h
+//------------------------------------------------------------------------------
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4rollingwindow.h
+    \brief NFDRS4RollingWindow class interface and declarations.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifndef _NFDRS4ROLLINGWINDOW_H_INCLUDED_
+#define _NFDRS4ROLLINGWINDOW_H_INCLUDED_
+
+#include <vector>
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4RollingWindowState
+    \brief The positions and count of an NFDRS4RollingWindow, part of an
+    NFDRS4RollingWindowSnapshot.
+*/
+struct NFDRS4RollingWindowState
+{
+    int Capacity;
+    int Head, Size, Count;
+    int MinHead, MinSize, MaxHead, MaxSize;
+};
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4RollingWindowSnapshot
+    \brief The contents of an NFDRS4RollingWindow of up to MaxCapacity values,
+    slot for slot, as taken by NFDRS4RollingWindow::Snapshot().
+*/
+template <int MaxCapacity>
+struct NFDRS4RollingWindowSnapshot
+{
+    double Values[MaxCapacity];
+    int MinQ[MaxCapacity];
+    int MaxQ[MaxCapacity];
+    NFDRS4RollingWindowState State;
+};
+
+//------------------------------------------------------------------------------
+/*! \class NFDRS4RollingWindow
+    \brief The last few values of a series, such as the last 24 hourly
+    temperatures or the last 90 daily rainfall totals, with their sum,
+    minimum and maximum kept up to date as values are pushed.
+
+    Values are kept in a ring of fixed capacity, so pushing onto a full
+    window drops its oldest value and never allocates.  Values equal to the
+    window's no record value are kept in place but left out of the count,
+    sum, minimum and maximum.
+
+    The minimum and maximum are the fronts of two monotonic queues, so
+    Push(), PopFront(), Count(), Min() and Max() all take constant
+    (amortized) time.  Sum() and SumLast() add the values up in order from
+    the oldest each time, as the deques did, so that sums over the GSI and
+    rainfall windows stay bit-identical to theirs; a running sum would not.
+ */
+
+class NFDRS4RollingWindow
+{
+    public:
+        NFDRS4RollingWindow(int Capacity = 0, double NoRecord = -999.0);
+
+        void SetCapacity(int Capacity);
+        int GetCapacity() const;
+        void Clear();
+
+        void Push(double Value);
+        void PushMissing(long long n);
+        void PopFront(int n = 1);
+
+        int Size() const;
+        int Count() const;
+        double Sum() const;
+        double SumLast(int n) const;
+        double Min() const;
+        double Max() const;
+        double operator[](int i) const;
+
+        // Copies the ring as it is, so a restored window
+        // gives the same results as the window it was taken from.  Restore()
+        // requires the same capacity and does not allocate.
+        template <int MaxCapacity>
+        bool Snapshot(NFDRS4RollingWindowSnapshot<MaxCapacity>* Snap) const
+        {
+            return Save(Snap->Values, Snap->MinQ, Snap->MaxQ, MaxCapacity, &Snap->State);
+        }
+        template <int MaxCapacity>
+        bool Restore(const NFDRS4RollingWindowSnapshot<MaxCapacity>& Snap)
+        {
+            return Load(Snap.Values, Snap.MinQ, Snap.MaxQ, MaxCapacity, Snap.State);
+        }
+
+    private:
+        bool Save(double* Values, int* MinQ, int* MaxQ, int MaxCapacity, NFDRS4RollingWindowState* State) const;
+        bool Load(const double* Values, const int* MinQ, const int* MaxQ, int MaxCapacity, const NFDRS4RollingWindowState& State);
+        // Slot of the ring an index below twice the capacity falls on
+        int Wrap(int Slot) const { return (Slot >= m_capacity) ? Slot - m_capacity : Slot; }
+        int Next(int Slot) const { return Wrap(Slot + 1); }
+        void Evict();
+
+        std::vector<double> m_values;       // Ring of Capacity values
+        std::vector<int> m_minQ;            // Ring of the slots of increasing values, oldest first
+        std::vector<int> m_maxQ;            // Ring of the slots of decreasing values, oldest first
+        int m_capacity;
+        double m_noRecord;
+        int m_head;                         // Slot of the oldest value
+        int m_size;
+        int m_count;                        // Values other than m_noRecord
+        int m_minHead, m_minSize;
+        int m_maxHead, m_maxSize;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of nfdrs4rollingwindow.h
+//------------------------------------------------------------------------------
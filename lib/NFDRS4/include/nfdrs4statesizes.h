@@ -1,2 +1,7 @@
 #pragma once
 #define FP_STORAGE_TYPE	float
+// Arithmetic type of the dead fuel stick nodal arrays and their time step loops.
+// Defined as float by the NFDRS4_FLOAT_COMPUTE CMake option.
+#ifndef FP_COMPUTE_TYPE
+#define FP_COMPUTE_TYPE	double
+#endif
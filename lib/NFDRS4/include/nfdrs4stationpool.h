@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4stationpool.h
+    \brief NFDRS4StationPool class interface and declarations.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifndef _NFDRS4STATIONPOOL_H_INCLUDED_
+#define _NFDRS4STATIONPOOL_H_INCLUDED_
+
+#include "nfdrs4.h"
+#include <string>
+#include <vector>
+
+struct NFDRS4StationSlot;
+
+//------------------------------------------------------------------------------
+/*! \class NFDRS4StationPool
+    \brief Runs many independent NFDRS4 stations, each over its own series of
+    hourly observations, on a pool of threads.
+
+    Each station is an NFDRS4 instance owned by the pool, set up through
+    Station() like any other NFDRS4, together with the observations gathered
+    for it since the last Run() and the caller's output arrays.  Run() cuts
+    every station's observations into chunks of GetChunkHours() hours and
+    hands them to the worker threads; a worker that runs out of chunks
+    steals from the others, so a few long series do not hold up the run.
+    A station's next chunk is queued only once its previous one is done, so
+    each station still sees its observations one at a time and in order,
+    and its results are the same whatever the number of threads.
+
+    Each station, with its observations and outputs, sits in its own cache
+    line aligned block, and each worker's queue in its own cache line, so
+    threads working on neighbouring stations do not share cache lines.
+ */
+
+class NFDRS4StationPool
+{
+    public:
+        NFDRS4StationPool();
+        ~NFDRS4StationPool();
+
+        /// @brief Adds a station, built with the NFDRS4 default constructor.
+        /// @param ID Station identifier (for the caller's use)
+        /// @return Index of the new station
+        int AddStation(const std::string& ID);
+        NFDRS4& Station(int Index);
+        const NFDRS4& Station(int Index) const;
+        const std::string& GetStationID(int Index) const;
+        int GetNumStations() const;
+
+        /// @brief Queues one hourly observation for the next Run() of a station.
+        void AddObservation(int Index, const NFDRS4Observation& Obs);
+        /// @brief Replaces the observations queued for the next Run() of a station.
+        void SetObservations(int Index, const NFDRS4Observation* Obs, int nObs);
+        int GetNumObservations(int Index) const;
+        /// @brief Sets where Run() writes a station's outputs.
+        /// @param Out Output arrays of at least GetNumObservations(Index) elements (NULL outputs are skipped)
+        void SetOutputs(int Index, const NFDRS4Outputs& Out);
+
+        /// @brief Runs every station over its queued observations, then clears them.
+        /// @param nThreads Number of threads (0 for one per hardware thread)
+        /// @return true if no station failed (see GetError())
+        bool Run(int nThreads = 0);
+        /// @brief Error met by a station in the last Run(), empty if none.
+        const std::string& GetError(int Index) const;
+
+        void SetChunkHours(int Hours);
+        int GetChunkHours() const;
+        void SetPinThreads(bool Pin);
+        bool GetPinThreads() const;
+
+    private:
+        NFDRS4StationPool(const NFDRS4StationPool&);
+        NFDRS4StationPool& operator=(const NFDRS4StationPool&);
+
+        std::vector<NFDRS4StationSlot*> m_slots;    // One cache line aligned block per station
+        int m_chunkHours;                           // Observations per scheduled chunk
+        bool m_pinThreads;                          // Pin each worker thread to one processor
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of nfdrs4stationpool.h
+//------------------------------------------------------------------------------
@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4stickpipeline.h
+    \brief NFDRS4StickPipeline class interface and declarations.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifndef _NFDRS4STICKPIPELINE_H_INCLUDED_
+#define _NFDRS4STICKPIPELINE_H_INCLUDED_
+
+#include "dfmforcing.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class NFDRS4;
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4StickInput
+    \brief One hour of weather as seen by the four dead fuel sticks of an
+    NFDRS4 station.
+ */
+
+struct NFDRS4StickInput
+{
+    int Year;
+    int Month;
+    int Day;
+    int Hour;
+    double Temp;        // Air temperature (oC)
+    double RH;          // Air relative humidity (g/g)
+    double SolarRad;    // Solar radiation (W/m2)
+    double PPTAmt;      // Rainfall amount (cm)
+    bool RegObs;        // Hour is the regular observation hour
+};
+
+//------------------------------------------------------------------------------
+/*! \class NFDRS4StickPipeline
+    \brief Persistent worker threads that run the four dead fuel sticks of
+    an NFDRS4 station ahead of its index calculations.
+
+    The sticks do not depend on one another, nor on anything computed after
+    them in NFDRS4::Update(), so over a window of hours whose stick inputs
+    are known in advance each stick can run on its own thread as far ahead
+    as it likes.  NFDRS4::Run() fills Inputs (and Forcing, when the sticks
+    share their forcing), calls Start(), and computes the indexes of each
+    hour once WaitFor() shows that all four sticks have finished it.
+
+    A stick that throws stops the window at its failing hour: WaitFor() of
+    that hour or a later one waits for the workers to leave the window and
+    rethrows, so no hour after the last good one is ever returned.  The
+    other sticks may by then have run past that hour; NFDRS4::Run() takes
+    the station back to the end of the last good hour.
+
+    One worker per stick is started on the first window and kept until the
+    pipeline is stopped or destroyed.  Copies of a pipeline have no workers
+    of their own.
+ */
+
+class NFDRS4StickPipeline
+{
+    public:
+        enum { Sticks = 4 };
+
+        NFDRS4StickPipeline();
+        NFDRS4StickPipeline(const NFDRS4StickPipeline& rhs);
+        NFDRS4StickPipeline& operator=(const NFDRS4StickPipeline& rhs);
+        ~NFDRS4StickPipeline();
+
+        void Start(NFDRS4* Owner, int nHours);
+        void WaitFor(int Hour);
+        void Finish();
+        void WaitIdle();
+        void Stop();
+
+        std::vector<NFDRS4StickInput> Inputs;   // Stick inputs of each hour of the window
+        std::vector<DFMForcing> Forcing;        // Shared forcing of each hour, empty if not shared
+        std::vector<double> MC[Sticks];         // Moisture content of each stick after each hour (%)
+        std::vector<double> FuelTemperature;    // 1-hour stick surface temperature after each hour (oC)
+
+    private:
+        // Hours completed by one stick, on a cache line of its own
+        struct Progress
+        {
+            std::atomic<int> Hours;
+            char Pad[64 - sizeof(std::atomic<int>)];
+        };
+
+        bool Ready(int Hour) const;
+        void Work(int Stick);
+
+        std::vector<std::thread> m_workers;
+        std::mutex m_lock;
+        std::condition_variable m_wake;         // Workers wait here for a window
+        std::condition_variable m_progress;     // WaitFor() and WaitIdle() wait here
+        NFDRS4* m_owner;
+        int m_hours;
+        unsigned m_generation;                  // Incremented by Start()
+        bool m_stop;
+        int m_busy;                             // Workers still in the window
+        std::atomic<int> m_waiting;             // Threads blocked on m_progress
+        std::atomic<int> m_failedHour;          // First hour a stick threw at, or m_hours
+        std::exception_ptr m_error;             // First exception thrown by a stick
+        Progress m_done[Sticks];
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of nfdrs4stickpipeline.h
+//------------------------------------------------------------------------------
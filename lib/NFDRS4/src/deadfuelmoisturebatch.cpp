@@ -0,0 +1,1161 @@
+//------------------------------------------------------------------------------
+/*! \file deadfuelmoisturebatch.cpp
+    \brief DeadFuelMoistureBatch class definition and implementation.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using std::ostringstream;
+using std::vector;
+
+// Custom include files
+#include "deadfuelmoisturebatch.h"
+#include "diagnostics.h"
+
+// The batch mirrors DeadFuelMoisture::update() and shares its constants
+typedef DeadFuelMoisture DFM;
+
+// Time fields shared with DeadFuelMoisture::update()
+time_t mkgmtime(short year, short month, short day, short hour, short minute, short second, int *jDay);
+
+//------------------------------------------------------------------------------
+/*! \brief Default class constructor.
+
+    Creates an empty batch; call initialize() before use.
+ */
+
+DeadFuelMoistureBatch::DeadFuelMoistureBatch( void ) :
+    m_lanes( 0 ),
+    m_nodes( 0 ),
+    m_mSteps( 0 ),
+    m_dSteps( 0 ),
+    m_dx( 0.0 ),
+    m_allowRainfall2( false ),
+    m_allowRainstorm( false ),
+    m_rampRai0( false ),
+    m_Jday( 0.0 ),
+    m_Year( 0.0 ),
+    m_Month( 0.0 ),
+    m_Day( 0.0 ),
+    m_Hour( 0.0 ),
+    m_obstime( 0 ),
+    m_updates( 0 ),
+    m_elapsed( 0.0 )
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Class constructor.
+
+    \param[in] prototype Stick copied into every lane.
+    \param[in] lanes     Number of sticks (stations) in the batch.
+ */
+
+DeadFuelMoistureBatch::DeadFuelMoistureBatch( const DeadFuelMoisture& prototype, int lanes )
+{
+    initialize( prototype, lanes );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Class destructor.
+ */
+
+DeadFuelMoistureBatch::~DeadFuelMoistureBatch( void )
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sizes the batch and copies \a prototype into every lane.
+
+    The prototype also supplies the shared geometry, step counts and
+    observation clock of the batch.
+
+    \param[in] prototype Stick copied into every lane.
+    \param[in] lanes     Number of sticks (stations) in the batch.
+ */
+
+void DeadFuelMoistureBatch::initialize( const DeadFuelMoisture& prototype, int lanes )
+{
+    m_proto  = prototype;
+    m_lanes  = ( lanes < 0 ) ? 0 : lanes;
+    m_nodes  = prototype.m_nodes;
+    m_mSteps = prototype.m_mSteps;
+    m_dSteps = prototype.m_dSteps;
+    m_dx     = prototype.m_dx;
+    m_allowRainfall2 = prototype.m_allowRainfall2;
+    m_allowRainstorm = prototype.m_allowRainstorm;
+    m_rampRai0       = prototype.m_rampRai0;
+    m_x.assign( prototype.m_x.begin(), prototype.m_x.end() );
+    m_v.assign( prototype.m_v.begin(), prototype.m_v.end() );
+    m_Tv.assign( m_nodes, 0.0 );
+    for ( int i=0; i<m_nodes; i++ )
+    {
+        m_Tv[i] = DFM::Thdiff * m_x[i];
+    }
+
+    m_Jday    = prototype.m_Jday;
+    m_Year    = prototype.m_Year;
+    m_Month   = prototype.m_Month;
+    m_Day     = prototype.m_Day;
+    m_Hour    = prototype.m_Hour;
+    m_obstime = prototype.obstime;
+    m_updates = prototype.m_updates;
+    m_elapsed = prototype.m_elapsed;
+
+    size_t nl = (size_t) m_lanes;
+    size_t nn = (size_t) m_nodes * nl;
+    vector<double>* laneArrays[] = {
+        &m_density, &m_hc, &m_rai0, &m_rai1, &m_stca, &m_stcd, &m_stv,
+        &m_wfilmk, &m_wmx, &m_wmax, &m_amlf, &m_capf, &m_hwf, &m_vf,
+        &m_bp0, &m_ha0, &m_rc0, &m_sv0, &m_ta0,
+        &m_bp1, &m_et, &m_ha1, &m_rc1, &m_sv1, &m_ta1,
+        &m_pptrate, &m_ra0, &m_ra1, &m_rdur,
+        &m_hf, &m_wsa, &m_sem, &m_wfilm,
+        &m_bp, &m_wdiff, &m_gnu, &m_rai0Step, &m_rai1Step
+    };
+    for ( size_t a=0; a<sizeof(laneArrays)/sizeof(laneArrays[0]); a++ )
+    {
+        laneArrays[a]->assign( nl, 1.0 );
+    }
+    vector<double>* nodeArrays[] = {
+        &m_t, &m_s, &m_d, &m_w, &m_Ttold, &m_Tsold, &m_Twold, &m_To, &m_Tg
+    };
+    for ( size_t a=0; a<sizeof(nodeArrays)/sizeof(nodeArrays[0]); a++ )
+    {
+        nodeArrays[a]->assign( nn, 0.0 );
+    }
+    m_state.assign( nl, DFM_State_None );
+    m_init.assign( nl, 0 );
+    m_active.assign( nl, 0 );
+    m_moving.assign( nl, 0 );
+    m_column.assign( nl, 0 );
+    m_tstate.assign( (size_t) DFM::DFM_States * nl, 0 );
+    m_dTable.assign( nl, (const DFMDiffusivityTable*) NULL );
+
+    for ( int k=0; k<m_lanes; k++ )
+    {
+        setStick( k, prototype );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if \a stick can share this batch.
+
+    \retval TRUE if the stick geometry and step counts match the batch and
+    the stick does not use random perturbation, the equilibrium fast
+    path, a shared forcing, the implicit solver or the SIMD diffusivity
+    kernels.
+ */
+
+bool DeadFuelMoistureBatch::compatible( const DeadFuelMoisture& stick ) const
+{
+    return( stick.m_nodes == m_nodes
+         && stick.m_mSteps == m_mSteps
+         && stick.m_dSteps == m_dSteps
+         && stick.m_radius == m_proto.m_radius
+         && stick.m_length == m_proto.m_length
+         && stick.m_allowRainfall2 == m_allowRainfall2
+         && stick.m_allowRainstorm == m_allowRainstorm
+         && stick.m_rampRai0 == m_rampRai0
+         && stick.m_tabulatedDiffusivity == m_proto.m_tabulatedDiffusivity
+         && stick.m_randseed == 0
+         && ! stick.m_pertubateColumn
+         && ! stick.m_equilibriumSkip
+         && ! stick.m_forcing
+         && ! stick.m_implicitSolver
+         && ! stick.m_simdDiffusivity
+         && (int) stick.m_t.size() == m_nodes );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Loads the parameters, environment and nodal profile of \a stick
+    into \a lane.
+
+    The batch observation clock is not changed.
+
+    \retval TRUE if the stick was loaded.
+    \retval FALSE if \a lane is out of range or the stick is not compatible().
+ */
+
+bool DeadFuelMoistureBatch::setStick( int lane, const DeadFuelMoisture& stick )
+{
+    if ( lane < 0 || lane >= m_lanes || ! compatible( stick ) )
+    {
+        return( false );
+    }
+    int k = lane;
+    m_density[k] = stick.m_density;
+    m_hc[k]      = stick.m_hc;
+    m_rai0[k]    = stick.m_rai0;
+    m_rai1[k]    = stick.m_rai1;
+    m_stca[k]    = stick.m_stca;
+    m_stcd[k]    = stick.m_stcd;
+    m_stv[k]     = stick.m_stv;
+    m_wfilmk[k]  = stick.m_wfilmk;
+    m_wmx[k]     = stick.m_wmx;
+    m_wmax[k]    = stick.m_wmax;
+    m_amlf[k]    = stick.m_amlf;
+    m_capf[k]    = stick.m_capf;
+    m_hwf[k]     = stick.m_hwf;
+    m_vf[k]      = stick.m_vf;
+    m_bp0[k]     = stick.m_bp0;
+    m_ha0[k]     = stick.m_ha0;
+    m_rc0[k]     = stick.m_rc0;
+    m_sv0[k]     = stick.m_sv0;
+    m_ta0[k]     = stick.m_ta0;
+    m_bp1[k]     = stick.m_bp1;
+    m_et[k]      = stick.m_et;
+    m_ha1[k]     = stick.m_ha1;
+    m_rc1[k]     = stick.m_rc1;
+    m_sv1[k]     = stick.m_sv1;
+    m_ta1[k]     = stick.m_ta1;
+    m_pptrate[k] = stick.m_pptrate;
+    m_ra0[k]     = stick.m_ra0;
+    m_ra1[k]     = stick.m_ra1;
+    m_rdur[k]    = stick.m_rdur;
+    m_hf[k]      = stick.m_hf;
+    m_wsa[k]     = stick.m_wsa;
+    m_sem[k]     = stick.m_sem;
+    m_wfilm[k]   = stick.m_wfilm;
+    m_state[k]   = stick.m_state;
+    m_init[k]    = stick.m_init;
+    m_dTable[k]  = stick.m_tabulatedDiffusivity
+                 ? DFMDiffusivityTable::instance( stick.m_density ) : NULL;
+    for ( int i=0; i<m_nodes; i++ )
+    {
+        size_t ik = (size_t) i * m_lanes + k;
+        m_t[ik] = stick.m_t[i];
+        m_s[ik] = stick.m_s[i];
+        m_d[ik] = stick.m_d[i];
+        m_w[ik] = stick.m_w[i];
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Stores \a lane into \a stick, which afterwards behaves exactly
+    as if it had been updated by itself.
+
+    \retval TRUE if the lane was stored.
+    \retval FALSE if \a lane is out of range.
+ */
+
+bool DeadFuelMoistureBatch::getStick( int lane, DeadFuelMoisture& stick ) const
+{
+    if ( lane < 0 || lane >= m_lanes )
+    {
+        return( false );
+    }
+    int k = lane;
+    stick = m_proto;
+    stick.m_Twold.assign( m_nodes, 0.0 );
+    stick.m_Ttold.assign( m_nodes, 0.0 );
+    stick.m_Tsold.assign( m_nodes, 0.0 );
+    stick.m_Tv.assign( m_nodes, 0.0 );
+    stick.m_To.assign( m_nodes, 0.0 );
+    stick.m_Tg.assign( m_nodes, 0.0 );
+    stick.m_Tc.assign( 7 * m_nodes, 0.0 );
+    stick.m_Tw0.assign( m_nodes, 0.0 );
+    stick.m_Tt0.assign( m_nodes, 0.0 );
+    stick.m_coefStep = 0;
+
+    stick.m_Jday    = m_Jday;
+    stick.m_Year    = m_Year;
+    stick.m_Month   = m_Month;
+    stick.m_Day     = m_Day;
+    stick.m_Hour    = m_Hour;
+    stick.obstime   = m_obstime;
+    stick.m_updates = m_updates;
+    stick.m_elapsed = m_elapsed;
+
+    stick.m_density = m_density[k];
+    stick.m_hc      = m_hc[k];
+    stick.m_rai0    = m_rai0[k];
+    stick.m_rai1    = m_rai1[k];
+    stick.m_stca    = m_stca[k];
+    stick.m_stcd    = m_stcd[k];
+    stick.m_stv     = m_stv[k];
+    stick.m_wfilmk  = m_wfilmk[k];
+    stick.m_wmx     = m_wmx[k];
+    stick.m_wmax    = m_wmax[k];
+    stick.m_amlf    = m_amlf[k];
+    stick.m_capf    = m_capf[k];
+    stick.m_hwf     = m_hwf[k];
+    stick.m_vf      = m_vf[k];
+    stick.m_bp0     = m_bp0[k];
+    stick.m_ha0     = m_ha0[k];
+    stick.m_rc0     = m_rc0[k];
+    stick.m_sv0     = m_sv0[k];
+    stick.m_ta0     = m_ta0[k];
+    stick.m_bp1     = m_bp1[k];
+    stick.m_et      = m_et[k];
+    stick.m_ha1     = m_ha1[k];
+    stick.m_rc1     = m_rc1[k];
+    stick.m_sv1     = m_sv1[k];
+    stick.m_ta1     = m_ta1[k];
+    stick.m_pptrate = m_pptrate[k];
+    stick.m_ra0     = m_ra0[k];
+    stick.m_ra1     = m_ra1[k];
+    stick.m_rdur    = m_rdur[k];
+    stick.m_hf      = m_hf[k];
+    stick.m_wsa     = m_wsa[k];
+    stick.m_sem     = m_sem[k];
+    stick.m_wfilm   = m_wfilm[k];
+    stick.m_state   = m_state[k];
+    stick.m_init    = m_init[k] != 0;
+    // Step intervals derived by update() from the lane's last elapsed time
+    if ( m_et[k] > 0.0 && m_mSteps > 0 && m_dSteps > 0 )
+    {
+        stick.m_mdt   = m_et[k] / (double) m_mSteps;
+        stick.m_mdt_2 = stick.m_mdt * 2.;
+        stick.m_sf    = 3600. * stick.m_mdt / ( stick.m_dx_2 * stick.m_density );
+        stick.m_ddt   = m_et[k] / (double) m_dSteps;
+    }
+    for ( int i=0; i<m_nodes; i++ )
+    {
+        size_t ik = (size_t) i * m_lanes + k;
+        stick.m_t[i] = m_t[ik];
+        stick.m_s[i] = m_s[ik];
+        stick.m_d[i] = m_d[ik];
+        stick.m_w[i] = m_w[ik];
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines bound water diffusivity at each radial node of every
+    active lane.
+
+    Lane-wise transcription of DeadFuelMoisture::diffusivity().
+
+    \param[in] bp Per-lane barometric pressure (cal/m3)
+ */
+
+void DeadFuelMoistureBatch::diffusivity( const double* bp )
+{
+    if ( m_proto.m_tabulatedDiffusivity )
+    {
+        interpolateDiffusivity( bp );
+        return;
+    }
+    const int nl = m_lanes;
+    const char* active = &m_active[0];
+    const double* hf  = &m_hf[0];
+    const double* wsa = &m_wsa[0];
+    const double* density = &m_density[0];
+    for ( int i=0; i<m_nodes; i++ )
+    {
+        const double* t = &m_t[(size_t) i * nl];
+        const double* w = &m_w[(size_t) i * nl];
+        double* d = &m_d[(size_t) i * nl];
+        for ( int k=0; k<nl; k++ )
+        {
+            if ( ! active[k] )
+            {
+                continue;
+            }
+            // Stick temperature (oK)
+            double tk   = t[k] + 273.2;
+            // Latent heat of vaporization of water (cal/mol)
+            double qv   = 13550. - 10.22 * tk;
+            // Specific heat of water vapor (cal/(mol*K))
+            double cpv  = 7.22 + .002374 * tk + 2.67e-07 * tk * tk;
+            // Sea level atmospheric pressure = 0.0242 cal/cm3
+            double dv   = 0.22 * 3600. * ( 0.0242 / bp[k] )
+                        * pow( ( tk / 273.2 ), 1.75 );
+            // Water saturation vapor pressure at surface temp (cal/cm3)
+            double ps1  = 0.0000239 * exp(20.58 - (5205. / tk));
+            // Emc sorption isotherm parameters (g/g)
+            double c1   = 0.1617 - 0.001419 * t[k];
+            double c2   = 0.4657 + 0.003578 * t[k];
+            // Lesser of nodal or fiber saturation moisture (g/g)
+            double wc;
+            // Reciprocal slope of the sorption isotherm
+            double dhdm = 0.0;
+            if ( w[k] < wsa[k] )
+            {
+                wc = w[k];
+                if ( c2 != 1. && hf[k]<1.0 && c1 != 0.0 && c2 != 0.0 )
+                {
+                    dhdm = (1.0 - hf[k]) * pow(-log(1.0-hf[k]), (1.0 - c2))
+                         / (c1 * c2);
+                }
+            }
+            else
+            {
+                wc = wsa[k];
+                if ( c2 != 1. && DFM::Hfs<1.0 && c1 != 0.0 && c2 != 0.0 )
+                {
+                    dhdm = (1.0 - DFM::Hfs) * pow(DFM::Wsf, (1.0 - c2)) / (c1 * c2);
+                }
+            }
+            double daw  = 1.3 - 0.64 * wc;
+            double svaw = 1. / daw;
+            double vfaw = svaw * wc / (0.685 + svaw * wc);
+            double vfcw = (0.685 + svaw * wc) / ((1.0 / density[k]) + svaw * wc);
+            double rfcw = 1.0 - sqrt(1.0 - vfcw);
+            double fac  = 1.0 / (rfcw * vfcw);
+            double con  = 1.0 / (2.0 - vfaw);
+            double qw   = 5040. * exp(-14.0 * wc);
+            double e    = (qv + qw - cpv * tk) / 1.2;
+            double dvpr = 18.0 * 0.016 * (1.0-vfcw) * dv * ps1 * dhdm
+                        / ( density[k] * 1.987 * tk );
+            d[k] = dvpr + 3600. * 0.0985 * con * fac * exp(-e/(1.987*tk));
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines bound water diffusivity at each radial node of every
+    active lane from the lanes' DFMDiffusivityTable.
+
+    Lane-wise transcription of DeadFuelMoisture::interpolateDiffusivity().
+
+    \param[in] bp Per-lane barometric pressure (cal/m3)
+ */
+
+void DeadFuelMoistureBatch::interpolateDiffusivity( const double* bp )
+{
+    const int nl = m_lanes;
+    for ( int k=0; k<nl; k++ )
+    {
+        if ( ! m_active[k] )
+        {
+            continue;
+        }
+        const DFMDiffusivityTable* table = m_dTable[k];
+        double hf    = m_hf[k];
+        double wsa   = m_wsa[k];
+        bool   hfOk  = ( hf > 0.0 && hf < 1.0 );
+        double hfLog = hfOk ? log( -log( 1.0 - hf ) ) : 0.0;
+        double rbp   = 1.0 / bp[k];
+        for ( int i=0; i<m_nodes; i++ )
+        {
+            size_t ik = (size_t) i * nl + k;
+            double a, b, dhdm;
+            if ( m_w[ik] < wsa )
+            {
+                table->terms( m_t[ik], m_w[ik], &a, &b );
+                double c2 = 0.4657 + 0.003578 * m_t[ik];
+                dhdm = hfOk ? ( 1.0 - hf ) * exp( ( 1.0 - c2 ) * hfLog ) : 0.0;
+            }
+            else
+            {
+                table->terms( m_t[ik], wsa, &a, &b );
+                dhdm = table->saturatedSlope( m_t[ik] );
+            }
+            m_d[ik] = a * dhdm * rbp + b;
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Updates every lane from the current weather observation values.
+
+    Date and time version; see DeadFuelMoisture::update().  Elapsed time is
+    determined from the shared batch clock.
+
+    \param[in] year     Observation year (4 digits).
+    \param[in] month    Observation month (Jan==1, Dec==12).
+    \param[in] day      Observation day-of-the-month [1..31].
+    \param[in] hour     Observation elapsed hours in the day [0..23].
+    \param[in] minute   Observation elapsed minutes in the hour (0..59].
+    \param[in] second   Observation elapsed seconds in the minute [0..59].
+    \param[in] at   Per-lane ambient air temperature (oC).
+    \param[in] rh   Per-lane ambient air relative humidity (g/g).
+    \param[in] sW   Per-lane solar radiation (W/m2).
+    \param[in] rcum Per-lane total cumulative rainfall amount (cm), or the
+                    period amount if \a prcpAsAmnt is TRUE.
+    \param[in] bpr  Barometric pressure (cal/cm3).
+    \param[in] prcpAsAmnt If TRUE, \a rcum is the period amount.
+    \param[out] updated Optional per-lane flag set TRUE if the lane's inputs
+                    were accepted and the lane was updated.
+
+    \return Number of lanes updated.
+ */
+
+int DeadFuelMoistureBatch::update(
+        int     year,
+        int     month,
+        int     day,
+        int     hour,
+        int     minute,
+        int     second,
+        const double* at,
+        const double* rh,
+        const double* sW,
+        const double* rcum,
+        double  bpr,
+        bool    prcpAsAmnt,
+        bool*   updated
+    )
+{
+    int jDay = 1;
+    time_t loctime = mkgmtime(year, month, day, hour, minute, second, &jDay);
+    double seconds = (double) (loctime - m_obstime);
+    m_Hour = hour;
+    m_Day = day;
+    m_Month = month;
+    m_Year = year;
+    m_Jday = jDay;
+    m_obstime = loctime;
+
+    // Determine elapsed time (h) between the current and previous dates
+    double et = seconds / 3600;
+    if ( m_updates == 0 ) et = 1;
+    return( update( et, at, rh, sW, rcum, bpr, prcpAsAmnt, updated ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Updates every lane from the current weather observation values.
+
+    Elapsed time version; see DeadFuelMoisture::update().  Lanes whose
+    inputs are out of range are left untouched, exactly as the scalar class
+    leaves a stick untouched when update() returns FALSE.
+
+    \param[in] et   Elapsed time since the previous observation (h).
+    \param[in] at   Per-lane ambient air temperature (oC).
+    \param[in] rh   Per-lane ambient air relative humidity (g/g).
+    \param[in] sW   Per-lane solar radiation (W/m2).
+    \param[in] rcum Per-lane total cumulative rainfall amount (cm), or the
+                    period amount if \a prcpAsAmnt is TRUE.
+    \param[in] bpr  Barometric pressure (cal/cm3).
+    \param[in] prcpAsAmnt If TRUE, \a rcum is the period amount.
+    \param[out] updated Optional per-lane flag set TRUE if the lane's inputs
+                    were accepted and the lane was updated.
+
+    \return Number of lanes updated.
+ */
+
+int DeadFuelMoistureBatch::update(
+        double  et,
+        const double* at,
+        const double* rh,
+        const double* sW,
+        const double* rcum,
+        double  bpr,
+        bool    prcpAsAmnt,
+        bool*   updated
+    )
+{
+    const int nl = m_lanes;
+    const int nn = m_nodes;
+    m_updates++;
+    m_elapsed += et;
+
+    // Moisture and diffusivity computation time step intervals (h)
+    const double mdt   = et / (double) m_mSteps;
+    const double mdt_2 = mdt * 2.;
+    const double ddt   = et / (double) m_dSteps;
+
+    //--------------------------------------------------------------------------
+    // Screen each lane's observation exactly as DeadFuelMoisture::update()
+    //--------------------------------------------------------------------------
+    int nActive = 0;
+    for ( int k=0; k<nl; k++ )
+    {
+        m_active[k] = 0;
+        if ( updated )
+        {
+            updated[k] = false;
+        }
+        const char* reason = NULL;
+        DiagnosticCode code = Diag_RegressiveTime;
+        double value = 0.0;
+        double sw = sW[k];
+        if ( et < 0.0000027 )
+        {
+            reason = " has a regressive elapsed time of ";
+            value = et;
+        }
+        else if ( rcum[k] < m_rc1[k] && ! prcpAsAmnt )
+        {
+            reason = " has a regressive cumulative rainfall amount of ";
+            code = Diag_RegressiveRainfall;
+            value = rcum[k];
+            // Assume a RAWS station reset
+            m_rc1[k] = rcum[k];
+            m_ra0[k] = 0.;
+        }
+        else if ( rh[k] < 0.001 || rh[k] > 1.0 )
+        {
+            reason = " has a an out-of-range relative humidity of  ";
+            code = Diag_HumidityRange;
+            value = rh[k];
+        }
+        else if ( at[k] < -60. || at[k] > 60. )
+        {
+            reason = " has a an out-of-range air temperature of  ";
+            code = Diag_TemperatureRange;
+            value = at[k];
+        }
+        else
+        {
+            sw = ( sw < 0.0 ) ? 0.0 : sw;
+            if ( sw > 2000. )
+            {
+                reason = " has a an out-of-range solar insolation of  ";
+                code = Diag_InsolationRange;
+                value = sw;
+            }
+        }
+        if ( reason )
+        {
+            if ( Diagnostics::report( code ) )
+            {
+                ostringstream str;
+                str << "DeadFuelMoistureBatch::update() "
+                    << m_updates
+                    << " lane "
+                    << k
+                    << reason
+                    << value;
+                Diagnostics::message( code, str.str() );
+            }
+            continue;
+        }
+
+        // Previous and current weather observation values
+        m_ta0[k] = m_ta1[k];
+        m_ha0[k] = m_ha1[k];
+        m_sv0[k] = m_sv1[k];
+        m_rc0[k] = m_rc1[k];
+        m_ra0[k] = m_ra1[k];
+        m_bp0[k] = m_bp1[k];
+        m_ta1[k] = at[k];
+        m_ha1[k] = rh[k];
+        m_sv1[k] = sw / DFM::Smv;
+        m_rc1[k] = rcum[k];
+        m_bp1[k] = bpr;
+        m_et[k]  = et;
+
+        // Precipitation amount since last observation
+        m_ra1[k] = ( ! prcpAsAmnt ) ? m_rc1[k] - m_rc0[k] : rcum[k];
+        // If no precipitation, reset the precipitation duration timer
+        m_rdur[k] = ( m_ra1[k] < 0.0001 ) ? 0.0 : m_rdur[k];
+        // Precipitation rate since last observation adjusted by Pi (cm/h)
+        m_pptrate[k] = m_ra1[k] / et / DFM::Pi;
+        // First hour runoff factor h-(g/(g-h))
+        double rai0 = mdt * m_rai0[k] * ( 1.0 - exp(-100. * m_pptrate[k]) );
+        // Adjustment for rainfall cases when humidity is dropping
+        if ( m_ha1[k] < m_ha0[k] )
+        {
+            if ( m_rampRai0 )
+            {
+                rai0 *= ( 1.0 - ( ( m_ha0[k] - m_ha1[k] ) / m_ha0[k] ) );
+            }
+            else
+            {
+                rai0 *= 0.15;
+            }
+        }
+        m_rai0Step[k] = rai0;
+        // Subsequent runoff factor h-(g/(g/h))
+        m_rai1Step[k] = mdt * m_rai1[k] * m_pptrate[k];
+        for ( int j=0; j<DFM::DFM_States; j++ )
+        {
+            m_tstate[(size_t) j * nl + k] = 0;
+        }
+        m_active[k] = 1;
+        if ( updated )
+        {
+            updated[k] = true;
+        }
+        nActive++;
+    }
+    if ( nActive == 0 )
+    {
+        return( 0 );
+    }
+
+    // Per-node inverse moisture time step weights, as in the scalar loops
+    vector<double> ar( nn, 0.0 );
+    for ( int i=1; i<nn-1; i++ )
+    {
+        ar[i] = m_x[i] * m_dx / mdt;
+    }
+
+    char* active   = &m_active[0];
+    char* moving   = &m_moving[0];
+    char* column   = &m_column[0];
+    double* wdiffv = &m_wdiff[0];
+    double* gnuv   = &m_gnu[0];
+    double* bpv    = &m_bp[0];
+
+    // Next time (tt) to run diffusivity computations.
+    double ddtNext = ddt;
+    // Elapsed moisture computation time (h)
+    double tt = mdt;
+    // Loop for each moisture time step between environmental inputs.
+    for ( int nstep=1; tt <= et; tt = nstep*mdt, nstep++ )
+    {
+        double tfract = tt / et;
+
+        //----------------------------------------------------------------------
+        // Stick surface temperature, humidity and moisture content, per lane
+        //----------------------------------------------------------------------
+        for ( int k=0; k<nl; k++ )
+        {
+            moving[k] = 0;
+            if ( ! active[k] )
+            {
+                continue;
+            }
+            double ta = m_ta0[k] + ( m_ta1[k] - m_ta0[k] ) * tfract;
+            double ha = m_ha0[k] + ( m_ha1[k] - m_ha0[k] ) * tfract;
+            double sv = m_sv0[k] + ( m_sv1[k] - m_sv0[k] ) * tfract;
+            double bp = m_bp0[k] + ( m_bp1[k] - m_bp0[k] ) * tfract;
+            bpv[k] = bp;
+            double fsc = sv / DFM::Srf;
+            double tka = ta + DFM::Kelvin;
+            double tdw = 5205. / ( ( 5205. / tka ) - log( ha ) );
+            double tdp = tdw - DFM::Kelvin;
+            double tsk = ( fsc < 0.000001 ) ? DFM::Tcn + DFM::Kelvin : DFM::Tcd + DFM::Kelvin;
+            double hr  = ( fsc < 0.000001 ) ? DFM::Hrn : DFM::Hrd ;
+            double sr  = ( fsc < 0.000001 ) ? 0.0 : DFM::Srf * fsc;
+            double psa = 0.0000239 * exp( 20.58 - ( 5205. / tka ) );
+            double pa  = ha * psa;
+            double psd = 0.0000239 * exp( 20.58 - ( 5205. / tdw ) );
+            m_rdur[k] = ( m_ra1[k] > 0.0001 ) ? ( m_rdur[k] + mdt ) : 0.;
+
+            double tfd = ta + ( sr - hr * ( ta - tsk + DFM::Kelvin ) ) / ( hr + m_hc[k] );
+            double qv  = 13550. - 10.22 * ( tfd + DFM::Kelvin );
+            double hw  = ( m_hwf[k] * DFM::Ap / 0.24 ) * qv / 18.;
+            double t0  = tfd - ( hw * ( tfd - ta ) / ( hr + m_hc[k] + hw ) );
+            double w0  = m_w[k];
+            double qw  = 5040. * exp( -14. * w0 );
+            double tkf = t0 + DFM::Kelvin;
+            double gnu = 0.00439 + 0.00000177 * pow( ( 338.76 - tkf ), 2.1237 );
+            double c1  = 0.1617 - 0.001419 * t0;
+            double c2  = 0.4657 + 0.003578 * t0;
+            double wsa = c1 * pow( DFM::Wsf, c2 );
+            double wdiff = m_wmax[k] - wsa;
+            wdiff = ( wdiff < 0.000001 ) ? 0.000001 : wdiff;
+            double ps1 = 0.0000239 * exp( 20.58 - ( 5205. / tkf ) );
+            double p1  = pa + DFM::Ap * bp * ( qv / (qv + qw) ) * ( tka - tkf );
+            p1 = ( p1 < 0.000001 ) ? 0.000001 : p1;
+            double hf = p1 / ps1;
+            hf = ( hf > DFM::Hfs ) ? DFM::Hfs : hf;
+            double hf_log = -log( 1. - hf );
+            double sem = c1 * pow( hf_log, c2 );
+
+            int state = DFM_State_None;
+            double wfilm = 0.;
+            double aml = 0.0;
+            double bi  = 0.0;
+            double s_new = m_s[k];
+            double w_new = w0;
+            double w_old = w0;
+
+            if ( m_ra1[k] > 0.0 )
+            {
+                if ( m_allowRainstorm && m_pptrate[k] >= m_stv[k] )
+                {
+                    state = DFM_State_Rainstorm;
+                    wfilm = m_wfilmk[k];
+                    w_new = m_wmx[k];
+                }
+                else
+                {
+                    if ( m_rdur[k] < 1.0 || ! m_allowRainfall2 )
+                    {
+                        state = DFM_State_Rainfall1;
+                        w_new = w_old + m_rai0Step[k];
+                    }
+                    else
+                    {
+                        state = DFM_State_Rainfall2;
+                        w_new = w_old + m_rai1Step[k];
+                    }
+                }
+                wfilm = m_wfilmk[k];
+                s_new = ( w_new - wsa ) / wdiff;
+                t0 = tfd;
+                hf = DFM::Hfs;
+            }
+            else
+            {
+                if ( w_old > wsa )
+                {
+                    p1 = ps1;
+                    hf = DFM::Hfs;
+                    aml = m_amlf[k] * (ps1 - psd) / bp;
+                    if ( t0 <= tdp && p1 > psd )
+                    {
+                        aml = 0.;
+                    }
+                    w_new = w_old - aml * mdt_2;
+                    if ( aml > 0. )
+                    {
+                        w_new -= ( mdt * m_capf[k] / gnu );
+                    }
+                    w_new = ( w_new > m_wmx[k] ) ? m_wmx[k] : w_new;
+                    s_new = ( w_new - wsa ) / wdiff;
+                    if ( w_new > w_old )
+                    {
+                        state = DFM_State_Condensation1;
+                    }
+                    else if ( w_new == w_old )
+                    {
+                        state = DFM_State_Stagnation;
+                    }
+                    else if ( w_new < w_old )
+                    {
+                        state = DFM_State_Evaporation;
+                    }
+                }
+                else if ( t0 <= tdp )
+                {
+                    state = DFM_State_Condensation2;
+                    aml = ( p1 > psd ) ? 0.0 : m_amlf[k] * (p1 - psd) / bp;
+                    w_new = w_old - aml * mdt_2;
+                    s_new = ( w_new - wsa ) / wdiff;
+                }
+                else
+                {
+                    if ( w_old >= sem )
+                    {
+                        state = DFM_State_Desorption;
+                        bi = m_stcd[k] * m_dx / m_d[k];
+                    }
+                    else
+                    {
+                        state = DFM_State_Adsorption;
+                        bi = m_stca[k] * m_dx / m_d[k];
+                    }
+                    w_new = ( m_w[(size_t) nl + k] + bi * sem ) / ( 1. + bi );
+                    s_new = 0.;
+                }
+            }
+
+            m_t[k] = t0;
+            m_w[k] = ( w_new > m_wmx[k] ) ? m_wmx[k] : w_new;
+            m_s[k] = ( s_new < 0. ) ? 0.0 : s_new;
+            m_hf[k]    = hf;
+            m_wsa[k]   = wsa;
+            m_sem[k]   = sem;
+            m_wfilm[k] = wfilm;
+            m_state[k] = state;
+            m_tstate[(size_t) state * nl + k]++;
+            wdiffv[k] = wdiff;
+            gnuv[k]   = gnu;
+            moving[k] = ( state != DFM_State_Stagnation ) ? 1 : 0;
+        }
+
+        //----------------------------------------------------------------------
+        // Interior nodes, vectorized across lanes
+        //----------------------------------------------------------------------
+        std::copy( m_w.begin(), m_w.end(), m_Twold.begin() );
+        std::copy( m_s.begin(), m_s.end(), m_Tsold.begin() );
+        std::copy( m_t.begin(), m_t.end(), m_Ttold.begin() );
+        for ( int i=0; i<nn; i++ )
+        {
+            const double xi = m_x[i];
+            const double* d = &m_d[(size_t) i * nl];
+            double* o = &m_To[(size_t) i * nl];
+            for ( int k=0; k<nl; k++ )
+            {
+                o[k] = d[k] * xi;
+            }
+        }
+
+        // Free water transport coefficients
+        const double* wsa = &m_wsa[0];
+        const double* vf  = &m_vf[0];
+        for ( int i=0; i<nn; i++ )
+        {
+            const double xi = m_x[i];
+            const double* w = &m_w[(size_t) i * nl];
+            double* g = &m_Tg[(size_t) i * nl];
+            for ( int k=0; k<nl; k++ )
+            {
+                double gk = 0.0;
+                double svp = ( w[k] - wsa[k] ) / wdiffv[k];
+                if ( moving[k] && svp >= DFM::Sir && svp <= DFM::Scr )
+                {
+                    double ak = DFM::Aks * ( 2. * sqrt( svp / DFM::Scr ) - 1. );
+                    gk = ( ak / ( gnuv[k] * wdiffv[k] ) )
+                       * xi * vf[k]
+                       * pow( ( DFM::Scr / svp ), 1.5 ) ;
+                }
+                g[k] = gk;
+            }
+        }
+
+        // Propagate the fiber saturation moisture content changes
+        for ( int i=1; i<nn-1; i++ )
+        {
+            const double ari = ar[i];
+            const double* ge = &m_Tg[(size_t) (i+1) * nl];
+            const double* gw = &m_Tg[(size_t) (i-1) * nl];
+            const double* se = &m_Tsold[(size_t) (i+1) * nl];
+            const double* sw = &m_Tsold[(size_t) (i-1) * nl];
+            const double* sp = &m_Tsold[(size_t) i * nl];
+            double* s = &m_s[(size_t) i * nl];
+            for ( int k=0; k<nl; k++ )
+            {
+                double ae = ge[k] / m_dx;
+                double aw = gw[k] / m_dx;
+                double ap = ae + aw + ari;
+                double sk = ( ae * se[k] + aw * sw[k] + ari * sp[k] ) / ap;
+                sk = ( sk > DFM::Sir ) ? DFM::Sir : sk;
+                sk = ( sk < 0. ) ? 0. : sk;
+                s[k] = moving[k] ? sk : s[k];
+            }
+        }
+        {
+            const double* sIn = &m_s[(size_t) (nn-2) * nl];
+            double* sOut = &m_s[(size_t) (nn-1) * nl];
+            for ( int k=0; k<nl; k++ )
+            {
+                sOut[k] = moving[k] ? sIn[k] : sOut[k];
+            }
+        }
+
+        // Determine which lanes have continuous liquid columns at every node
+        for ( int k=0; k<nl; k++ )
+        {
+            column[k] = 1;
+        }
+        for ( int i=1; i<nn-1; i++ )
+        {
+            const double* s = &m_s[(size_t) i * nl];
+            for ( int k=0; k<nl; k++ )
+            {
+                column[k] = ( s[k] < DFM::Sir ) ? 0 : column[k];
+            }
+        }
+
+        // Propagate the moisture content changes
+        const double* wmx = &m_wmx[0];
+        for ( int i=1; i<nn-1; i++ )
+        {
+            const double ari = ar[i];
+            const double* oe = &m_To[(size_t) (i+1) * nl];
+            const double* ow = &m_To[(size_t) (i-1) * nl];
+            const double* we = &m_Twold[(size_t) (i+1) * nl];
+            const double* ww = &m_Twold[(size_t) (i-1) * nl];
+            const double* wp = &m_Twold[(size_t) i * nl];
+            const double* s = &m_s[(size_t) i * nl];
+            double* w = &m_w[(size_t) i * nl];
+            for ( int k=0; k<nl; k++ )
+            {
+                double wk;
+                if ( column[k] )
+                {
+                    wk = wsa[k] + s[k] * wdiffv[k];
+                }
+                else
+                {
+                    double ae = oe[k] / m_dx;
+                    double aw = ow[k] / m_dx;
+                    double ap = ae + aw + ari;
+                    wk = ( ae * we[k] + aw * ww[k] + ari * wp[k] ) / ap;
+                }
+                wk = ( wk > wmx[k] ) ? wmx[k] : wk;
+                wk = ( wk < 0.0 ) ? 0.0 : wk;
+                w[k] = moving[k] ? wk : w[k];
+            }
+        }
+        {
+            const double* wIn = &m_w[(size_t) (nn-2) * nl];
+            double* wOut = &m_w[(size_t) (nn-1) * nl];
+            for ( int k=0; k<nl; k++ )
+            {
+                wOut[k] = moving[k] ? wIn[k] : wOut[k];
+            }
+        }
+
+        // Propagate the fuel temperature changes
+        for ( int i=1; i<nn-1; i++ )
+        {
+            const double ari = ar[i];
+            const double ae = m_Tv[i+1] / m_dx;
+            const double aw = m_Tv[i-1] / m_dx;
+            const double ap = ae + aw + ari;
+            const double* te = &m_Ttold[(size_t) (i+1) * nl];
+            const double* tw = &m_Ttold[(size_t) (i-1) * nl];
+            const double* tp = &m_Ttold[(size_t) i * nl];
+            double* t = &m_t[(size_t) i * nl];
+            for ( int k=0; k<nl; k++ )
+            {
+                double tk = ( ae * te[k] + aw * tw[k] + ari * tp[k] ) / ap;
+                tk = ( tk > 71. ) ? 71. : tk;
+                t[k] = active[k] ? tk : t[k];
+            }
+        }
+        {
+            const double* tIn = &m_t[(size_t) (nn-2) * nl];
+            double* tOut = &m_t[(size_t) (nn-1) * nl];
+            for ( int k=0; k<nl; k++ )
+            {
+                tOut[k] = active[k] ? tIn[k] : tOut[k];
+            }
+        }
+
+        // Update the moisture diffusivity if within less than half a time step
+        if ( ( ddtNext - tt ) < ( 0.5 * mdt ) )
+        {
+            diffusivity( bpv );
+            ddtNext += ddt;
+        }
+    }   // Next moisture time step
+
+    // Store prevailing state
+    for ( int k=0; k<nl; k++ )
+    {
+        if ( ! active[k] )
+        {
+            continue;
+        }
+        int state = DFM_State_None;
+        int max = m_tstate[k];
+        for ( int j=1; j<DFM::DFM_States; j++ )
+        {
+            if ( m_tstate[(size_t) j * nl + k] > max )
+            {
+                state = j;
+                max = m_tstate[(size_t) j * nl + k];
+            }
+        }
+        m_state[k] = state;
+    }
+    return( nActive );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of lanes (sticks) in the batch.
+ */
+
+int DeadFuelMoistureBatch::lanes( void ) const
+{
+    return( m_lanes );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of radial nodes shared by every lane.
+ */
+
+int DeadFuelMoistureBatch::stickNodes( void ) const
+{
+    return( m_nodes );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of batch update() calls.
+ */
+
+long DeadFuelMoistureBatch::updates( void ) const
+{
+    return( m_updates );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the current total running elapsed time (h).
+ */
+
+double DeadFuelMoistureBatch::elapsedTime( void ) const
+{
+    return( m_elapsed );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Volume-weighted mean moisture content of \a lane (g/g).
+    \sa DeadFuelMoisture::meanWtdMoisture()
+ */
+
+double DeadFuelMoistureBatch::meanWtdMoisture( int lane ) const
+{
+    double wbr = 0.0;
+    for ( int i=0; i<m_nodes; i++ )
+    {
+        wbr += m_w[(size_t) i * m_lanes + lane] * m_v[i];
+    }
+    wbr = ( wbr > m_wmx[lane] ) ? m_wmx[lane] : wbr;
+    wbr += m_wfilm[lane];
+    return( wbr );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Median of the radial moisture profile of \a lane (g/g).
+    \sa DeadFuelMoisture::medianRadialMoisture()
+ */
+
+double DeadFuelMoistureBatch::medianRadialMoisture( int lane ) const
+{
+    vector<double> vMw( m_nodes );
+    for ( int i=0; i<m_nodes; i++ )
+    {
+        vMw[i] = m_w[(size_t) i * m_lanes + lane];
+    }
+    std::sort( vMw.begin(), vMw.end() );
+    return( vMw[(int) vMw.size() / 2] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Volume-weighted mean temperature of \a lane (oC).
+    \sa DeadFuelMoisture::meanWtdTemperature()
+ */
+
+double DeadFuelMoistureBatch::meanWtdTemperature( int lane ) const
+{
+    double wbr = 0.0;
+    for ( int i=0; i<m_nodes; i++ )
+    {
+        wbr += m_t[(size_t) i * m_lanes + lane] * m_v[i];
+    }
+    return( wbr );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Surface moisture content of \a lane (g/g).
+ */
+
+double DeadFuelMoistureBatch::surfaceMoisture( int lane ) const
+{
+    return( m_w[lane] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Surface temperature of \a lane (oC).
+ */
+
+double DeadFuelMoistureBatch::surfaceTemperature( int lane ) const
+{
+    return( m_t[lane] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Prevailing state of \a lane for its most recent update.
+ */
+
+int DeadFuelMoistureBatch::state( int lane ) const
+{
+    return( m_state[lane] );
+}
+
+//------------------------------------------------------------------------------
+//  End of deadfuelmoisturebatch.cpp
+//------------------------------------------------------------------------------
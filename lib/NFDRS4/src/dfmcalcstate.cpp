@@ -5,6 +5,10 @@ using namespace std;
 
 DFMCalcState::DFMCalcState()
 {
+	m_randseed = 0;
+	m_rngKey = 0;
+	m_rngCounter = 0;
+	m_hasRandomState = false;
 }
 
 DFMCalcState::DFMCalcState(const DFMCalcState &rhs)
@@ -35,6 +39,11 @@ DFMCalcState::DFMCalcState(const DFMCalcState &rhs)
 	m_s = rhs.m_s;
 	m_d = rhs.m_d;
 	m_w = rhs.m_w;
+
+	m_randseed = rhs.m_randseed;
+	m_rngKey = rhs.m_rngKey;
+	m_rngCounter = rhs.m_rngCounter;
+	m_hasRandomState = rhs.m_hasRandomState;
 }
 
 
@@ -230,3 +239,37 @@ bool DFMCalcState::SaveState(FILE *out)
 
 	return true;
 }
+
+bool DFMCalcState::ReadRandomState(FILE *in)
+{
+	int randseed;
+	unsigned long long key, counter;
+	size_t nRead = fread(&randseed, sizeof(randseed), 1, in);
+	if (nRead != 1)
+		return false;
+	nRead = fread(&key, sizeof(key), 1, in);
+	if (nRead != 1)
+		return false;
+	nRead = fread(&counter, sizeof(counter), 1, in);
+	if (nRead != 1)
+		return false;
+	m_randseed = randseed;
+	m_rngKey = key;
+	m_rngCounter = counter;
+	m_hasRandomState = true;
+	return true;
+}
+
+bool DFMCalcState::SaveRandomState(FILE *out)
+{
+	size_t nWrite = fwrite(&m_randseed, sizeof(m_randseed), 1, out);
+	if (nWrite != 1)
+		return false;
+	nWrite = fwrite(&m_rngKey, sizeof(m_rngKey), 1, out);
+	if (nWrite != 1)
+		return false;
+	nWrite = fwrite(&m_rngCounter, sizeof(m_rngCounter), 1, out);
+	if (nWrite != 1)
+		return false;
+	return true;
+}
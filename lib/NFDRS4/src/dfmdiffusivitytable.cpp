@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+/*! \file dfmdiffusivitytable.cpp
+    \brief DFMDiffusivityTable class definition and implementation.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Custom include files
+#include "dfmdiffusivitytable.h"
+
+// Grid layout
+static const double TableTMin  = -60.;      // Lowest tabulated temperature (oC)
+static const double TableTStep = 0.25;      // Temperature step (oC)
+static const int    TableTSize = 525;       // -60 to 71 oC
+static const double TableWStep = 0.0025;    // Moisture step (g/g)
+static const int    TableWSize = 161;       // 0 to 0.40 g/g
+
+// DeadFuelMoisture::Hfs and DeadFuelMoisture::Wsf
+static const double Hfs = 0.99;
+static const double Wsf = 4.60517;
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the shared table for sticks of \a density.
+
+    \param[in] density Stick density (g/cm3).
+
+    \return Pointer to the table, built on first use.
+ */
+
+const DFMDiffusivityTable* DFMDiffusivityTable::instance( double density )
+{
+    static std::mutex lock;
+    static std::map<double, DFMDiffusivityTable*> tables;
+    std::lock_guard<std::mutex> guard( lock );
+    std::map<double, DFMDiffusivityTable*>::iterator it = tables.find( density );
+    if ( it == tables.end() )
+    {
+        it = tables.insert( std::make_pair( density, new DFMDiffusivityTable( density ) ) ).first;
+    }
+    return( it->second );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Class constructor.
+
+    Evaluates the temperature and moisture dependent factors of
+    DeadFuelMoisture::diffusivity() at every grid point.
+
+    \param[in] density Stick density (g/cm3).
+ */
+
+DFMDiffusivityTable::DFMDiffusivityTable( double density ) :
+    m_density( density ),
+    m_ab( 2 * TableTSize * TableWSize ),
+    m_sat( TableTSize )
+{
+    for ( int j=0; j<TableTSize; j++ )
+    {
+        double t = TableTMin + j * TableTStep;
+        // Stick temperature (oK)
+        double tk   = t + 273.2;
+        // Latent heat of vaporization of water (cal/mol)
+        double qv   = 13550. - 10.22 * tk;
+        // Specific heat of water vapor (cal/(mol*K))
+        double cpv  = 7.22 + .002374 * tk + 2.67e-07 * tk * tk;
+        // Vapor diffusivity times barometric pressure
+        double dv   = 0.22 * 3600. * 0.0242 * pow( ( tk / 273.2 ), 1.75 );
+        // Water saturation vapor pressure at surface temp (cal/cm3)
+        double ps1  = 0.0000239 * exp(20.58 - (5205. / tk));
+        // Emc sorption isotherm parameters (g/g)
+        double c1   = 0.1617 - 0.001419 * t;
+        double c2   = 0.4657 + 0.003578 * t;
+        m_sat[j] = (1.0 - Hfs) * pow(Wsf, (1.0 - c2));
+        for ( int k=0; k<TableWSize; k++ )
+        {
+            double wc   = k * TableWStep;
+            double daw  = 1.3 - 0.64 * wc;
+            double svaw = 1. / daw;
+            double vfaw = svaw * wc / (0.685 + svaw * wc);
+            double vfcw = (0.685 + svaw * wc) / ((1.0 / density) + svaw * wc);
+            double rfcw = 1.0 - sqrt(1.0 - vfcw);
+            double fac  = 1.0 / (rfcw * vfcw);
+            double con  = 1.0 / (2.0 - vfaw);
+            double qw   = 5040. * exp(-14.0 * wc);
+            double e    = (qv + qw - cpv * tk) / 1.2;
+            double* ab  = &m_ab[2 * ( j * TableWSize + k )];
+            ab[0] = 18.0 * 0.016 * (1.0-vfcw) * dv * ps1
+                  / ( density * 1.987 * tk * c1 * c2 );
+            ab[1] = 3600. * 0.0985 * con * fac * exp(-e/(1.987*tk));
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the stick density the table was built for (g/cm3).
+ */
+
+double DFMDiffusivityTable::density( void ) const
+{
+    return( m_density );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Interpolated sorption isotherm slope numerator above the fiber
+    saturation point, (1-Hfs) * Wsf^(1-c2).
+
+    \param[in] t Nodal temperature (oC).
+ */
+
+double DFMDiffusivityTable::saturatedSlope( double t ) const
+{
+    double ft = ( t - TableTMin ) / TableTStep;
+    int j = (int) ft;
+    j = ( j < 0 ) ? 0 : ( ( j > TableTSize - 2 ) ? TableTSize - 2 : j );
+    ft -= j;
+    return( m_sat[j] + ft * ( m_sat[j+1] - m_sat[j] ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Bilinearly interpolated diffusivity terms.
+
+    \param[in]  t  Nodal temperature (oC).
+    \param[in]  wc Lesser of nodal moisture and fiber saturation (g/g).
+    \param[out] a  Vapor diffusion term; multiply by the isotherm slope
+                   numerator and divide by barometric pressure.
+    \param[out] b  Bound water diffusion term (cm2/h).
+ */
+
+void DFMDiffusivityTable::terms( double t, double wc, double* a, double* b ) const
+{
+    double ft = ( t - TableTMin ) / TableTStep;
+    int j = (int) ft;
+    j = ( j < 0 ) ? 0 : ( ( j > TableTSize - 2 ) ? TableTSize - 2 : j );
+    ft -= j;
+    double fw = wc / TableWStep;
+    int k = (int) fw;
+    k = ( k < 0 ) ? 0 : ( ( k > TableWSize - 2 ) ? TableWSize - 2 : k );
+    fw -= k;
+    const double* p0 = &m_ab[2 * ( j * TableWSize + k )];
+    const double* p1 = p0 + 2 * TableWSize;
+    double a0 = p0[0] + fw * ( p0[2] - p0[0] );
+    double a1 = p1[0] + fw * ( p1[2] - p1[0] );
+    double b0 = p0[1] + fw * ( p0[3] - p0[1] );
+    double b1 = p1[1] + fw * ( p1[3] - p1[1] );
+    *a = a0 + ft * ( a1 - a0 );
+    *b = b0 + ft * ( b1 - b0 );
+    return;
+}
+
+//------------------------------------------------------------------------------
+//  End of dfmdiffusivitytable.cpp
+//------------------------------------------------------------------------------
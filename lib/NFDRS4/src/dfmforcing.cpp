@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+/*! \file dfmforcing.cpp
+    \brief DFMForcing class definition and implementation.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <cmath>
+
+// Custom include files
+#include "dfmforcing.h"
+
+// DeadFuelMoisture Kelvin
+static const double Kelvin = 273.2;
+
+//------------------------------------------------------------------------------
+/*! \brief DFMForcing default constructor.
+
+    The forcing matches no stick until advance() has been called for two
+    observations.
+ */
+
+DFMForcing::DFMForcing( void ) :
+    m_valid0( false ),
+    m_valid1( false ),
+    m_ta0( 0. ),
+    m_ta1( 0. ),
+    m_ha0( 0. ),
+    m_ha1( 0. )
+{
+    for ( int j=0; j<=DFM_ForcingIntervals; j++ )
+    {
+        m_lha[j] = m_psa[j] = 0.;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Makes the current observation the previous one and rebuilds the
+    grid between it and the new current observation.
+
+    \param[in] ta Current air temperature (oC).
+    \param[in] ha Current air relative humidity (g/g).
+ */
+
+void DFMForcing::advance( double ta, double ha )
+{
+    m_ta0 = m_ta1;
+    m_ha0 = m_ha1;
+    m_valid0 = m_valid1;
+    m_ta1 = ta;
+    m_ha1 = ha;
+    m_valid1 = true;
+    if ( ! m_valid0 )
+    {
+        return;
+    }
+    // Same interpolation as DeadFuelMoisture::integrateNodes()
+    for ( int j=0; j<=DFM_ForcingIntervals; j++ )
+    {
+        double tfract = (double) j / (double) DFM_ForcingIntervals;
+        double tka = m_ta0 + ( m_ta1 - m_ta0 ) * tfract + Kelvin;
+        double hr  = m_ha0 + ( m_ha1 - m_ha0 ) * tfract;
+        m_lha[j] = log( hr );
+        m_psa[j] = 0.0000239 * exp( 20.58 - ( 5205. / tka ) );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Forgets the previous and current observations, e.g. when the
+    sticks are reinitialized.
+ */
+
+void DFMForcing::reset( void )
+{
+    m_valid0 = m_valid1 = false;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if the grid was built between the given observations.
+
+    \param[in] ta0 Previous air temperature (oC).
+    \param[in] ta1 Current air temperature (oC).
+    \param[in] ha0 Previous air relative humidity (g/g).
+    \param[in] ha1 Current air relative humidity (g/g).
+
+    \retval TRUE if values() may be used for a stick between these
+    observations.
+ */
+
+bool DFMForcing::matches( double ta0, double ta1, double ha0, double ha1 ) const
+{
+    return( m_valid0
+         && ta0 == m_ta0 && ta1 == m_ta1
+         && ha0 == m_ha0 && ha1 == m_ha1 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Interpolates the derived quantities at \a tfract.
+
+    \param[in]  tfract Fraction of time elapsed between the previous and
+                       current observation (0 to 1).
+    \param[in]  tka    Air temperature at \a tfract (oK).
+    \param[in]  ha     Air relative humidity at \a tfract (g/g).
+    \param[out] tdw    Dew point temperature (oK).
+    \param[out] psa    Water saturation vapor pressure in ambient air (cal/cm3).
+    \param[out] psd    Water saturation vapor pressure at dewpoint (cal/cm3).
+ */
+
+void DFMForcing::values( double tfract, double tka, double ha, double* tdw, double* psa, double* psd ) const
+{
+    // Quadratic through grid points j, j+1 and j+2
+    double g = tfract * DFM_ForcingIntervals;
+    int j = (int) g;
+    j = ( j < 0 ) ? 0 : ( ( j > DFM_ForcingIntervals - 2 ) ? DFM_ForcingIntervals - 2 : j );
+    double u = g - j;
+    double c0 = 0.5 * ( u - 1. ) * ( u - 2. );
+    double c1 = u * ( 2. - u );
+    double c2 = 0.5 * u * ( u - 1. );
+    double lha = c0 * m_lha[j] + c1 * m_lha[j+1] + c2 * m_lha[j+2];
+    *psa = c0 * m_psa[j] + c1 * m_psa[j+1] + c2 * m_psa[j+2];
+    *tdw = 5205. / ( ( 5205. / tka ) - lha );
+    *psd = *psa * ha;
+    return;
+}
+
+//------------------------------------------------------------------------------
+//  End of dfmforcing.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,246 @@
+//------------------------------------------------------------------------------
+/*! \file dfmmultirate.cpp
+    \brief DFMMultiRate class definition and implementation.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Custom include files
+#include "dfmmultirate.h"
+
+//------------------------------------------------------------------------------
+/*! \brief DFMMultiRate default constructor.
+
+    The interval is 1 hour, i.e. the stick is updated hourly.
+ */
+
+DFMMultiRate::DFMMultiRate( void ) :
+    m_interval( 1 ),
+    m_results( 0 ),
+    m_mc0( 0. ),
+    m_mc1( 0. ),
+    m_span( 0 )
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gathers the next hourly observation.
+
+    \param[in] ta Air temperature (oC).
+    \param[in] ha Air relative humidity (g/g).
+    \param[in] sW Solar radiation (W/m2).
+    \param[in] ra Rainfall amount over the hour (cm).
+ */
+
+void DFMMultiRate::add( double ta, double ha, double sW, double ra )
+{
+    m_ta.push_back( ta );
+    m_ha.push_back( ha );
+    m_sW.push_back( sW );
+    m_ra.push_back( ra );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if interval() observations have been gathered.
+
+    \retval TRUE if the stick is due for an update.
+ */
+
+bool DFMMultiRate::due( void ) const
+{
+    return( size() >= m_interval );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of hourly observations per stick update.
+
+    \return Observations per stick update (h).
+ */
+
+int DFMMultiRate::interval( void ) const
+{
+    return( m_interval );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Records the stick moisture content after an update over the
+    gathered observations, and discards them.
+
+    \param[in] mc Stick moisture content after the update.
+ */
+
+void DFMMultiRate::integrated( double mc )
+{
+    m_mc0 = ( m_results > 0 ) ? m_mc1 : mc;
+    m_mc1 = mc;
+    m_results = ( m_results < 2 ) ? m_results + 1 : 2;
+    m_span = size();
+    m_ta.clear();
+    m_ha.clear();
+    m_sW.clear();
+    m_ra.clear();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Projects the stick moisture content to the last gathered hour.
+
+    \param[in] mc Stick moisture content after its last update.
+
+    \return \a mc plus the change over the last update, scaled to the hours
+    gathered since; \a mc itself until two updates have been recorded.
+ */
+
+double DFMMultiRate::projected( double mc ) const
+{
+    if ( m_results < 2 || m_span <= 0 )
+    {
+        return( mc );
+    }
+    return( mc + ( m_mc1 - m_mc0 ) * (double) size() / (double) m_span );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Discards the gathered observations and recorded moisture contents.
+
+    Call whenever the stick is reinitialized or its state is replaced.
+ */
+
+void DFMMultiRate::reset( void )
+{
+    m_ta.clear();
+    m_ha.clear();
+    m_sW.clear();
+    m_ra.clear();
+    m_results = 0;
+    m_mc0 = m_mc1 = 0.;
+    m_span = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the number of hourly observations per stick update.
+
+    \param[in] hours Observations per stick update; values below 1 are
+    taken as 1 (hourly updates), and values above DFM_SnapshotHours as
+    DFM_SnapshotHours, so snapshot() always holds the gathered observations.
+ */
+
+void DFMMultiRate::setInterval( int hours )
+{
+    m_interval = ( hours < 1 ) ? 1 : ( hours > DFM_SnapshotHours ) ? DFM_SnapshotHours : hours;
+    reset();
+    // Room for a full interval, so add() and restore() do not allocate
+    m_ta.reserve( m_interval );
+    m_ha.reserve( m_interval );
+    m_sW.reserve( m_interval );
+    m_ra.reserve( m_interval );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of gathered hourly observations.
+
+    \return Observations gathered since the last stick update.
+ */
+
+int DFMMultiRate::size( void ) const
+{
+    return( (int) m_ta.size() );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if the gathered observations are all alike and dry.
+
+    \retval TRUE if every gathered observation repeats the last one and no
+    rain fell.
+ */
+
+bool DFMMultiRate::steady( void ) const
+{
+    const int n = size();
+    for ( int i=0; i<n; i++ )
+    {
+        if ( m_ta[i] != m_ta[n-1] || m_ha[i] != m_ha[n-1]
+          || m_sW[i] != m_sW[n-1] || m_ra[i] > 0.0 )
+        {
+            return( false );
+        }
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Takes the gathered observations and recorded moisture contents.
+
+    \param[out] snap Snapshot to fill.
+
+    \retval TRUE if the gathered observations fit in a DFMMultiRateSnapshot.
+ */
+
+bool DFMMultiRate::snapshot( DFMMultiRateSnapshot* snap ) const
+{
+    const int n = size();
+    if ( n > DFM_SnapshotHours )
+    {
+        return( false );
+    }
+    snap->interval = m_interval;
+    snap->count = n;
+    for ( int i=0; i<n; i++ )
+    {
+        snap->ta[i] = m_ta[i];
+        snap->ha[i] = m_ha[i];
+        snap->sW[i] = m_sW[i];
+        snap->ra[i] = m_ra[i];
+    }
+    snap->results = m_results;
+    snap->mc0 = m_mc0;
+    snap->mc1 = m_mc1;
+    snap->span = m_span;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Replaces the gathered observations and recorded moisture contents
+    with a snapshot() of a DFMMultiRate with the same interval.
+
+    Does not allocate, since setInterval() reserves a full interval.
+
+    \param[in] snap Snapshot to restore.
+
+    \retval TRUE if the snapshot has the same interval; otherwise nothing
+    is changed.
+ */
+
+bool DFMMultiRate::restore( const DFMMultiRateSnapshot& snap )
+{
+    if ( snap.interval != m_interval || snap.count < 0 || snap.count > DFM_SnapshotHours )
+    {
+        return( false );
+    }
+    m_ta.assign( snap.ta, snap.ta + snap.count );
+    m_ha.assign( snap.ha, snap.ha + snap.count );
+    m_sW.assign( snap.sW, snap.sW + snap.count );
+    m_ra.assign( snap.ra, snap.ra + snap.count );
+    m_results = snap.results;
+    m_mc0 = snap.mc0;
+    m_mc1 = snap.mc1;
+    m_span = snap.span;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+//  End of dfmmultirate.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,323 @@
+//------------------------------------------------------------------------------
+/*! \file dfmsimd.cpp
+    \brief DFMSimd class definition and implementation.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#ifdef DFM_SIMD_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// Custom include files
+#include "dfmsimdkernel.h"
+
+#ifdef DFM_SIMD_X86
+void dfmDiffusivitySSE2( const DFMSimdDiffusivity& in, int nodes,
+        const double* t, const double* w, double* d );
+void dfmDiffusivityAVX2( const DFMSimdDiffusivity& in, int nodes,
+        const double* t, const double* w, double* d );
+void dfmDiffusivityAVX512( const DFMSimdDiffusivity& in, int nodes,
+        const double* t, const double* w, double* d );
+void dfmIndexesSSE2( const DFMSimdIndexBed& bed, int records,
+        const double* const* in, double* const* out );
+void dfmIndexesAVX2( const DFMSimdIndexBed& bed, int records,
+        const double* const* in, double* const* out );
+void dfmIndexesAVX512( const DFMSimdIndexBed& bed, int records,
+        const double* const* in, double* const* out );
+#endif
+
+namespace {
+
+// One lane, for processors without a SIMD kernel
+struct VecScalar
+{
+    static const int Lanes = 1;
+    typedef bool Mask;
+    double v;
+
+    static VecScalar make( double a ) { VecScalar r; r.v = a; return( r ); }
+    static VecScalar set( double a ) { return( make( a ) ); }
+    static VecScalar load( const double* p ) { return( make( *p ) ); }
+    static void store( double* p, const VecScalar& a ) { *p = a.v; }
+    static VecScalar min( const VecScalar& a, const VecScalar& b ) { return( make( ( a.v < b.v ) ? a.v : b.v ) ); }
+    static VecScalar max( const VecScalar& a, const VecScalar& b ) { return( make( ( a.v > b.v ) ? a.v : b.v ) ); }
+    static VecScalar sqrt( const VecScalar& a ) { return( make( std::sqrt( a.v ) ) ); }
+    static Mask lt( const VecScalar& a, const VecScalar& b ) { return( a.v < b.v ); }
+    static Mask gt( const VecScalar& a, const VecScalar& b ) { return( a.v > b.v ); }
+    static Mask ne( const VecScalar& a, const VecScalar& b ) { return( a.v != b.v ); }
+    static Mask both( Mask a, Mask b ) { return( a && b ); }
+    static VecScalar select( Mask m, const VecScalar& a, const VecScalar& b ) { return( m ? a : b ); }
+    static VecScalar pow2( const VecScalar& k )
+    {
+        unsigned long long kb, rb, ob;
+        double one = 1.;
+        std::memcpy( &kb, &k.v, sizeof( kb ) );
+        std::memcpy( &rb, &DFMSimdRound, sizeof( rb ) );
+        std::memcpy( &ob, &one, sizeof( ob ) );
+        unsigned long long bits = ( ( kb - rb ) << 52 ) + ob;
+        VecScalar r;
+        std::memcpy( &r.v, &bits, sizeof( bits ) );
+        return( r );
+    }
+    static void split( const VecScalar& a, VecScalar* e, VecScalar* m )
+    {
+        unsigned long long bits;
+        std::memcpy( &bits, &a.v, sizeof( bits ) );
+        e->v = (double) (long long) ( bits >> 52 ) - 1023.;
+        bits = ( bits & 0x000FFFFFFFFFFFFFULL ) | 0x3FF0000000000000ULL;
+        std::memcpy( &m->v, &bits, sizeof( bits ) );
+    }
+};
+
+inline VecScalar operator+( const VecScalar& a, const VecScalar& b ) { return( VecScalar::make( a.v + b.v ) ); }
+inline VecScalar operator-( const VecScalar& a, const VecScalar& b ) { return( VecScalar::make( a.v - b.v ) ); }
+inline VecScalar operator*( const VecScalar& a, const VecScalar& b ) { return( VecScalar::make( a.v * b.v ) ); }
+inline VecScalar operator/( const VecScalar& a, const VecScalar& b ) { return( VecScalar::make( a.v / b.v ) ); }
+
+typedef void (*DiffusivityKernel)( const DFMSimdDiffusivity& in, int nodes,
+        const double* t, const double* w, double* d );
+
+void diffusivityScalar( const DFMSimdDiffusivity& in, int nodes,
+        const double* t, const double* w, double* d )
+{
+    dfmDiffusivity<VecScalar>( in, nodes, t, w, d );
+}
+
+typedef void (*IndexKernel)( const DFMSimdIndexBed& bed, int records,
+        const double* const* in, double* const* out );
+
+void indexesScalar( const DFMSimdIndexBed& bed, int records,
+        const double* const* in, double* const* out )
+{
+    dfmIndexes<VecScalar>( bed, records, in, out );
+}
+
+// Lanes and kernel of each DFMSimdLevel
+const int Lanes[] = { 1, 2, 4, 8 };
+const char* const Names[] = { "scalar", "SSE2", "AVX2", "AVX-512F" };
+#ifdef DFM_SIMD_X86
+const DiffusivityKernel Kernels[] =
+    { diffusivityScalar, dfmDiffusivitySSE2, dfmDiffusivityAVX2, dfmDiffusivityAVX512 };
+const IndexKernel IndexKernels[] =
+    { indexesScalar, dfmIndexesSSE2, dfmIndexesAVX2, dfmIndexesAVX512 };
+#else
+const DiffusivityKernel Kernels[] =
+    { diffusivityScalar, diffusivityScalar, diffusivityScalar, diffusivityScalar };
+const IndexKernel IndexKernels[] =
+    { indexesScalar, indexesScalar, indexesScalar, indexesScalar };
+#endif
+
+// Level in use, or -1 until first used
+std::atomic<int> Level( -1 );
+
+}   // namespace
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the widest level supported by the host processor,
+    operating system and build.
+ */
+
+DFMSimdLevel DFMSimd::supported( void )
+{
+#ifdef DFM_SIMD_X86
+#ifdef _MSC_VER
+    int r[4];
+    __cpuid( r, 0 );
+    int maxLeaf = r[0];
+    __cpuid( r, 1 );
+    bool osxsave = ( r[2] & ( 1 << 27 ) ) != 0;
+    if ( maxLeaf < 7 || ! osxsave )
+    {
+        return( DFM_SimdSSE2 );
+    }
+    // Register state the operating system saves: AVX, then opmask and ZMM
+    unsigned long long xcr0 = _xgetbv( 0 );
+    __cpuidex( r, 7, 0 );
+    if ( ( xcr0 & 0xE6 ) == 0xE6 && ( r[1] & ( 1 << 16 ) ) )
+    {
+        return( DFM_SimdAVX512 );
+    }
+    if ( ( xcr0 & 0x6 ) == 0x6 && ( r[1] & ( 1 << 5 ) ) )
+    {
+        return( DFM_SimdAVX2 );
+    }
+    return( DFM_SimdSSE2 );
+#else
+    // Also checks operating system support
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports( "avx512f" ) )
+    {
+        return( DFM_SimdAVX512 );
+    }
+    if ( __builtin_cpu_supports( "avx2" ) )
+    {
+        return( DFM_SimdAVX2 );
+    }
+    return( DFM_SimdSSE2 );
+#endif
+#else
+    return( DFM_SimdScalar );
+#endif
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the level diffusivity() runs at, supported() unless
+    changed by setLevel().
+ */
+
+DFMSimdLevel DFMSimd::level( void )
+{
+    int level = Level.load( std::memory_order_relaxed );
+    if ( level < 0 )
+    {
+        level = supported();
+        Level.store( level, std::memory_order_relaxed );
+    }
+    return( (DFMSimdLevel) level );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the name of \a level (e.g. "AVX2").
+ */
+
+const char* DFMSimd::levelName( DFMSimdLevel level )
+{
+    return( Names[level] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Selects the level diffusivity() runs at, e.g. to compare levels;
+    results are the same at every level.
+
+    \param[in] level Level to use.
+
+    \retval TRUE if \a level is in use.
+    \retval FALSE if the host or build does not support \a level, which is
+    then left unchanged.
+ */
+
+bool DFMSimd::setLevel( DFMSimdLevel level )
+{
+    if ( level < DFM_SimdScalar || level > supported() )
+    {
+        return( false );
+    }
+    Level.store( level, std::memory_order_relaxed );
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Bound water diffusivity at each of \a nodes stick nodes.
+
+    \param[in]  in    Quantities shared by all nodes.
+    \param[in]  nodes Number of nodes.
+    \param[in]  t     Nodal temperatures (oC).
+    \param[in]  w     Nodal moisture contents (g/g).
+    \param[out] d     Nodal bound water diffusivities (cm2/h).
+ */
+
+void DFMSimd::diffusivity( const DFMSimdDiffusivity& in, int nodes,
+        const FP_COMPUTE_TYPE* t, const FP_COMPUTE_TYPE* w, FP_COMPUTE_TYPE* d )
+{
+    // Aligned blocks, padded to whole vectors with a harmless node
+    const int Block = 32;
+    alignas( 64 ) double tb[Block];
+    alignas( 64 ) double wb[Block];
+    alignas( 64 ) double db[Block];
+    const int level = DFMSimd::level();
+    const int lanes = Lanes[level];
+    const DiffusivityKernel kernel = Kernels[level];
+    for ( int i0=0; i0<nodes; i0+=Block )
+    {
+        int n = ( nodes - i0 < Block ) ? nodes - i0 : Block;
+        int padded = ( ( n + lanes - 1 ) / lanes ) * lanes;
+        for ( int i=0; i<padded; i++ )
+        {
+            tb[i] = ( i < n ) ? (double) t[i0+i] : 20.;
+            wb[i] = ( i < n ) ? (double) w[i0+i] : 0.;
+        }
+        kernel( in, padded, tb, wb, db );
+        for ( int i=0; i<n; i++ )
+        {
+            d[i0+i] = (FP_COMPUTE_TYPE) db[i];
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief NFDRS4 spread and energy release components, burning index and
+    ignition component of \a records records on one fuel bed.
+
+    \param[in]  bed     Fuel bed quantities shared by all records.
+    \param[in]  records Number of records.
+    \param[in]  in      Input arrays, in DFMSimdIndexInput order.
+    \param[out] out     Output arrays, in DFMSimdIndexOutput order; NULL
+                        arrays are not written.
+ */
+
+void DFMSimd::indexes( const DFMSimdIndexBed& bed, int records,
+        const double* const* in, double* const* out )
+{
+    // Aligned blocks, padded to whole vectors with a harmless record
+    const int Block = 32;
+    alignas( 64 ) double ib[DFM_IndexInputs][Block];
+    alignas( 64 ) double ob[DFM_IndexOutputs][Block];
+    const double* ip[DFM_IndexInputs];
+    double* op[DFM_IndexOutputs];
+    for ( int k=0; k<DFM_IndexInputs; k++ )
+    {
+        ip[k] = ib[k];
+    }
+    for ( int k=0; k<DFM_IndexOutputs; k++ )
+    {
+        op[k] = ob[k];
+    }
+    const int level = DFMSimd::level();
+    const int lanes = Lanes[level];
+    const IndexKernel kernel = IndexKernels[level];
+    for ( int i0=0; i0<records; i0+=Block )
+    {
+        int n = ( records - i0 < Block ) ? records - i0 : Block;
+        int padded = ( ( n + lanes - 1 ) / lanes ) * lanes;
+        for ( int k=0; k<DFM_IndexInputs; k++ )
+        {
+            for ( int i=0; i<padded; i++ )
+            {
+                ib[k][i] = ( i < n ) ? in[k][i0+i] : in[k][i0];
+            }
+        }
+        kernel( bed, padded, ip, op );
+        for ( int k=0; k<DFM_IndexOutputs; k++ )
+        {
+            if ( out[k] )
+            {
+                for ( int i=0; i<n; i++ )
+                {
+                    out[k][i0+i] = ob[k][i];
+                }
+            }
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+//  End of dfmsimd.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+/*! \file dfmsimdavx2.cpp
+    \brief DFMSimd kernels for x86 AVX2, four nodes per instruction.
+
+    Compiled with AVX2 enabled and without fused multiply-adds; only called
+    once DFMSimd has found AVX2 support on the host.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifdef DFM_SIMD_X86
+
+// Standard include files
+#include <immintrin.h>
+
+// Custom include files
+#include "dfmsimdkernel.h"
+
+namespace {
+
+struct VecAVX2
+{
+    static const int Lanes = 4;
+    typedef __m256d Mask;
+    __m256d v;
+
+    static VecAVX2 make( __m256d a ) { VecAVX2 r; r.v = a; return( r ); }
+    static VecAVX2 set( double a ) { return( make( _mm256_set1_pd( a ) ) ); }
+    static VecAVX2 load( const double* p ) { return( make( _mm256_load_pd( p ) ) ); }
+    static void store( double* p, const VecAVX2& a ) { _mm256_store_pd( p, a.v ); }
+    static VecAVX2 min( const VecAVX2& a, const VecAVX2& b ) { return( make( _mm256_min_pd( a.v, b.v ) ) ); }
+    static VecAVX2 max( const VecAVX2& a, const VecAVX2& b ) { return( make( _mm256_max_pd( a.v, b.v ) ) ); }
+    static VecAVX2 sqrt( const VecAVX2& a ) { return( make( _mm256_sqrt_pd( a.v ) ) ); }
+    static Mask lt( const VecAVX2& a, const VecAVX2& b ) { return( _mm256_cmp_pd( a.v, b.v, _CMP_LT_OS ) ); }
+    static Mask gt( const VecAVX2& a, const VecAVX2& b ) { return( _mm256_cmp_pd( a.v, b.v, _CMP_GT_OS ) ); }
+    static Mask ne( const VecAVX2& a, const VecAVX2& b ) { return( _mm256_cmp_pd( a.v, b.v, _CMP_NEQ_UQ ) ); }
+    static Mask both( Mask a, Mask b ) { return( _mm256_and_pd( a, b ) ); }
+    static VecAVX2 select( Mask m, const VecAVX2& a, const VecAVX2& b )
+    {
+        return( make( _mm256_blendv_pd( b.v, a.v, m ) ) );
+    }
+    static VecAVX2 pow2( const VecAVX2& k )
+    {
+        __m256i n = _mm256_sub_epi64( _mm256_castpd_si256( k.v ),
+            _mm256_castpd_si256( _mm256_set1_pd( DFMSimdRound ) ) );
+        return( make( _mm256_castsi256_pd( _mm256_add_epi64( _mm256_slli_epi64( n, 52 ),
+            _mm256_castpd_si256( _mm256_set1_pd( 1. ) ) ) ) ) );
+    }
+    static void split( const VecAVX2& a, VecAVX2* e, VecAVX2* m )
+    {
+        __m256i bits = _mm256_castpd_si256( a.v );
+        // Biased exponent, converted exactly through 2^52 + exponent
+        __m256i eb = _mm256_or_si256( _mm256_srli_epi64( bits, 52 ),
+            _mm256_castpd_si256( _mm256_set1_pd( 4503599627370496. ) ) );
+        e->v = _mm256_sub_pd( _mm256_castsi256_pd( eb ), _mm256_set1_pd( 4503599627370496. + 1023. ) );
+        m->v = _mm256_castsi256_pd( _mm256_or_si256(
+            _mm256_and_si256( bits, _mm256_set1_epi64x( 0x000FFFFFFFFFFFFFLL ) ),
+            _mm256_castpd_si256( _mm256_set1_pd( 1. ) ) ) );
+    }
+};
+
+inline VecAVX2 operator+( const VecAVX2& a, const VecAVX2& b ) { return( VecAVX2::make( _mm256_add_pd( a.v, b.v ) ) ); }
+inline VecAVX2 operator-( const VecAVX2& a, const VecAVX2& b ) { return( VecAVX2::make( _mm256_sub_pd( a.v, b.v ) ) ); }
+inline VecAVX2 operator*( const VecAVX2& a, const VecAVX2& b ) { return( VecAVX2::make( _mm256_mul_pd( a.v, b.v ) ) ); }
+inline VecAVX2 operator/( const VecAVX2& a, const VecAVX2& b ) { return( VecAVX2::make( _mm256_div_pd( a.v, b.v ) ) ); }
+
+}   // namespace
+
+//------------------------------------------------------------------------------
+/*! \brief AVX2 bound water diffusivity (see dfmDiffusivity()).
+ */
+
+void dfmDiffusivityAVX2( const DFMSimdDiffusivity& in, int nodes,
+        const double* t, const double* w, double* d )
+{
+    dfmDiffusivity<VecAVX2>( in, nodes, t, w, d );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief AVX2 NFDRS4 indexes (see dfmIndexes()).
+ */
+
+void dfmIndexesAVX2( const DFMSimdIndexBed& bed, int records,
+        const double* const* in, double* const* out )
+{
+    dfmIndexes<VecAVX2>( bed, records, in, out );
+    return;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of dfmsimdavx2.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+/*! \file dfmsimdavx512.cpp
+    \brief DFMSimd kernels for x86 AVX-512F, eight nodes per instruction.
+
+    Compiled with AVX-512F enabled and without fused multiply-adds; only
+    called once DFMSimd has found AVX-512F support on the host.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifdef DFM_SIMD_X86
+
+// Standard include files
+#include <immintrin.h>
+
+// Custom include files
+#include "dfmsimdkernel.h"
+
+namespace {
+
+struct VecAVX512
+{
+    static const int Lanes = 8;
+    typedef __mmask8 Mask;
+    __m512d v;
+
+    static VecAVX512 make( __m512d a ) { VecAVX512 r; r.v = a; return( r ); }
+    static VecAVX512 set( double a ) { return( make( _mm512_set1_pd( a ) ) ); }
+    static VecAVX512 load( const double* p ) { return( make( _mm512_load_pd( p ) ) ); }
+    static void store( double* p, const VecAVX512& a ) { _mm512_store_pd( p, a.v ); }
+    static VecAVX512 min( const VecAVX512& a, const VecAVX512& b ) { return( make( _mm512_min_pd( a.v, b.v ) ) ); }
+    static VecAVX512 max( const VecAVX512& a, const VecAVX512& b ) { return( make( _mm512_max_pd( a.v, b.v ) ) ); }
+    static VecAVX512 sqrt( const VecAVX512& a ) { return( make( _mm512_sqrt_pd( a.v ) ) ); }
+    static Mask lt( const VecAVX512& a, const VecAVX512& b ) { return( _mm512_cmp_pd_mask( a.v, b.v, _CMP_LT_OS ) ); }
+    static Mask gt( const VecAVX512& a, const VecAVX512& b ) { return( _mm512_cmp_pd_mask( a.v, b.v, _CMP_GT_OS ) ); }
+    static Mask ne( const VecAVX512& a, const VecAVX512& b ) { return( _mm512_cmp_pd_mask( a.v, b.v, _CMP_NEQ_UQ ) ); }
+    static Mask both( Mask a, Mask b ) { return( (Mask) ( a & b ) ); }
+    static VecAVX512 select( Mask m, const VecAVX512& a, const VecAVX512& b )
+    {
+        return( make( _mm512_mask_blend_pd( m, b.v, a.v ) ) );
+    }
+    static VecAVX512 pow2( const VecAVX512& k )
+    {
+        __m512i n = _mm512_sub_epi64( _mm512_castpd_si512( k.v ),
+            _mm512_castpd_si512( _mm512_set1_pd( DFMSimdRound ) ) );
+        return( make( _mm512_castsi512_pd( _mm512_add_epi64( _mm512_slli_epi64( n, 52 ),
+            _mm512_castpd_si512( _mm512_set1_pd( 1. ) ) ) ) ) );
+    }
+    static void split( const VecAVX512& a, VecAVX512* e, VecAVX512* m )
+    {
+        __m512i bits = _mm512_castpd_si512( a.v );
+        // Biased exponent, converted exactly through 2^52 + exponent
+        __m512i eb = _mm512_or_si512( _mm512_srli_epi64( bits, 52 ),
+            _mm512_castpd_si512( _mm512_set1_pd( 4503599627370496. ) ) );
+        e->v = _mm512_sub_pd( _mm512_castsi512_pd( eb ), _mm512_set1_pd( 4503599627370496. + 1023. ) );
+        m->v = _mm512_castsi512_pd( _mm512_or_si512(
+            _mm512_and_si512( bits, _mm512_set1_epi64( 0x000FFFFFFFFFFFFFLL ) ),
+            _mm512_castpd_si512( _mm512_set1_pd( 1. ) ) ) );
+    }
+};
+
+inline VecAVX512 operator+( const VecAVX512& a, const VecAVX512& b ) { return( VecAVX512::make( _mm512_add_pd( a.v, b.v ) ) ); }
+inline VecAVX512 operator-( const VecAVX512& a, const VecAVX512& b ) { return( VecAVX512::make( _mm512_sub_pd( a.v, b.v ) ) ); }
+inline VecAVX512 operator*( const VecAVX512& a, const VecAVX512& b ) { return( VecAVX512::make( _mm512_mul_pd( a.v, b.v ) ) ); }
+inline VecAVX512 operator/( const VecAVX512& a, const VecAVX512& b ) { return( VecAVX512::make( _mm512_div_pd( a.v, b.v ) ) ); }
+
+}   // namespace
+
+//------------------------------------------------------------------------------
+/*! \brief AVX-512F bound water diffusivity (see dfmDiffusivity()).
+ */
+
+void dfmDiffusivityAVX512( const DFMSimdDiffusivity& in, int nodes,
+        const double* t, const double* w, double* d )
+{
+    dfmDiffusivity<VecAVX512>( in, nodes, t, w, d );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief AVX-512F NFDRS4 indexes (see dfmIndexes()).
+ */
+
+void dfmIndexesAVX512( const DFMSimdIndexBed& bed, int records,
+        const double* const* in, double* const* out )
+{
+    dfmIndexes<VecAVX512>( bed, records, in, out );
+    return;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of dfmsimdavx512.cpp
+//------------------------------------------------------------------------------
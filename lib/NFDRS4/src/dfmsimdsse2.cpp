@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+/*! \file dfmsimdsse2.cpp
+    \brief DFMSimd kernels for x86 SSE2, two nodes per instruction.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifdef DFM_SIMD_X86
+
+// Standard include files
+#include <emmintrin.h>
+
+// Custom include files
+#include "dfmsimdkernel.h"
+
+namespace {
+
+struct VecSSE2
+{
+    static const int Lanes = 2;
+    typedef __m128d Mask;
+    __m128d v;
+
+    static VecSSE2 make( __m128d a ) { VecSSE2 r; r.v = a; return( r ); }
+    static VecSSE2 set( double a ) { return( make( _mm_set1_pd( a ) ) ); }
+    static VecSSE2 load( const double* p ) { return( make( _mm_load_pd( p ) ) ); }
+    static void store( double* p, const VecSSE2& a ) { _mm_store_pd( p, a.v ); }
+    static VecSSE2 min( const VecSSE2& a, const VecSSE2& b ) { return( make( _mm_min_pd( a.v, b.v ) ) ); }
+    static VecSSE2 max( const VecSSE2& a, const VecSSE2& b ) { return( make( _mm_max_pd( a.v, b.v ) ) ); }
+    static VecSSE2 sqrt( const VecSSE2& a ) { return( make( _mm_sqrt_pd( a.v ) ) ); }
+    static Mask lt( const VecSSE2& a, const VecSSE2& b ) { return( _mm_cmplt_pd( a.v, b.v ) ); }
+    static Mask gt( const VecSSE2& a, const VecSSE2& b ) { return( _mm_cmpgt_pd( a.v, b.v ) ); }
+    static Mask ne( const VecSSE2& a, const VecSSE2& b ) { return( _mm_cmpneq_pd( a.v, b.v ) ); }
+    static Mask both( Mask a, Mask b ) { return( _mm_and_pd( a, b ) ); }
+    static VecSSE2 select( Mask m, const VecSSE2& a, const VecSSE2& b )
+    {
+        return( make( _mm_or_pd( _mm_and_pd( m, a.v ), _mm_andnot_pd( m, b.v ) ) ) );
+    }
+    static VecSSE2 pow2( const VecSSE2& k )
+    {
+        __m128i n = _mm_sub_epi64( _mm_castpd_si128( k.v ),
+            _mm_castpd_si128( _mm_set1_pd( DFMSimdRound ) ) );
+        return( make( _mm_castsi128_pd( _mm_add_epi64( _mm_slli_epi64( n, 52 ),
+            _mm_castpd_si128( _mm_set1_pd( 1. ) ) ) ) ) );
+    }
+    static void split( const VecSSE2& a, VecSSE2* e, VecSSE2* m )
+    {
+        __m128i bits = _mm_castpd_si128( a.v );
+        // Biased exponent, converted exactly through 2^52 + exponent
+        __m128i eb = _mm_or_si128( _mm_srli_epi64( bits, 52 ),
+            _mm_castpd_si128( _mm_set1_pd( 4503599627370496. ) ) );
+        e->v = _mm_sub_pd( _mm_castsi128_pd( eb ), _mm_set1_pd( 4503599627370496. + 1023. ) );
+        m->v = _mm_castsi128_pd( _mm_or_si128(
+            _mm_and_si128( bits, _mm_set1_epi64x( 0x000FFFFFFFFFFFFFLL ) ),
+            _mm_castpd_si128( _mm_set1_pd( 1. ) ) ) );
+    }
+};
+
+inline VecSSE2 operator+( const VecSSE2& a, const VecSSE2& b ) { return( VecSSE2::make( _mm_add_pd( a.v, b.v ) ) ); }
+inline VecSSE2 operator-( const VecSSE2& a, const VecSSE2& b ) { return( VecSSE2::make( _mm_sub_pd( a.v, b.v ) ) ); }
+inline VecSSE2 operator*( const VecSSE2& a, const VecSSE2& b ) { return( VecSSE2::make( _mm_mul_pd( a.v, b.v ) ) ); }
+inline VecSSE2 operator/( const VecSSE2& a, const VecSSE2& b ) { return( VecSSE2::make( _mm_div_pd( a.v, b.v ) ) ); }
+
+}   // namespace
+
+//------------------------------------------------------------------------------
+/*! \brief SSE2 bound water diffusivity (see dfmDiffusivity()).
+ */
+
+void dfmDiffusivitySSE2( const DFMSimdDiffusivity& in, int nodes,
+        const double* t, const double* w, double* d )
+{
+    dfmDiffusivity<VecSSE2>( in, nodes, t, w, d );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief SSE2 NFDRS4 indexes (see dfmIndexes()).
+ */
+
+void dfmIndexesSSE2( const DFMSimdIndexBed& bed, int records,
+        const double* const* in, double* const* out )
+{
+    dfmIndexes<VecSSE2>( bed, records, in, out );
+    return;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of dfmsimdsse2.cpp
+//------------------------------------------------------------------------------
@@ -48,8 +48,7 @@ void LiveFuelMoisture::Initialize(double Lat,bool IsHerb, bool IsAnnual = false)
     }
 	//if (iGSI.size() > 0)
 	//	iGSI.clear();
-	while (qGSI.size() > 0)
-		qGSI.pop_front();
+	qGSI.Clear();
 
 	//while (qPrecip.size() > 0)
 	//	qPrecip.pop();
@@ -90,14 +89,11 @@ void LiveFuelMoisture::Update(double TempF, double MaxTempF, double MinTempF, do
         days = secs / 86400;//86400 seconds per day
 		if (days > 1)//gap, deal with it by removing extra values
 		{
-			gDays = min(days - 1, (int)qGSI.size());
-			for (int p = 0; p < gDays; p++)
-				qGSI.pop_front();
+			gDays = min(days - 1, qGSI.Size());
+			qGSI.PopFront(gDays);
 		}
 	}
-	qGSI.push_back(GSI);
-	while (qGSI.size() > m_LFIdaysAvg)
-		qGSI.pop_front();
+	qGSI.Push(GSI);
 	lastUpdateTime = thisTime;
 }
 
@@ -154,6 +150,12 @@ void LiveFuelMoisture::SetLimits(double TminMin = -2.0,double TminMax = 5.0,doub
 void LiveFuelMoisture::SetMAPeriod(unsigned int MAPeriod=21)
 {
     m_LFIdaysAvg = m_LFIdaysAvg = max((unsigned int) 1, MAPeriod);;
+    qGSI.SetCapacity(m_LFIdaysAvg);
+}
+
+int LiveFuelMoisture::GetMAPeriod()
+{
+    return m_LFIdaysAvg;
 }
 
 void LiveFuelMoisture::SetUseVPDAvg(bool set)
@@ -279,10 +281,9 @@ LiveFuelMoisture::LiveFuelMoisture(double Lat,bool IsHerb, bool IsAnnual)
 
 double LiveFuelMoisture::CalcRunningAvgGSI()
 {
- 	double val = 0.0, gsi = 0.0;
-	gsi = std::accumulate(qGSI.begin(), qGSI.end(), val);
-	if(qGSI.size() > 0)
-		gsi /= qGSI.size();
+ 	double gsi = qGSI.Sum();
+	if(qGSI.Size() > 0)
+		gsi /= qGSI.Size();
     return gsi;
 }
 double LiveFuelMoisture::CalcRunningAvgHerbFM(bool SnowDay)
@@ -528,12 +529,10 @@ LFMCalcState LiveFuelMoisture::GetState()
 	ret.m_MaxGSI = m_MaxGSI;
 	ret.m_MaxLFMVal = m_MaxLFMVal;
 	ret.m_MinLFMVal = m_MinLFMVal;
-	deque<double> copyQ = qGSI;
-	while (copyQ.size() > 0)
+	for (int i = 0; i < qGSI.Size(); i++)
 	{
-		double qVal = copyQ.front();
+		double qVal = qGSI[i];
 		ret.m_qGSI.push_back((float)qVal);
-		copyQ.pop_front();
 	}
 	ret.m_Slope = m_Slope;
 	ret.m_TminMax = m_TminMax;
@@ -566,11 +565,13 @@ bool LiveFuelMoisture::SetState(LFMCalcState state)
 	m_MaxGSI = state.m_MaxGSI;
 	m_MaxLFMVal = state.m_MaxLFMVal;
 	m_MinLFMVal = state.m_MinLFMVal;
+	qGSI.SetCapacity(m_LFIdaysAvg);
+	qGSI.Clear();
 	vector<FP_STORAGE_TYPE> copyV = state.m_qGSI;
 	for(int i = 0; i < copyV.size(); i++)
 	{
 		double qVal = copyV[i];
-		qGSI.push_back((float)qVal);
+		qGSI.Push((float)qVal);
 	}
 	m_Slope = state.m_Slope;
 	m_TminMax = state.m_TminMax;
@@ -585,3 +586,30 @@ bool LiveFuelMoisture::SetState(LFMCalcState state)
     m_RTPrcpMax = state.m_pcpMax;
 	return true;
 }
+
+// Takes the dynamic state; false if the averaging period is longer than LFM_SnapshotDays
+bool LiveFuelMoisture::GetSnapshot(LFMSnapshot* Snap)
+{
+	if (!qGSI.Snapshot(&Snap->GSI))
+		return false;
+	Snap->lastHerbFM = lastHerbFM;
+	Snap->lastUpdateTime = lastUpdateTime;
+	Snap->hasGreenedUpThisYear = hasGreenedUpThisYear;
+	Snap->hasExceeded120ThisYear = hasExceeded120ThisYear;
+	Snap->canIncreaseHerb = canIncreaseHerb;
+	return true;
+}
+
+// Restores a snapshot of a model with the same averaging period, without allocating;
+// false, leaving the model unchanged, if the periods differ
+bool LiveFuelMoisture::SetSnapshot(const LFMSnapshot& Snap)
+{
+	if (!qGSI.Restore(Snap.GSI))
+		return false;
+	lastHerbFM = Snap.lastHerbFM;
+	lastUpdateTime = Snap.lastUpdateTime;
+	hasGreenedUpThisYear = Snap.hasGreenedUpThisYear;
+	hasExceeded120ThisYear = Snap.hasExceeded120ThisYear;
+	canIncreaseHerb = Snap.canIncreaseHerb;
+	return true;
+}
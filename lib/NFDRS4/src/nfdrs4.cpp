@@ -15,6 +15,7 @@
 #include <float.h>
 #include <algorithm>
 #include "nfdrs4.h"
+#include "diagnostics.h"
 #include <time.h>
 
 
@@ -255,6 +256,14 @@ NFDRS4::NFDRS4()
 	FuelTemperature = -999;
 	m_GSI = 0.0;
 	nConsectiveSnowDays = 0;
+	m_sharedForcing = false;
+	m_parallelSticks = false;
+	m_lazyIndexes = false;
+	m_pendingIndexes = 0;
+	m_pendingWS = -1;
+	m_pendingSlopeCls = 0;
+	m_modelMXD = m_modelSCM = 0;
+	m_modelsPending = false;
     Init(45, 'Y', 1, 0.0, true, true, true, 100, 13);
 }
 
@@ -267,6 +276,14 @@ NFDRS4::NFDRS4(double inLat, char FuelModel,int inSlopeClass, double inAvgAnnPre
 {
     CreateFuelModels();
     StartKBDI = 100;
+	m_sharedForcing = false;
+	m_parallelSticks = false;
+	m_lazyIndexes = false;
+	m_pendingIndexes = 0;
+	m_pendingWS = -1;
+	m_pendingSlopeCls = 0;
+	m_modelMXD = m_modelSCM = 0;
+	m_modelsPending = false;
 	Init(inLat, FuelModel, inSlopeClass, inAvgAnnPrecip, LT, Cure, IsAnnual, 100);
 }
 
@@ -295,6 +312,8 @@ void NFDRS4::Init(double inLat, char iFuelModel, int inSlopeClass, double inAvgA
     TenHourFM.initDeadFuelMoisture10();
     HundredHourFM.initDeadFuelMoisture100();
     ThousandHourFM.initDeadFuelMoisture1000();
+    m_fm100Rate.reset();
+    m_fm1000Rate.reset();
     
     //iSetFuelModel(FuelModel);                                   // Set the Fuel model
 	UseLoadTransfer = LT;                                       // Use Load Transfer? (bool)
@@ -314,12 +333,13 @@ void NFDRS4::Init(double inLat, char iFuelModel, int inSlopeClass, double inAvgA
     if(!isReinit)
 	    iSetFuelModel(iFuelModel);
     m_regObsHour = RegObsHour;
-    for (int h = 0; h < nHoursPerDay; h++)
-    {
-        qHourlyTemp.push_back(NORECORD);
-        qHourlyRH.push_back(NORECORD);
-        qHourlyPrecip.push_back(NORECORD);
-    }
+    qPrecip.SetCapacity(nPrecipQueueDays);
+    qHourlyTemp.SetCapacity(nHoursPerDay);
+    qHourlyRH.SetCapacity(nHoursPerDay);
+    qHourlyPrecip.SetCapacity(nHoursPerDay);
+    qHourlyTemp.PushMissing(nHoursPerDay);
+    qHourlyRH.PushMissing(nHoursPerDay);
+    qHourlyPrecip.PushMissing(nHoursPerDay);
     utcHourDiff = utctime::get_hour_diff();
 }
 
@@ -386,164 +406,85 @@ int CalcJulianDay(int year, int month, int day)
     return dayOfYear;
 }
 
+// True if an observation of Year and Julian day, following one of PrevYear and
+// YesterdayJDay, is too far apart from it for the calculator to carry on
+static bool IsUpdateGap(int Year, int Julian, int PrevYear, int YesterdayJDay)
+{
+    return PrevYear > 0 && YesterdayJDay > 0
+        && (Year < PrevYear || (Year > (PrevYear + 1)) || (365 * (Year - PrevYear) + Julian - YesterdayJDay > 30));
+}
+
 //void NFDRS4::Update(int Year, int Month, int Day, int Hour, int Julian, double Temp, double MinTemp, double MaxTemp, double RH, double PPTAcc, double PPTAmt, double SolarRad, double WS, bool SnowDay, int RegObsHr)
 void NFDRS4::Update(int Year, int Month, int Day, int Hour, int Julian, double Temp, double MinTemp, double MaxTemp, double RH, double MinRH, double PPTAmt, double pcp24, double SolarRad, double WS, bool SnowDay, int RegObsHr)
 {
     int tJulian = CalcJulianDay(Year, Month - 1, Day);
-    if (Julian != tJulian)
-        printf("Julain day mismatch for Year = %d, Month = %d, Day = %d, passed Julian = %d, calced Julian = %d\n",
+    if (Julian != tJulian && Diagnostics::report(Diag_JulianMismatch))
+        Diagnostics::format(Diag_JulianMismatch, "Julain day mismatch for Year = %d, Month = %d, Day = %d, passed Julian = %d, calced Julian = %d",
             Year, Month, Day, Julian, tJulian);
 
-	if (PrevYear > 0 && YesterdayJDay > 0)
-	{
-		if (Year < PrevYear || (Year > (PrevYear + 1)) || (365 * (Year - PrevYear) + Julian - YesterdayJDay > 30))
-		{
-			//reinit
-			Init(Lat, FuelModel, SlopeClass, AvgPrecip, UseLoadTransfer, UseCuring, HerbFM.GetIsAnnual(), KBDIThreshold, m_regObsHour, true);// , HerbFM.GetMaxGSI(), HerbFM.GetGreenupThreshold());
-		}
-	}
-
-	//Herb and 1-Hour reset every year.... Verify we want to do this
-    if (Julian < YesterdayJDay || YesterdayJDay < 0) {
-        HerbFM.ResetHerbState();
-    }
-	if (PrevYear != Year)
-	{		
-		PrevYear = Year;
-	}
-	
-	if (SnowDay) { SnowCovered = true; }
-	else { SnowCovered = false; }
-    double temp = (Temp - 32.0) * 5.0 / 9.0, rh = RH / 100.0, /*accprcp = PPTAcc * 2.54, */sr = SolarRad, pptamnt = PPTAmt * 2.54;
-
-    double MyMC1 = 0, MyMC10 = 0, MyMC100 = 0, MyMC1000 = 0;
-   // double PPTAmt24 = 0.0;
-	double neltemp = floor(temp * 100 + 0.5) / 100;
-	double nelrh = rh, nelsr = sr, nelppt = pptamnt;
+    StartUpdate(Year, Julian, SnowDay);
+    NFDRS4StickInput in = DeadFuelInput(Year, Month, Day, Hour, Temp, RH, PPTAmt, SolarRad, SnowDay);
+    in.RegObs = Hour == RegObsHr;
 
     // Update dead fuel moistures for each time period
-    // Need to set the date / time of the sticks to one hour before the first observation time
-    if (SnowCovered)
+    if (m_sharedForcing)
     {
-        neltemp = 0.;
-        nelrh = 0.999;
-        nelsr = 0.;
-        //nelppt = pptamnt;  // This is the place to deal with snow melt.
-		nelppt = 0.;
-		
+        AdvanceSharedForcing(in.Temp, in.RH);
     }
 #pragma omp parallel sections num_threads(4)
     {
-
 #pragma omp section
-        {
-
-            OneHourFM.update(Year, Month, Day, Hour, 0, 0, neltemp,nelrh,nelsr,nelppt,0.02179999999,true);
-            MC1 = MyMC1 = OneHourFM.medianRadialMoisture() * 100;
-			//MC1 = MyMC1 = OneHourFM.meanWtdMoisture() * 100;
-        }
+        MC1 = UpdateDeadFuel(0, in);
 #pragma omp section
-        {
-
-            TenHourFM.update(Year, Month, Day, Hour, 0, 0, neltemp, nelrh, nelsr,nelppt,0.02179999999, true);
-            MC10 = MyMC10 = TenHourFM.medianRadialMoisture() * 100;
-			//MC10 = MyMC10 = TenHourFM.meanWtdMoisture() * 100;
-        }
+        MC10 = UpdateDeadFuel(1, in);
 #pragma omp section
-        {
-
-            HundredHourFM.update(Year, Month, Day, Hour, 0, 0, neltemp, nelrh, nelsr, nelppt, 0.02179999999, true);
-            MC100 = MyMC100 = HundredHourFM.medianRadialMoisture() * 100;
-			//MC100 = MyMC100 = HundredHourFM.meanWtdMoisture() * 100;
-
-        }
+        MC100 = UpdateDeadFuel(2, in);
 #pragma omp section
-        {
+        MC1000 = UpdateDeadFuel(3, in);
+    }
 
-            ThousandHourFM.update(Year, Month, Day, Hour, 0, 0, neltemp, nelrh, nelsr, nelppt, 0.02179999999, true);
-            MC1000 = MyMC1000 = ThousandHourFM.medianRadialMoisture() * 100;
-			//MC1000 = MyMC1000 = ThousandHourFM.meanWtdMoisture() * 100;
+    //moved here so we have hourly fueltemp to save to DB
+    FuelTemperature = OneHourFM.surfaceTemperature();
+    NFDRS4DailyWeather daily = { MinTemp, MaxTemp, MinRH, pcp24, RegObsHr };
+    FinishUpdate(Year, Month, Day, Hour, Julian, Temp, RH, PPTAmt, WS, SnowDay, &daily);
+}
 
-        }
-    }
+void NFDRS4::Update(int Year, int Month, int Day, int Hour, double Temp, double RH, double PPTAmt, double SolarRad, double WS, bool SnowDay)
+{
+    int Julian = CalcJulianDay(Year, Month - 1, Day);
+    StartUpdate(Year, Julian, SnowDay);
+    NFDRS4StickInput in = DeadFuelInput(Year, Month, Day, Hour, Temp, RH, PPTAmt, SolarRad, SnowDay);
 
-	//moved here so we have hourly fueltemp to save to DB
-	FuelTemperature = OneHourFM.surfaceTemperature();
-    //update 24 hour deques
-    UTCTime thisUtcTime(Year, Month, Day, Hour, 0, 0);
-    time_t thisDiff = thisUtcTime - lastUtcUpdateTime;
-    time_t hoursDiff = thisDiff / utcHourDiff;
-    if (hoursDiff > 1)//gap, insert NODATA
+    // Update dead fuel moistures for each time period
+    if (m_sharedForcing)
     {
-        for (int h = 1; h < hoursDiff; h++)
-        {
-            qHourlyPrecip.push_back(NORECORD);
-            qHourlyTemp.push_back(NORECORD);
-            qHourlyRH.push_back(NORECORD);
-        }
+        AdvanceSharedForcing(in.Temp, in.RH);
     }
-    qHourlyPrecip.push_back(PPTAmt);
-    qHourlyTemp.push_back(Temp);
-    qHourlyRH.push_back(RH);
-
-   // Update live fuel moisture once per day
-    if (Hour == RegObsHr)// || num_updates==0)
+#pragma omp parallel sections num_threads(4)
     {
-
-        //LFM requires temperatures in F and RH between 1 and 100
-        // Note: Need to set up a common units structure for all calculations
-        // Maybe just need to change Nelson code to accept above temp / rh scales
-       // int secs = difftime(thisUtcTime.timestamp(), lastDailyUpdateTime.timestamp());
-        int secs = thisUtcTime.timestamp() - lastDailyUpdateTime.timestamp();
-  		if (SnowDay)
-			nConsectiveSnowDays++;
-		else
-			nConsectiveSnowDays = 0;
-
-		//update the precip deque before updating GSI!!!!
-		int days = secs / 86400;//86400 seconds per day
-		if (days > 1)//gap, deal with it by inserting zeroes
-		{
-			int pDays = min(days - 1, nPrecipQueueDays);
-			for (int p = 0; p < pDays; p++)
-				qPrecip.push_back(0.0);
-		}
-		qPrecip.push_back(pcp24);
-		while (qPrecip.size() > nPrecipQueueDays)
-			qPrecip.pop_front();
-
-		HerbFM.Update(Temp, MaxTemp, MinTemp, RH, MinRH, Julian, GetXDaysPrecipitation(HerbFM.GetNumPrecipDays()), thisUtcTime.timestamp());
-		WoodyFM.Update(Temp, MaxTemp, MinTemp, RH, MinRH, Julian, GetXDaysPrecipitation(WoodyFM.GetNumPrecipDays()), thisUtcTime.timestamp());
-
-		m_GSI = HerbFM.CalcRunningAvgGSI();
-        MCHERB = HerbFM.GetMoisture(nConsectiveSnowDays >= SNOWDAYS_TRIGGER ? true : false);
-        MCWOOD = WoodyFM.GetMoisture(nConsectiveSnowDays >= SNOWDAYS_TRIGGER ? true : false);
-        // Calculate the daily KBDI that is used for the drought fuel loading
-        KBDI = iCalcKBDI(pcp24, (int) MaxTemp, CummPrecip, YKBDI, AvgPrecip);
-		YKBDI = KBDI;
-
-
-        lastDailyUpdateTime = thisUtcTime;
-
+#pragma omp section
+        MC1 = UpdateDeadFuel(0, in);
+#pragma omp section
+        MC10 = UpdateDeadFuel(1, in);
+#pragma omp section
+        MC100 = UpdateDeadFuel(2, in);
+#pragma omp section
+        MC1000 = UpdateDeadFuel(3, in);
     }
-	iSetFuelMoistures(MC1, MC10, MC100, MC1000, MCWOOD, MCHERB, FuelTemperature);
-	// Calculate the indices
 
-	iCalcIndexes((int)WS, SlopeClass);
-    YesterdayJDay = Julian;
-    lastUtcUpdateTime = thisUtcTime;
+    //moved here so we have hourly fueltemp to save to DB
+    FuelTemperature = OneHourFM.surfaceTemperature();
+    FinishUpdate(Year, Month, Day, Hour, Julian, Temp, RH, PPTAmt, WS, SnowDay);
 }
 
-void NFDRS4::Update(int Year, int Month, int Day, int Hour, double Temp, double RH, double PPTAmt, double SolarRad, double WS, bool SnowDay)
+// Start of Update(): reinitializes after a long gap and keeps track of the year
+// and snow cover. Touches the dead fuel sticks only when reinitializing.
+void NFDRS4::StartUpdate(int Year, int Julian, bool SnowDay)
 {
-    int Julian = CalcJulianDay(Year, Month - 1, Day);
-    if (PrevYear > 0 && YesterdayJDay > 0)
+    if (IsUpdateGap(Year, Julian, PrevYear, YesterdayJDay))
     {
-        if (Year < PrevYear || (Year > (PrevYear + 1)) || (365 * (Year - PrevYear) + Julian - YesterdayJDay > 30))
-        {
-            //reinit
-            Init(Lat, FuelModel, SlopeClass, AvgPrecip, UseLoadTransfer, UseCuring, HerbFM.GetIsAnnual(), KBDIThreshold, m_regObsHour, true);
-        }
+        //reinit
+        Init(Lat, FuelModel, SlopeClass, AvgPrecip, UseLoadTransfer, UseCuring, HerbFM.GetIsAnnual(), KBDIThreshold, m_regObsHour, true);
     }
 
     //Herb and 1-Hour reset every year.... Verify we want to do this
@@ -557,118 +498,104 @@ void NFDRS4::Update(int Year, int Month, int Day, int Hour, double Temp, double
 
     if (SnowDay) { SnowCovered = true; }
     else { SnowCovered = false; }
+}
+
+// Weather of an hourly observation in the units of the dead fuel sticks.
+// Depends on the observation alone, so may be computed ahead of Update().
+NFDRS4StickInput NFDRS4::DeadFuelInput(int Year, int Month, int Day, int Hour, double Temp, double RH, double PPTAmt, double SolarRad, bool SnowDay)
+{
     double temp = (Temp - 32.0) * 5.0 / 9.0, rh = RH / 100.0, /*accprcp = PPTAcc * 2.54, */sr = SolarRad, pptamnt = PPTAmt * 2.54;
-    double MyMC1 = 0, MyMC10 = 0, MyMC100 = 0, MyMC1000 = 0;
-    // double PPTAmt24 = 0.0;
-    double neltemp = floor(temp * 100 + 0.5) / 100;
-    double nelrh = rh, nelsr = sr, nelppt = pptamnt;
+    NFDRS4StickInput in;
+    in.Year = Year;
+    in.Month = Month;
+    in.Day = Day;
+    in.Hour = Hour;
+    in.Temp = floor(temp * 100 + 0.5) / 100;
+    in.RH = rh;
+    in.SolarRad = sr;
+    in.PPTAmt = pptamnt;
+    in.RegObs = Hour == m_regObsHour;
 
-    // Update dead fuel moistures for each time period
     // Need to set the date / time of the sticks to one hour before the first observation time
-    if (SnowCovered)
+    if (SnowDay)
     {
-        neltemp = 0.;
-        nelrh = 0.999;
-        nelsr = 0.;
+        in.Temp = 0.;
+        in.RH = 0.999;
+        in.SolarRad = 0.;
         //nelppt = pptamnt;  // This is the place to deal with snow melt.
-        nelppt = 0.;
-
+        in.PPTAmt = 0.;
     }
-#pragma omp parallel sections num_threads(4)
-    {
-
-#pragma omp section
-        {
-
-            OneHourFM.update(Year, Month, Day, Hour, 0, 0, neltemp, nelrh, nelsr, nelppt, 0.02179999999, true);
-            MC1 = MyMC1 = OneHourFM.medianRadialMoisture() * 100;
-            //MC1 = MyMC1 = OneHourFM.meanWtdMoisture() * 100;
-        }
-#pragma omp section
-        {
+    return in;
+}
 
-            TenHourFM.update(Year, Month, Day, Hour, 0, 0, neltemp, nelrh, nelsr, nelppt, 0.02179999999, true);
-            MC10 = MyMC10 = TenHourFM.medianRadialMoisture() * 100;
-            //MC10 = MyMC10 = TenHourFM.meanWtdMoisture() * 100;
-        }
-#pragma omp section
+// Updates dead fuel stick Stick (0 to 3 for the 1-hour to 1000-hour stick) with
+// one hour of weather and returns its moisture content (%). A non-NULL forcing
+// replaces the stick's shared forcing for this update.
+double NFDRS4::UpdateDeadFuel(int Stick, const NFDRS4StickInput& in, const DFMForcing* forcing)
+{
+    switch (Stick)
+    {
+    case 0:
+        if (forcing) OneHourFM.setForcing(forcing);
+        OneHourFM.update(in.Year, in.Month, in.Day, in.Hour, 0, 0, in.Temp, in.RH, in.SolarRad, in.PPTAmt, 0.02179999999, true);
+        return OneHourFM.medianRadialMoisture() * 100;
+        //return OneHourFM.meanWtdMoisture() * 100;
+    case 1:
+        if (forcing) TenHourFM.setForcing(forcing);
+        TenHourFM.update(in.Year, in.Month, in.Day, in.Hour, 0, 0, in.Temp, in.RH, in.SolarRad, in.PPTAmt, 0.02179999999, true);
+        return TenHourFM.medianRadialMoisture() * 100;
+    case 2:
+        if (forcing) HundredHourFM.setForcing(forcing);
+        if (m_fm100Rate.interval() > 1)
         {
-
-            HundredHourFM.update(Year, Month, Day, Hour, 0, 0, neltemp, nelrh, nelsr, nelppt, 0.02179999999, true);
-            MC100 = MyMC100 = HundredHourFM.medianRadialMoisture() * 100;
-            //MC100 = MyMC100 = HundredHourFM.meanWtdMoisture() * 100;
-
+            return UpdateMultiRate(HundredHourFM, m_fm100Rate, in.Year, in.Month, in.Day, in.Hour, in.Temp, in.RH, in.SolarRad, in.PPTAmt, in.RegObs);
         }
-#pragma omp section
+        HundredHourFM.update(in.Year, in.Month, in.Day, in.Hour, 0, 0, in.Temp, in.RH, in.SolarRad, in.PPTAmt, 0.02179999999, true);
+        return HundredHourFM.medianRadialMoisture() * 100;
+    default:
+        if (forcing) ThousandHourFM.setForcing(forcing);
+        if (m_fm1000Rate.interval() > 1)
         {
-
-            ThousandHourFM.update(Year, Month, Day, Hour, 0, 0, neltemp, nelrh, nelsr, nelppt, 0.02179999999, true);
-            MC1000 = MyMC1000 = ThousandHourFM.medianRadialMoisture() * 100;
-            //MC1000 = MyMC1000 = ThousandHourFM.meanWtdMoisture() * 100;
-
+            return UpdateMultiRate(ThousandHourFM, m_fm1000Rate, in.Year, in.Month, in.Day, in.Hour, in.Temp, in.RH, in.SolarRad, in.PPTAmt, in.RegObs);
         }
+        ThousandHourFM.update(in.Year, in.Month, in.Day, in.Hour, 0, 0, in.Temp, in.RH, in.SolarRad, in.PPTAmt, 0.02179999999, true);
+        return ThousandHourFM.medianRadialMoisture() * 100;
     }
+}
 
-    //moved here so we have hourly fueltemp to save to DB
-    FuelTemperature = OneHourFM.surfaceTemperature();
-
+// End of Update(), from the dead fuel moistures on: 24 hour weather, live
+// fuel moistures at the regular observation hour, and the indexes. A non-NULL
+// Daily replaces the 24 hour weather of the hourly windows and the regular
+// observation hour of Init().
+void NFDRS4::FinishUpdate(int Year, int Month, int Day, int Hour, int Julian, double Temp, double RH, double PPTAmt, double WS, bool SnowDay, const NFDRS4DailyWeather* Daily)
+{
     //update 24 hour deques
     UTCTime thisUtcTime(Year, Month, Day, Hour, 0, 0);   
     time_t thisDiff = thisUtcTime - lastUtcUpdateTime;
     time_t hoursDiff = thisDiff / utcHourDiff;
     if (hoursDiff > 1)//gap, insert NODATA
     {
-        for (int h = 1; h < hoursDiff; h++)
-        {
-            qHourlyPrecip.push_back(NORECORD);
-            qHourlyTemp.push_back(NORECORD);
-            qHourlyRH.push_back(NORECORD);
-        }
-    }
-    qHourlyPrecip.push_back(PPTAmt);
-    qHourlyTemp.push_back(Temp);
-    qHourlyRH.push_back(RH);
-    //trim the deques
-    while (qHourlyTemp.size() > 24)
-        qHourlyTemp.pop_front();
-    while (qHourlyRH.size() > 24)
-        qHourlyRH.pop_front();
-    while (qHourlyPrecip.size() > 24)
-        qHourlyPrecip.pop_front();
-    //deques OK, now figure Min/Max's and 24 hour pcp
-    double MinRH = NORECORD, MinTemp = NORECORD, MaxTemp = NORECORD, pcp24 = 0.0;
-    
-    for (std::deque<double>::iterator it = qHourlyTemp.begin(); it != qHourlyTemp.end(); ++it)
-    {
-        if ((*it) != NORECORD)
-        {
-            if (MaxTemp == NORECORD)
-                MaxTemp = *it;
-            else
-                MaxTemp = max(MaxTemp, *it);
-            if (MinTemp == NORECORD)
-                MinTemp = *it;
-            else
-                MinTemp = min(MinTemp, *it);
-        }
+        qHourlyPrecip.PushMissing(hoursDiff - 1);
+        qHourlyTemp.PushMissing(hoursDiff - 1);
+        qHourlyRH.PushMissing(hoursDiff - 1);
     }
-    for (std::deque<double>::iterator it = qHourlyRH.begin(); it != qHourlyRH.end(); ++it)
+    qHourlyPrecip.Push(PPTAmt);
+    qHourlyTemp.Push(Temp);
+    qHourlyRH.Push(RH);
+    //windows OK, now figure Min/Max's and 24 hour pcp
+    double MinRH, MinTemp, MaxTemp, pcp24;
+    int RegObsHr = m_regObsHour;
+    if (Daily)
     {
-        if ((*it) != NORECORD)
-        {
-            if (MinRH == NORECORD)
-                MinRH = *it;
-            else
-                MinRH = min(MinRH, *it);
-        }
+        MinRH = Daily->MinRH, MinTemp = Daily->MinTemp, MaxTemp = Daily->MaxTemp, pcp24 = Daily->pcp24;
+        RegObsHr = Daily->RegObsHr;
     }
-    for (std::deque<double>::iterator it = qHourlyPrecip.begin(); it != qHourlyPrecip.end(); ++it)
+    else
     {
-        if (*it != NORECORD)
-            pcp24 += *it;
+        MinRH = qHourlyRH.Min(), MinTemp = qHourlyTemp.Min(), MaxTemp = qHourlyTemp.Max(), pcp24 = qHourlyPrecip.Sum();
     }
     // Update live fuel moisture once per day
-    if (Hour == m_regObsHour)// || num_updates==0)
+    if (Hour == RegObsHr)// || num_updates==0)
     {
         int secs = thisUtcTime.timestamp() - lastDailyUpdateTime.timestamp();
         //LFM requires temperatures in F and RH between 1 and 100
@@ -685,11 +612,9 @@ void NFDRS4::Update(int Year, int Month, int Day, int Hour, double Temp, double
         {
             int pDays = min(days - 1, nPrecipQueueDays);
             for (int p = 0; p < pDays; p++)
-                qPrecip.push_back(0.0);
+                qPrecip.Push(0.0);
         }
-        qPrecip.push_back(pcp24);
-        while (qPrecip.size() > nPrecipQueueDays)
-            qPrecip.pop_front();
+        qPrecip.Push(pcp24);
 
         HerbFM.Update(Temp, MaxTemp, MinTemp, RH, MinRH, Julian, GetXDaysPrecipitation(HerbFM.GetNumPrecipDays()), thisUtcTime.timestamp());
         WoodyFM.Update(Temp, MaxTemp, MinTemp, RH, MinRH, Julian, GetXDaysPrecipitation(WoodyFM.GetNumPrecipDays()), thisUtcTime.timestamp());
@@ -708,11 +633,163 @@ void NFDRS4::Update(int Year, int Month, int Day, int Hour, double Temp, double
     // Calculate the indices
 
     //double fSC, fERC, fBI, fIC;
-    iCalcIndexes((int)WS, SlopeClass);
+    UpdateIndexes((int)WS);
     YesterdayJDay = Julian;
     lastUtcUpdateTime = thisUtcTime;
 }
 
+// Stores the outputs of observation i of a Run(), at hour Hour; deferred
+// indexes are calculated only if they are stored
+static void StoreOutputs(NFDRS4& calc, const NFDRS4Outputs& Out, int i, int Hour)
+{
+    if (Out.MC1) Out.MC1[i] = calc.MC1;
+    if (Out.MC10) Out.MC10[i] = calc.MC10;
+    if (Out.MC100) Out.MC100[i] = calc.MC100;
+    if (Out.MC1000) Out.MC1000[i] = calc.MC1000;
+    if (Out.MCHERB) Out.MCHERB[i] = calc.MCHERB;
+    if (Out.MCWOOD) Out.MCWOOD[i] = calc.MCWOOD;
+    if (Out.FuelTemperature) Out.FuelTemperature[i] = calc.FuelTemperature;
+    if (Out.IndexHour < 0 || Out.IndexHour == Hour)
+    {
+        calc.CalcPendingIndexes((Out.BI ? NFDRS4::IndexBI : 0) | (Out.ERC ? NFDRS4::IndexERC : 0)
+            | (Out.SC ? NFDRS4::IndexSC : 0) | (Out.IC ? NFDRS4::IndexIC : 0));
+        if (Out.BI) Out.BI[i] = calc.BI;
+        if (Out.ERC) Out.ERC[i] = calc.ERC;
+        if (Out.SC) Out.SC[i] = calc.SC;
+        if (Out.IC) Out.IC[i] = calc.IC;
+        if (Out.ModelBI || Out.ModelERC || Out.ModelSC || Out.ModelIC)
+        {
+            int nm = calc.GetNumFuelModels();
+            for (int m = 0; m < nm; m++)
+            {
+                // A model GetModelIndexes() does not know is stored as zeros
+                double sc = 0.0, erc = 0.0, bi = 0.0, ic = 0.0;
+                if (!calc.GetModelIndexes(m, &sc, &erc, &bi, &ic))
+                    sc = erc = bi = ic = 0.0;
+                if (Out.ModelBI) Out.ModelBI[i * nm + m] = bi;
+                if (Out.ModelERC) Out.ModelERC[i * nm + m] = erc;
+                if (Out.ModelSC) Out.ModelSC[i * nm + m] = sc;
+                if (Out.ModelIC) Out.ModelIC[i * nm + m] = ic;
+            }
+        }
+    }
+    if (Out.GSI) Out.GSI[i] = calc.m_GSI;
+    if (Out.KBDI) Out.KBDI[i] = calc.KBDI;
+}
+
+int NFDRS4::Run(const NFDRS4Observation* Obs, int nObs, const NFDRS4Outputs& Out)
+{
+    if (m_parallelSticks && nObs > 1)
+        return RunParallelSticks(Obs, nObs, Out);
+    for (int i = 0; i < nObs; i++)
+    {
+        const NFDRS4Observation& o = Obs[i];
+        Update(o.Year, o.Month, o.Day, o.Hour, o.Temp, o.RH, o.PPTAmt, o.SolarRad, o.WS, o.SnowDay);
+        StoreOutputs(*this, Out, i, o.Hour);
+    }
+    return nObs > 0 ? nObs : 0;
+}
+
+// Hours of stick inputs prepared for each window of RunParallelSticks()
+static const int StickWindowHours = 168;
+
+// Run() with each dead fuel stick on its own thread. The observations are taken
+// in windows of up to StickWindowHours hours that do not reinitialize the
+// calculator after their first hour, so the sticks' inputs over the window are
+// known before any of them starts. Each stick then runs through the window at
+// its own pace while this thread finishes each hour's Update() as soon as all
+// four sticks are past it. Results are those of Update(), and a stick that throws
+// ends the run before its hour is finished, with the outputs of the hours before it.
+// The other sticks may by then be past that hour, so the station is restored to
+// the start of the window and the hours before the failing one are run again by
+// Update(), leaving it as Update() would have. Sticks with more nodes than a
+// snapshot holds cannot be restored; the station must then be re-initialized.
+int NFDRS4::RunParallelSticks(const NFDRS4Observation* Obs, int nObs, const NFDRS4Outputs& Out)
+{
+    NFDRS4StickPipeline& pipe = m_stickPipeline;
+    std::vector<int> julians;
+    NFDRS4Snapshot start;
+    int i = 0;
+    while (i < nObs)
+    {
+        bool restorable = Snapshot(&start);
+        // Window from observation i, which may reinitialize before the sticks start
+        const NFDRS4Observation& first = Obs[i];
+        int prevYear = first.Year, prevJulian = CalcJulianDay(first.Year, first.Month - 1, first.Day);
+        StartUpdate(first.Year, prevJulian, first.SnowDay);
+        pipe.Inputs.clear();
+        pipe.Forcing.clear();
+        julians.clear();
+        for (int j = i; j < nObs && (int)julians.size() < StickWindowHours; j++)
+        {
+            const NFDRS4Observation& o = Obs[j];
+            int Julian = CalcJulianDay(o.Year, o.Month - 1, o.Day);
+            if (j > i && IsUpdateGap(o.Year, Julian, prevYear, prevJulian))
+                break;
+            prevYear = o.Year;
+            prevJulian = Julian;
+            julians.push_back(Julian);
+            pipe.Inputs.push_back(DeadFuelInput(o.Year, o.Month, o.Day, o.Hour, o.Temp, o.RH, o.PPTAmt, o.SolarRad, o.SnowDay));
+            if (m_sharedForcing)
+            {
+                m_forcing.advance(pipe.Inputs.back().Temp, pipe.Inputs.back().RH);
+                pipe.Forcing.push_back(m_forcing);
+            }
+        }
+        const int n = (int)julians.size();
+        pipe.Start(this, n);
+        int k = 0;
+        try
+        {
+            for (; k < n; k++)
+            {
+                const NFDRS4Observation& o = Obs[i + k];
+                if (k > 0)
+                    StartUpdate(o.Year, julians[k], o.SnowDay);
+                pipe.WaitFor(k);
+                MC1 = pipe.MC[0][k];
+                MC10 = pipe.MC[1][k];
+                MC100 = pipe.MC[2][k];
+                MC1000 = pipe.MC[3][k];
+                FuelTemperature = pipe.FuelTemperature[k];
+                FinishUpdate(o.Year, o.Month, o.Day, o.Hour, julians[k], o.Temp, o.RH, o.PPTAmt, o.WS, o.SnowDay);
+                StoreOutputs(*this, Out, i + k, o.Hour);
+            }
+            pipe.Finish();
+        }
+        catch (...)
+        {
+            pipe.WaitIdle();
+            if (restorable && Restore(start))
+            {
+                for (int r = 0; r < k; r++)
+                {
+                    const NFDRS4Observation& o = Obs[i + r];
+                    Update(o.Year, o.Month, o.Day, o.Hour, o.Temp, o.RH, o.PPTAmt, o.SolarRad, o.WS, o.SnowDay);
+                }
+                if (m_sharedForcing)
+                {
+                    OneHourFM.setForcing(&m_forcing);
+                    TenHourFM.setForcing(&m_forcing);
+                    HundredHourFM.setForcing(&m_forcing);
+                    ThousandHourFM.setForcing(&m_forcing);
+                }
+            }
+            throw;
+        }
+        if (m_sharedForcing)
+        {
+            // m_forcing was advanced to the window's last hour: point the sticks back at it
+            OneHourFM.setForcing(&m_forcing);
+            TenHourFM.setForcing(&m_forcing);
+            HundredHourFM.setForcing(&m_forcing);
+            ThousandHourFM.setForcing(&m_forcing);
+        }
+        i += n;
+    }
+    return nObs;
+}
+
 void NFDRS4::UpdateDaily(int Year, int Month, int Day, int Julian, double Temp, double MinTemp, 
 	double MaxTemp, double RH, double MinRH, double pcp24, double WS,
 	double fMC1, double fMC10, double fMC100, double fMC1000, double fuelTemp,bool SnowDay)
@@ -748,11 +825,9 @@ void NFDRS4::UpdateDaily(int Year, int Month, int Day, int Julian, double Temp,
 	{
 		int pDays = min(days - 1, nPrecipQueueDays);
 		for (int p = 0; p < pDays; p++)
-			qPrecip.push_back(0.0);
+			qPrecip.Push(0.0);
 	}
-	qPrecip.push_back(pcp24);
-	while (qPrecip.size() > nPrecipQueueDays)
-		qPrecip.pop_front();
+	qPrecip.Push(pcp24);
 
 	// Update live fuel moisture once per day
 	HerbFM.Update(Temp, MaxTemp, MinTemp, RH, MinRH, Julian, GetXDaysPrecipitation(HerbFM.GetNumPrecipDays()), thisUtcTime.timestamp());
@@ -770,7 +845,7 @@ void NFDRS4::UpdateDaily(int Year, int Month, int Day, int Julian, double Temp,
 
 		//double fSC, fERC, fBI, fIC;
 		//FuelTemperature = fuelTemp;
-		iCalcIndexes((int)WS, SlopeClass);
+		UpdateIndexes((int)WS);
 
 
 	YesterdayJDay = Julian;
@@ -780,7 +855,8 @@ void NFDRS4::UpdateDaily(int Year, int Month, int Day, int Julian, double Temp,
 }
 
 
-void NFDRS4::CreateFuelModels()
+// Builds the table of the standard fuel models V, W, X, Y and Z
+static std::shared_ptr<const std::unordered_map<char, CFuelModelParams> > MakeStandardFuelModels()
 {
     CFuelModelParams fmV;
     fmV.setFuelModel('V');
@@ -892,17 +968,27 @@ void NFDRS4::CreateFuelModels()
     fmZ.setLDrought(7.0);
     fmZ.setWNDFC(0.4);
 
-    mapFuels.emplace(fmV.getFuelModel(), fmV);
-    mapFuels.emplace(fmW.getFuelModel(), fmW);
-    mapFuels.emplace(fmX.getFuelModel(), fmX);
-    mapFuels.emplace(fmY.getFuelModel(), fmY);
-    mapFuels.emplace(fmZ.getFuelModel(), fmZ);
+    std::shared_ptr<std::unordered_map<char, CFuelModelParams> > fuels = std::make_shared<std::unordered_map<char, CFuelModelParams> >();
+    fuels->emplace(fmV.getFuelModel(), fmV);
+    fuels->emplace(fmW.getFuelModel(), fmW);
+    fuels->emplace(fmX.getFuelModel(), fmX);
+    fuels->emplace(fmY.getFuelModel(), fmY);
+    fuels->emplace(fmZ.getFuelModel(), fmZ);
+    return fuels;
+}
+
+// Points the station at the standard fuel model table, which is built once
+// and shared by all stations until one adds a custom fuel
+void NFDRS4::CreateFuelModels()
+{
+    static const std::shared_ptr<const std::unordered_map<char, CFuelModelParams> > standardFuels = MakeStandardFuelModels();
+    m_fuels = standardFuels;
 }
 
 bool NFDRS4::iSetFuelModel(char cFM)
 {
-    auto it = mapFuels.equal_range(cFM).first;
-    if (it != mapFuels.end())
+    auto it = m_fuels->find(cFM);
+    if (it != m_fuels->end())
     {
         CFuelModelParams fm = (*it).second;
         FuelModel = fm.getFuelModel();
@@ -925,6 +1011,7 @@ bool NFDRS4::iSetFuelModel(char cFM)
         SCM = fm.getSCM();
         LDROUGHT = fm.getLDrought();
         WNDFC = fm.getWNDFC();
+        m_compiledFuel = NFDRS4CompiledFuel::Get(GetFuelBed(), SlopeClass);
         return true;
     }
     return false;
@@ -940,6 +1027,79 @@ int NFDRS4::iCalcIndexes(int iWS, int iSlopeCls, double fGSI /*) = -999 */ , dou
     return ret;
 }
 
+// Calculates the indexes of an update at wind speed iWS, or defers them to
+// their first read
+void NFDRS4::UpdateIndexes(int iWS)
+{
+    // Kept in eager mode too, for the model indexes after Restore()
+    m_pendingWS = iWS;
+    m_pendingSlopeCls = SlopeClass;
+    if (!m_lazyIndexes)
+    {
+        iCalcIndexes(iWS, SlopeClass);
+        if (!m_models.empty())
+            CalcModelIndexes(iWS, SlopeClass);
+        return;
+    }
+    m_pendingIndexes = AllIndexes;
+    m_modelsPending = !m_models.empty();
+}
+
+void NFDRS4::SetLazyIndexes(bool Lazy)
+{
+    if (!Lazy)
+    {
+        CalcPendingIndexes();
+        if (m_modelsPending)
+            CalcModelIndexes(m_pendingWS, m_pendingSlopeCls);
+    }
+    m_lazyIndexes = Lazy;
+}
+
+bool NFDRS4::GetLazyIndexes()
+{
+    return m_lazyIndexes;
+}
+
+// Calculates those of Indexes (IndexFlags) deferred by the last update and
+// not read since, with the stages they need
+void NFDRS4::CalcPendingIndexes(int Indexes)
+{
+    int want = Indexes & m_pendingIndexes;
+    if (!want)
+        return;
+    bool spread = (want & (IndexSC | IndexBI | IndexIC)) != 0;
+    double fSC, fERC, fBI, fIC;
+    iCalcIndexes(m_pendingWS, m_pendingSlopeCls, spread ? &fSC : NULL, &fERC, spread ? &fBI : NULL,
+        (want & IndexIC) ? &fIC : NULL);
+    // Indexes an eager update would not have calculated keep their values
+    m_pendingIndexes &= ~want;
+}
+
+double NFDRS4::GetSC()
+{
+    CalcPendingIndexes(IndexSC);
+    return SC;
+}
+
+double NFDRS4::GetERC()
+{
+    CalcPendingIndexes(IndexERC);
+    return ERC;
+}
+
+double NFDRS4::GetBI()
+{
+    CalcPendingIndexes(IndexBI);
+    return BI;
+}
+
+double NFDRS4::GetIC()
+{
+    CalcPendingIndexes(IndexIC);
+    return IC;
+}
+
 // Calculates all Components and Indices for NFDRS4
 // iWS: Windspeed (mph)
 // iSlopeCls: Slope Class (1-5 or actual in degrees)
@@ -947,331 +1107,159 @@ int NFDRS4::iCalcIndexes(int iWS, int iSlopeCls, double fGSI /*) = -999 */ , dou
 // fERC: Energy Release Component (dim)
 // fBI: Burning Index (dim)
 // fIC: Ignition Component (dim)
+// Outputs may be NULL to skip them and the stages only they need
 int NFDRS4::iCalcIndexes (int iWS, int iSlopeCls,double* fSC,double* fERC, double* fBI, double *fIC, double fGSI, double fKBDI)
 {
-
-    double STD = .0555, STL = .0555;
-    double RHOD = 32, RHOL = 32;
-    double ETASD = 0.4173969, ETASL = 0.4173969;
-    double WTOTD, WTOTL, W1N, W10N, W100N, WHERBN, WWOODN, WTOTLN;
-    double RHOBED, RHOBAR, BETBAR;
-    double HN1, HN10, HN100, HNHERB, HNWOOD, WRAT, MCLFE, MXL;
-    double SA1, SA10, SA100,  SAWOOD, SAHERB, SADEAD, SALIVE;
-    double F1, F10, F100, FHERB, FWOOD, FDEAD, FLIVE, WDEADN, WLIVEN;
-    double SGBRD, SGBRL, SGBRT, BETOP, GMAMX, AD, GMAOP, ZETA;
-    double DEDRT, LIVRT, ETAMD, ETAML, B, C, E, UFACT;
-    double IR, PHIWND, PHISLP;
-    double XF1, XF10, XF100, XFHERB, XFWOOD, HTSINK;
-    double F1E, F10E, F100E, F1000E, FHERBE, FWOODE, FDEADE, FLIVEE, WDEDNE, WLIVNE;
-    double SGBRDE, SGBRLE, SGBRTE, BETOPE, GMAMXE, ADE, GMAOPE;
-    double DEDRTE, LIVRTE, ETAMDE, ETAMLE;
-    double IRE, TAU;
-    double fWNDFC, PackingRatio, fDEPTH;
-
-    double fTemp = 0;
-    int itempWoody = 0;
-
     if ((iSlopeCls < 1) || (iWS < 0) || (iSlopeCls > 5) || (DEPTH <= 0))
         return(0);
 
-    /* Reset */
-    W1 = L1 * CTA;
-    W10 = L10 * CTA;
-    W100 = L100 * CTA;
-    W1000 = L1000 * CTA;
-    WWOOD = LWOOD * CTA;
-    WHERB = LHERB * CTA;
-    WWOOD = LWOOD * CTA;
-    WDROUGHT = LDROUGHT * CTA;
-    fDEPTH = DEPTH;
-
     double tmpKBDI = KBDI;
     if(fKBDI >= 0 && fKBDI <= 800)
     {
         tmpKBDI = fKBDI;
     }
-
-	if (tmpKBDI > KBDIThreshold )
-    {
-
-        WTOTD = W1 + W10 + W100;
-        WTOTL = WHERB + WWOOD;
-        WTOT = WTOTD + WTOTL;
-        PackingRatio = WTOT / fDEPTH;
-        if (PackingRatio == 0) PackingRatio = 1.0;
-        WTOTD = WTOTD + W1000;
-        DroughtUnit = WDROUGHT / (800.0 - KBDIThreshold);
-
-        W1 = W1 + (W1 / WTOTD) * (tmpKBDI - KBDIThreshold) * DroughtUnit;
-        W10 = W10 + (W10 / WTOTD) * (tmpKBDI - KBDIThreshold) * DroughtUnit;
-        W100 = W100 + (W100 / WTOTD) * (tmpKBDI - KBDIThreshold) * DroughtUnit;
-        W1000 = W1000 + (W1000 / WTOTD) * (tmpKBDI - KBDIThreshold) * DroughtUnit;
-        WTOT = W1 + W10 + W100 + W1000 + WTOTL;
-        fDEPTH = (WTOT - W1000) / PackingRatio;
-    }
-
-    // Herbaceous Load Transfers
-	//fTemp = Cure(MCHERB, fGSI, HerbFM.GetGreenupThreshold(), HerbFM.GetMaxGSI());
     if (fGSI >= 0.0)
         m_GSI = fGSI;
-	fTemp = Cure(fGSI, HerbFM.GetGreenupThreshold(), HerbFM.GetMaxGSI());
-	
-	WTOTD = W1P + W10 + W100 + W1000;					// Total Dead Fuel Loading
-	WTOTL = WHERBP + WWOOD;								// Total Live Fuel Loading
-	WTOT = WTOTD + WTOTL;								// Total Fuel Loading
-	W1N = W1P * (1.0 - STD);							// Net 1hr Fuel Loading
-	W10N = W10 * (1.0 - STD);							// Net 10hr Fuel Loading
-	W100N = W100 * (1.0 - STD);							// Net 100hr Fuel Loading
-	WHERBN = WHERBP * (1.0 - STL);						// Net Herbaceous Fuel Loading
-	WWOODN = WWOOD * (1.0 - STL);						// Net Woody Fuel Loading
-	WTOTLN = WTOTL * (1.0 - STL);						// Net Total Live Fuel Lodaing
-	RHOBED = (WTOT - W1000) / fDEPTH;					// Bulk density of the fuel bed
-	RHOBAR = ((WTOTL * RHOL) + (WTOTD * RHOD)) / WTOT;  // Weighted particle density of the fuel bed
-	BETBAR = RHOBED / RHOBAR;							// Ratio of bulk density to particle density
-
-    // If live net fuel loading is greater than 0, calculate the 
-	// Live Fuel Moisture of Extinction
-	if (WTOTLN > 0)
-    {
-        HN1 = W1N * exp(-138.0 / SG1);
-        HN10 =W10N  * exp(-138.0 / SG10);
-        HN100 = W100N * exp(-138.0 / SG100);
-        if ((-500 / SGHERB) < -180.218)
-        {HNHERB = 0;}
-        else
-        {HNHERB = WHERBN * exp(-500.0 / SGHERB);}
-
-        if ((-500 / SGWOOD) < -180.218)
-        {HNWOOD = 0;}
-        else
-        {HNWOOD = WWOODN * exp(-500.0 / SGWOOD);}
-
-        if ((HNHERB + HNWOOD) == 0)
-        {WRAT = 0;}
-        else
-        {WRAT = (HN1 + HN10 + HN100) / (HNHERB + HNWOOD);}
-        MCLFE = ((MC1 * HN1) + (MC10 * HN10) + (MC100 * HN100)) / (HN1 + HN10 + HN100);
-        MXL = (2.9 * WRAT * (1.0 - MCLFE / MXD) - 0.226) * 100;
-    }
-    else
-    {MXL = 0;}
-
-	if (MXL < MXD) MXL = MXD;
-	SA1 = (W1P / RHOD) * SG1;           // Surface area of dead 1hr fuel
-	SA10 = (W10 / RHOD) * SG10;         // Surface area of dead 10hr fuel
-	SA100 = (W100 / RHOD) * SG100;       // Surface area of dead 100hr fuel
-	SAHERB = (WHERBP / RHOL) * SGHERB;   // Surface area of live herbaceous fuel
-	SAWOOD = (WWOOD / RHOL) * SGWOOD;    // Surface area of live woody fuel
-	SADEAD = SA1 + SA10 + SA100;		// Surface area of dead fuel
-	SALIVE = SAHERB + SAWOOD;			// Surface area of live fuel
-
-	if (SADEAD <= 0) return(0);
-
-	F1 = SA1 / SADEAD;      //Proportion of dead-fuel surface area in 1-hour class,used as a weighting factor for ROS calculation
-	F10 = SA10 / SADEAD;    //Proportion of dead-fuel surface area in 10-hour class,used as a weighting factor for ROS calculation
-	F100 = SA100 / SADEAD;  //Proportion of dead-fuel surface area in 100-hour class,used as a weighting factor for ROS calculation
-    if (WTOTL <=0)
-    {
-       FHERB = 0;
-       FWOOD = 0;
-    }
-    else
-    {
-       FHERB = SAHERB / SALIVE;
-       FWOOD = SAWOOD / SALIVE;
-    }
-    FDEAD = SADEAD / (SADEAD + SALIVE);		// Fraction of Dead Fuel Surface area to total loading
-    FLIVE = SALIVE / (SADEAD + SALIVE);		// Fraction of Live Fuel Surface area to total loading
-    WDEADN = (F1 * W1N) + (F10 * W10N) + (F100 * W100N);	// Weighted deaf-fuel loading
-
-    if (SGWOOD > 1200 && SGHERB > 1200)
-    {WLIVEN = WTOTLN;}
-    else
-    {WLIVEN = (FWOOD * WWOODN) + (FHERB * WHERBN);}
-
-	// Characteristic surface area-to-volume ratio of dead fuel, surface area weighted
-	SGBRD = (F1 * SG1) + (F10 * SG10) + (F100 * SG100);
-
-	// Characteristic surface area-to-volume ratio of live fuel, surface area weighted.
-	SGBRL = (FHERB * SGHERB) + (FWOOD * SGWOOD);
-
-	// Characteristic surface area-to-volume ratio of fuel bed, surface area weighted.
-	SGBRT = (FDEAD * SGBRD) + (FLIVE * SGBRL);
-
-	// Optimum packing ratio, surface area weighted
-	BETOP = 3.348 * pow(SGBRT, -0.8189);
-
-	// Weighted maximum reaction velocity of surface area
-	GMAMX = pow(SGBRT, 1.5) / (495.0 + 0.0594 * pow(SGBRT, 1.5));
-	AD = 133 * pow(SGBRT, -0.7913);
-	// Weighted optimum reaction velocity of surface area
-	GMAOP = GMAMX * pow((BETBAR / BETOP), AD) * exp(AD * (1.0 - (BETBAR / BETOP)));
-
-    ZETA = exp((0.792 + 0.681 * pow(SGBRT, 0.5)) * (BETBAR + 0.1));
-    ZETA = ZETA / (192.0 + 0.2595 * SGBRT);
-
-    WTMCD = (F1 * MC1) + (F10 * MC10) + (F100 * MC100);
-    WTMCL = (FHERB * MCHERB) + (FWOOD * MCWOOD);
-    DEDRT = WTMCD / MXD;
-    LIVRT = WTMCL / MXL;
-    ETAMD = 1.0 - 2.59 * DEDRT + 5.11 * pow(DEDRT,2.0) - 3.52 * pow(DEDRT, 3.0);
-    ETAML = 1.0 - 2.59 * LIVRT + 5.11 * pow(LIVRT,2.0) - 3.52 * pow(LIVRT, 3.0);
-    if (ETAMD < 0) ETAMD = 0;
-    if (ETAMD > 1) ETAMD = 1;
-    if (ETAML < 0) ETAML = 0;
-    if (ETAML > 1) ETAML = 1;
-
-    B = 0.02526 * pow(SGBRT, 0.54);
-    C = 7.47 * exp(-0.133 * pow(SGBRT,0.55));
-    E = 0.715 * exp(-3.59 * pow(10.0, -4.0) * SGBRT);
-    UFACT = C * pow(BETBAR / BETOP, -1 * E);
-
-    /* HL = HD */
-    IR = GMAOP * ((WDEADN * HD * ETASD * ETAMD) + (WLIVEN * HD * ETASL * ETAML));
-    fWNDFC = WNDFC;
-
-    if (88.0 * (double) (iWS) * fWNDFC > 0.9 * IR)
-    {
-        PHIWND = UFACT * pow(0.9 * IR, B);
-    }
-    else
-    {
-        PHIWND = UFACT * pow((double) (iWS) * 88.0 * fWNDFC, B);
-    }
 
-    // Actual slopes in degrees (>5) can now be input
-    // Matches forumla used in WIMS developed by Larry Bradshaw (31 Aug 2016)
-    double slpfct = 0.267;
-    switch (iSlopeCls)
-    {
-    case 1:
-      slpfct = 0.267;
-      break;
-    case 2:
-      slpfct = 0.533;
-      break;
-    case 3:
-      slpfct = 1.068;
-      break;
-    case 4:
-      slpfct = 2.134;
-      break;
-    case 5:
-      slpfct = 4.273;
-      break;
-    default:
-        slpfct = 5.275 * (tan(degreesToRadians((double)iSlopeCls)));
-        break;
-    }
-    //cout << slpfct << endl;
-    PHISLP = slpfct * pow(BETBAR, -0.3);
-
-    XF1 = F1 * exp(-138.0 / (double) (SG1)) * (250.0 + 11.16 * MC1);
-    XF10 = F10 * exp(-138.0 / (double)(SG10)) * (250.0 + 11.16 * MC10);
-    XF100 = F100 * exp(-138.0 / (double)(SG100)) * (250.0 + 11.16 * MC100);
-    XFHERB = FHERB * exp(-138.0 / (double)(SGHERB)) * (250.0 + 11.16 * MCHERB);
-    XFWOOD = FWOOD * exp(-138.0 / (double)(SGWOOD)) * (250.0 + 11.16 * MCWOOD);
-    HTSINK = RHOBED * (FDEAD * (XF1 + XF10 + XF100) + FLIVE * (XFHERB + XFWOOD));
-    // cout << HTSINK << " " << RHOBED << " " << FDEAD << " " << XF1 << " " << XF10 << " " << XF100 << " " << FLIVE << " " << XFHERB << " " << XFWOOD << endl;
-    *fSC = IR * ZETA * (1.0 + PHISLP + PHIWND) / HTSINK;
-
-    F1E = W1P / WTOTD;
-    F10E = W10 / WTOTD;
-    F100E = W100 / WTOTD;
-    F1000E = W1000 / WTOTD;
-    /* NOTE 4 */
-    if (WTOTL <=0)
+    // Compiled again only if the fuel bed or slope class changed since iSetFuelModel()
+    NFDRS4FuelBed bed = GetFuelBed();
+    if (!m_compiledFuel || !m_compiledFuel->Matches(bed, iSlopeCls))
+        m_compiledFuel = NFDRS4CompiledFuel::Get(bed, iSlopeCls);
+
+    // Transferred loads, kept for reporting; derived again only when KBDI or GSI change
+    NFDRS4UpdateIndexBed(*m_compiledFuel, tmpKBDI, m_GSI, &m_indexBedCache);
+    const NFDRS4FuelLoads& loads = m_indexBedCache.Loads;
+    W1 = loads.W1;
+    W10 = loads.W10;
+    W100 = loads.W100;
+    W1000 = loads.W1000;
+    WHERB = loads.WHERB;
+    WWOOD = loads.WWOOD;
+    WDROUGHT = loads.WDROUGHT;
+    if (loads.Drought)
+        DroughtUnit = loads.DroughtUnit;
+    fctCur = loads.fctCur;
+    W1P = loads.W1P;
+    WHERBP = loads.WHERBP;
+    WTOT = loads.WTOT;
+
+    double ws = iWS;
+    NFDRS4IndexInputs in;
+    in.MC1 = &MC1;
+    in.MC10 = &MC10;
+    in.MC100 = &MC100;
+    in.MC1000 = &MC1000;
+    in.MCHERB = &MCHERB;
+    in.MCWOOD = &MCWOOD;
+    in.FuelTemperature = &FuelTemperature;
+    in.WS = &ws;
+    in.KBDI = &tmpKBDI;
+    in.GSI = &m_GSI;
+    NFDRS4IndexOutputs out;
+    out.SC = fSC;
+    out.ERC = fERC;
+    out.BI = fBI;
+    out.IC = fIC;
+    out.WTMCD = &WTMCD;
+    out.WTMCL = &WTMCL;
+    out.WTMCDE = &WTMCDE;
+    out.WTMCLE = &WTMCLE;
+    int ret = NFDRS4CalcIndexes(*m_compiledFuel, 1, in, out, false, &m_indexBedCache);
+    if (ret)
     {
-        FHERBE = 0;
-        FWOODE = 0;
-    }
-    else
-    {
-        FHERBE = WHERBP / WTOTL;
-        FWOODE = WWOOD / WTOTL;
-    }
-    FDEADE = WTOTD / WTOT;
-    FLIVEE = WTOTL / WTOT;
-    WDEDNE = WTOTD * (1.0 - STD);
-    WLIVNE = WTOTL * (1.0 - STL);
-    SGBRDE = (F1E * SG1) + (F10E * SG10) + (F100E * SG100) + (F1000E * SG1000);
-    SGBRLE = (FHERBE * SGHERB) + (FWOODE * SGWOOD);
-    SGBRTE = (FDEADE * SGBRDE) + (FLIVEE * SGBRLE);
-    BETOPE = 3.348 * pow(SGBRTE, -0.8189);
-    GMAMXE = pow(SGBRTE, 1.5) / (495.0 + 0.0594 * pow(SGBRTE, 1.5));
-    ADE = 133 * pow(SGBRTE, -0.7913);
-    GMAOPE = GMAMXE * pow( (BETBAR/BETOPE), ADE) * exp(ADE * (1.0 - (BETBAR / BETOPE)));
-
-    WTMCDE = (F1E * MC1) + (F10E * MC10) + (F100E * MC100) + (F1000E * MC1000);
-    WTMCLE = (FHERBE * MCHERB) + (FWOODE * MCWOOD);
-    DEDRTE = WTMCDE / MXD;
-    LIVRTE = WTMCLE / MXL;
-    ETAMDE = 1.0 - 2.0 * DEDRTE + 1.5 * pow(DEDRTE,2.0) - 0.5 * pow(DEDRTE, 3.0);
-    ETAMLE = 1.0 - 2.0 * LIVRTE + 1.5 * pow(LIVRTE,2.0) - 0.5 * pow(LIVRTE, 3.0);
-    if (ETAMDE < 0) ETAMDE = 0;
-    if (ETAMDE > 1) ETAMDE = 1;
-    if (ETAMLE < 0) ETAMLE = 0;
-    if (ETAMLE > 1) ETAMLE = 1;
-
-    IRE = (FDEADE * WDEDNE * HD * ETASD * ETAMDE);
-    /* HL = HD */
-    IRE = GMAOPE * (IRE + (FLIVEE * WLIVNE * (double) (HD) * ETASL * ETAMLE));
-    TAU = 384.0 / SGBRT;
-    *fERC = 0.04 * IRE * TAU;
-    //cout << F1E  << " " << SG1 << " " << F10E << " " <<  SG10 << " " << F100E << " " <<SG100 << " " << F1000E << " " << SG1000 << endl;
-    //cout << FDEADE << " " << SGBRDE << " " << FLIVEE << " " <<  SGBRLE << endl;
-    //cout << IRE << " " << TAU << " " << GMAOPE << " " << pow(SGBRTE, 1.5) << " " << SGBRTE <<  endl;
-    //cout << BETBAR << " " << BETOPE << endl;
-    *fBI = (.301 * pow((*fSC * *fERC), 0.46)) * 10.0;
-    ERC = *fERC;
-    BI = *fBI;
-    SC = *fSC;
-    // Finally, calculate the Igntion Component
-    double TMPPRM = 0.0, PNORM1 = 0.00232, PNORM2 = 0.99767;
-    double QIGN = 0.0, CHI = 0.0, PI = 0.0, SCN = 0.0, PFI = 0.0;
-	IC = 0.0;
-    if (SCM <= 0) IC = 0;
-
-    // Replace iTemp with the Nelson-derived fuel surface temperature
-	TMPPRM = FuelTemperature;
-	//TMPPRM = OneHourFM.meanWtdTemperature();
-    QIGN = 144.5 - (0.266 * TMPPRM) - (0.00058 * TMPPRM * TMPPRM)
-             - (0.01 * TMPPRM * MC1)
-          + 18.54 * (1.0 - exp(-0.151 * MC1))
-          + 6.4 * MC1;
-
-    if (QIGN >= 344.0) 
-        IC = 0;
-    else
-    {
-        CHI = (344.0 - QIGN) / 10.0;
-        if ((pow(CHI, 3.66) * 0.000923 / 50.0) <= PNORM1) 
-            IC = 0;
-        else
+        if (fERC)
         {
-            PI = ((pow(CHI, 3.66) * 0.000923 / 50.0) - PNORM1) * 100.0 / PNORM2;
-            if (PI < 0.0) PI = 0.0;
-            if (PI > 100.0) PI = 100.0;
-            SCN = 100.0 * SC / SCM;
-            if (SCN > 100.0) SCN = 100.0;
-            PFI = pow(SCN, 0.5);
-            IC = 0.10 * PI * PFI;
+            ERC = *fERC;
+            m_pendingIndexes &= ~IndexERC;
+        }
+        if (fBI)
+        {
+            BI = *fBI;
+            m_pendingIndexes &= ~IndexBI;
+        }
+        if (fSC)
+        {
+            SC = *fSC;
+            m_pendingIndexes &= ~IndexSC;
+        }
+        if (fIC)
+        {
+            IC = *fIC;
+            m_pendingIndexes &= ~IndexIC;
         }
-    }
-
-    if (SC < 0.00001) IC = 0.0;
-    *fIC = IC;
 
-    /* Reset Just To Be Safe */
-    W1 = L1 * CTA;
-    W10 = L10 * CTA;
-    W100 = L100 * CTA;
-    W1000 = L1000 * CTA;
-    WWOOD = LWOOD * CTA;
-    WDROUGHT = LDROUGHT * CTA;
+        /* Reset Just To Be Safe */
+        W1 = L1 * CTA;
+        W10 = L10 * CTA;
+        W100 = L100 * CTA;
+        W1000 = L1000 * CTA;
+        WWOOD = LWOOD * CTA;
+        WDROUGHT = LDROUGHT * CTA;
+    }
+    return ret;
+}
 
-    return (1);
+int NFDRS4::iCalcIndexSweep(int nWinds, const int* iWS, int nSlopes, const int* iSlopeCls, double* fSC, double* fBI, double* fIC, double fGSI, double fKBDI)
+{
+    if (DEPTH <= 0)
+        return 0;
 
+    double tmpKBDI = KBDI;
+    if (fKBDI >= 0 && fKBDI <= 800)
+        tmpKBDI = fKBDI;
+    double gsi = (fGSI >= 0.0) ? fGSI : m_GSI;
+
+    // Any valid slope class of the compiled fuel will do, as the sweep supplies its own
+    NFDRS4FuelBed bed = GetFuelBed();
+    if (!m_compiledFuel || !m_compiledFuel->IsValid() || !m_compiledFuel->Matches(bed, m_compiledFuel->GetSlopeClass()))
+        m_compiledFuel = NFDRS4CompiledFuel::Get(bed, ((SlopeClass >= 1) && (SlopeClass <= 5)) ? SlopeClass : 1);
+
+    std::vector<double> ws(iWS, iWS + nWinds);
+    NFDRS4IndexInputs in;
+    in.MC1 = &MC1;
+    in.MC10 = &MC10;
+    in.MC100 = &MC100;
+    in.MC1000 = &MC1000;
+    in.MCHERB = &MCHERB;
+    in.MCWOOD = &MCWOOD;
+    in.FuelTemperature = &FuelTemperature;
+    in.KBDI = &tmpKBDI;
+    in.GSI = &gsi;
+    NFDRS4SweepOutputs out;
+    out.SC = fSC;
+    out.BI = fBI;
+    out.IC = fIC;
+    return NFDRS4CalcIndexSweep(*m_compiledFuel, in, nWinds, ws.data(), nSlopes, iSlopeCls, out, &m_indexBedCache);
+}
+
+/// @brief Fuel bed of the current fuel model, load transfer and herbaceous curing settings,
+/// for NFDRS4CalcIndexes().
+NFDRS4FuelBed NFDRS4::GetFuelBed()
+{
+    NFDRS4FuelBed bed;
+    bed.SG1 = SG1;
+    bed.SG10 = SG10;
+    bed.SG100 = SG100;
+    bed.SG1000 = SG1000;
+    bed.SGHERB = SGHERB;
+    bed.SGWOOD = SGWOOD;
+    bed.L1 = L1;
+    bed.L10 = L10;
+    bed.L100 = L100;
+    bed.L1000 = L1000;
+    bed.LHERB = LHERB;
+    bed.LWOOD = LWOOD;
+    bed.LDROUGHT = LDROUGHT;
+    bed.DEPTH = DEPTH;
+    bed.MXD = MXD;
+    bed.HD = HD;
+    bed.SCM = SCM;
+    bed.WNDFC = WNDFC;
+    bed.CTA = CTA;
+    bed.KBDIThreshold = KBDIThreshold;
+    bed.GreenupThreshold = HerbFM.GetGreenupThreshold();
+    bed.MaxGSI = HerbFM.GetMaxGSI();
+    return bed;
 }
 /* begin iCalcKBDI **********************************************************
 *
@@ -1471,9 +1459,20 @@ void NFDRS4::SetThousandHourParams(double radius, double adsorptionRate, double
     Set1000HourDesorptionRate(desorptionRate);
 }
 
+// Reports a stick whose radius gives a node count the fixed node kernel of
+// DeadFuelMoistureStandard was not compiled for. Its results are unchanged but
+// its updates run the slower run-time node loops.
+static void ReportStickNodes(const DeadFuelMoistureStandard& Stick, double Radius)
+{
+    if (!Stick.fixedNodes() && Diagnostics::report(Diag_StickNodes))
+        Diagnostics::format(Diag_StickNodes, "%s stick radius %g cm gives %d nodes, the fixed node kernel runs %d; using the run-time node loops",
+            Stick.name().c_str(), Radius, Stick.stickNodes(), DFM_StandardNodes);
+}
+
 void NFDRS4::Set1HourRadius(double radius)
 {
     OneHourFM.initializeParameters(radius, "One Hour");
+    ReportStickNodes(OneHourFM, radius);
 }
 
 void NFDRS4::Set1HourAdsorptionRate(double adsorptionRate)
@@ -1496,9 +1495,30 @@ void NFDRS4::Set1HourDesorptionRate(double desorptionRate)
     OneHourFM.setDesorptionRate(desorptionRate);
 }
 
+void NFDRS4::Set1HourTabulatedDiffusivity(bool tabulated)
+{
+    OneHourFM.setTabulatedDiffusivity(tabulated);
+}
+
+void NFDRS4::Set1HourSimdDiffusivity(bool simd)
+{
+    OneHourFM.setSimdDiffusivity(simd);
+}
+
+void NFDRS4::Set1HourEquilibriumSkip(bool skip)
+{
+    OneHourFM.setEquilibriumSkip(skip);
+}
+
+void NFDRS4::Set1HourImplicitSolver(bool implicit, int moistureSteps)
+{
+    OneHourFM.setImplicitSolver(implicit, moistureSteps);
+}
+
 void NFDRS4::Set10HourRadius(double radius)
 {
     TenHourFM.initializeParameters(radius, "Ten Hour");
+    ReportStickNodes(TenHourFM, radius);
 }
 
 void NFDRS4::Set10HourAdsorptionRate(double adsorptionRate)
@@ -1521,9 +1541,30 @@ void NFDRS4::Set10HourDesorptionRate(double desorptionRate)
     TenHourFM.setDesorptionRate(desorptionRate);
 }
 
+void NFDRS4::Set10HourTabulatedDiffusivity(bool tabulated)
+{
+    TenHourFM.setTabulatedDiffusivity(tabulated);
+}
+
+void NFDRS4::Set10HourSimdDiffusivity(bool simd)
+{
+    TenHourFM.setSimdDiffusivity(simd);
+}
+
+void NFDRS4::Set10HourEquilibriumSkip(bool skip)
+{
+    TenHourFM.setEquilibriumSkip(skip);
+}
+
+void NFDRS4::Set10HourImplicitSolver(bool implicit, int moistureSteps)
+{
+    TenHourFM.setImplicitSolver(implicit, moistureSteps);
+}
+
 void NFDRS4::Set100HourRadius(double radius)
 {
     HundredHourFM.initializeParameters(radius, "Hundred Hour");
+    ReportStickNodes(HundredHourFM, radius);
 }
 
 void NFDRS4::Set100HourAdsorptionRate(double adsorptionRate)
@@ -1546,9 +1587,30 @@ void NFDRS4::Set100HourDesorptionRate(double desorptionRate)
     HundredHourFM.setDesorptionRate(desorptionRate);
 }
 
+void NFDRS4::Set100HourTabulatedDiffusivity(bool tabulated)
+{
+    HundredHourFM.setTabulatedDiffusivity(tabulated);
+}
+
+void NFDRS4::Set100HourSimdDiffusivity(bool simd)
+{
+    HundredHourFM.setSimdDiffusivity(simd);
+}
+
+void NFDRS4::Set100HourEquilibriumSkip(bool skip)
+{
+    HundredHourFM.setEquilibriumSkip(skip);
+}
+
+void NFDRS4::Set100HourImplicitSolver(bool implicit, int moistureSteps)
+{
+    HundredHourFM.setImplicitSolver(implicit, moistureSteps);
+}
+
 void NFDRS4::Set1000HourRadius(double radius)
 {
     ThousandHourFM.initializeParameters(radius, "Thousand Hour");
+    ReportStickNodes(ThousandHourFM, radius);
 }
 
 void NFDRS4::Set1000HourAdsorptionRate(double adsorptionRate)
@@ -1571,6 +1633,121 @@ void NFDRS4::Set1000HourDesorptionRate(double desorptionRate)
     ThousandHourFM.setDesorptionRate(desorptionRate);
 }
 
+void NFDRS4::Set1000HourTabulatedDiffusivity(bool tabulated)
+{
+    ThousandHourFM.setTabulatedDiffusivity(tabulated);
+}
+
+void NFDRS4::Set1000HourSimdDiffusivity(bool simd)
+{
+    ThousandHourFM.setSimdDiffusivity(simd);
+}
+
+void NFDRS4::Set1000HourEquilibriumSkip(bool skip)
+{
+    ThousandHourFM.setEquilibriumSkip(skip);
+}
+
+void NFDRS4::Set1000HourImplicitSolver(bool implicit, int moistureSteps)
+{
+    ThousandHourFM.setImplicitSolver(implicit, moistureSteps);
+}
+
+// Seeds the random perturbation streams of the four dead fuel sticks.  Each
+// stick draws from its own stream keyed by randseed, stationID and the stick
+// name, so results do not depend on thread scheduling or on other stations.
+// Call after the Set*Params() methods, which reset the seed.
+void NFDRS4::SetDeadFuelRandomSeed(int randseed, std::string stationID)
+{
+    OneHourFM.setRandomSeed(randseed);
+    OneHourFM.setRandomStream(stationID);
+    TenHourFM.setRandomSeed(randseed);
+    TenHourFM.setRandomStream(stationID);
+    HundredHourFM.setRandomSeed(randseed);
+    HundredHourFM.setRandomStream(stationID);
+    ThousandHourFM.setRandomSeed(randseed);
+    ThousandHourFM.setRandomStream(stationID);
+}
+
+void NFDRS4::SetSharedForcing(bool shared)
+{
+    m_sharedForcing = shared;
+    m_forcing.reset();
+    if (!shared)
+    {
+        OneHourFM.setForcing(NULL);
+        TenHourFM.setForcing(NULL);
+        HundredHourFM.setForcing(NULL);
+        ThousandHourFM.setForcing(NULL);
+    }
+}
+
+bool NFDRS4::GetSharedForcing()
+{
+    return m_sharedForcing;
+}
+
+// Derives the forcing for the sticks' next update and points them at it.
+// Runs before the stick updates, which then only read m_forcing, so they may
+// run in parallel. The pointers are set each time so that copies of this
+// object never use another's forcing.
+void NFDRS4::AdvanceSharedForcing(double temp, double rh)
+{
+    m_forcing.advance(temp, rh);
+    OneHourFM.setForcing(&m_forcing);
+    TenHourFM.setForcing(&m_forcing);
+    HundredHourFM.setForcing(&m_forcing);
+    ThousandHourFM.setForcing(&m_forcing);
+}
+
+void NFDRS4::SetParallelSticks(bool parallel)
+{
+    m_parallelSticks = parallel;
+    if (!parallel)
+        m_stickPipeline.Stop();
+}
+
+bool NFDRS4::GetParallelSticks()
+{
+    return m_parallelSticks;
+}
+
+void NFDRS4::Set100HourUpdateInterval(int hours)
+{
+    m_fm100Rate.setInterval(hours);
+}
+
+int NFDRS4::Get100HourUpdateInterval()
+{
+    return m_fm100Rate.interval();
+}
+
+void NFDRS4::Set1000HourUpdateInterval(int hours)
+{
+    m_fm1000Rate.setInterval(hours);
+}
+
+int NFDRS4::Get1000HourUpdateInterval()
+{
+    return m_fm1000Rate.interval();
+}
+
+// Gathers this hour's observation for a slow stick and updates the stick
+// once the rate's interval is complete, or at the regular observation hour
+// so that the daily indexes see an updated stick. Returns the stick's
+// moisture content (%), projected from its last update to this hour.
+double NFDRS4::UpdateMultiRate(DeadFuelMoisture& fm, DFMMultiRate& rate, int Year, int Month, int Day, int Hour,
+    double temp, double rh, double sr, double ppt, bool regObs)
+{
+    rate.add(temp, rh, sr, ppt);
+    if (rate.due() || regObs)
+    {
+        fm.updateSeries(Year, Month, Day, Hour, rate, 0.02179999999);
+        rate.integrated(fm.medianRadialMoisture() * 100);
+    }
+    return rate.projected(fm.medianRadialMoisture() * 100);
+}
+
 void NFDRS4::SetStartKBDI(int sKBDI)
 {
 	YKBDI = KBDI = StartKBDI = sKBDI;
@@ -1583,18 +1760,7 @@ int NFDRS4::GetStartKBDI()
 
 double NFDRS4::GetXDaysPrecipitation(int nDays)
 {
-	double startVal = 0.0, val = 0.0;
-	if (nDays >= qPrecip.size())
-		val = std::accumulate(qPrecip.begin(), qPrecip.end(), startVal);
-	else
-	{
-		int startDay = qPrecip.size() - nDays;
-		for (int d = startDay; d < qPrecip.size(); d++)
-		{
-			val += qPrecip.at(d);
-		}
-	}
-	return val;
+	return qPrecip.SumLast(nDays);
 }
 
 bool NFDRS4::ReadState(string fileName)
@@ -1614,6 +1780,8 @@ bool NFDRS4::SaveState(string fileName)
 
 bool NFDRS4::LoadState(NFDRS4State state)
 {
+	m_pendingIndexes = 0;
+	m_modelsPending = false;
 	NFDRSVersion = state.m_NFDRSVersion;
 	Lat = state.m_Lat;
 	FuelModel = state.m_FuelModel;
@@ -1649,19 +1817,20 @@ bool NFDRS4::LoadState(NFDRS4State state)
 	StartKBDI = state.m_StartKBDI;
 	YesterdayJDay = state.m_YesterdayJDay;
 	YKBDI = state.m_YKBDI;
+	qPrecip.Clear();
 	for (int i = 0; i < state.m_qPrecip.size(); i++)
 	{
-		qPrecip.push_back(state.m_qPrecip.at(i));
+		qPrecip.Push(state.m_qPrecip.at(i));
 	}
     //added 2021/01/26 - Hourly temp RH and precip deques
-    qHourlyPrecip.clear();
-    qHourlyRH.clear();
-    qHourlyTemp.clear();
+    qHourlyPrecip.Clear();
+    qHourlyRH.Clear();
+    qHourlyTemp.Clear();
     for (int h = 0; h < nHoursPerDay; h++)
     {
-        qHourlyTemp.push_back(state.m_qHourlyTemp[h]);
-        qHourlyRH.push_back(state.m_qHourlyRH[h]);
-        qHourlyPrecip.push_back(state.m_qHourlyPrecip[h]);
+        qHourlyTemp.Push(state.m_qHourlyTemp[h]);
+        qHourlyRH.Push(state.m_qHourlyRH[h]);
+        qHourlyPrecip.Push(state.m_qHourlyPrecip[h]);
     }
     //end 2021/01/26 additions
 	OneHourFM.SetState(state.fm1State);
@@ -1675,66 +1844,272 @@ bool NFDRS4::LoadState(NFDRS4State state)
 	return true;
 }
 
+bool NFDRS4::Snapshot(NFDRS4Snapshot* Snap)
+{
+    if (!OneHourFM.snapshot(&Snap->OneHour) || !TenHourFM.snapshot(&Snap->TenHour)
+        || !HundredHourFM.snapshot(&Snap->HundredHour) || !ThousandHourFM.snapshot(&Snap->ThousandHour)
+        || !m_fm100Rate.snapshot(&Snap->HundredHourRate) || !m_fm1000Rate.snapshot(&Snap->ThousandHourRate)
+        || !HerbFM.GetSnapshot(&Snap->Herb) || !WoodyFM.GetSnapshot(&Snap->Woody)
+        || !qPrecip.Snapshot(&Snap->Precip) || !qHourlyPrecip.Snapshot(&Snap->HourlyPrecip)
+        || !qHourlyTemp.Snapshot(&Snap->HourlyTemp) || !qHourlyRH.Snapshot(&Snap->HourlyRH))
+        return false;
+    Snap->Forcing = m_forcing;
+    Snap->LastUtcUpdateTime = lastUtcUpdateTime;
+    Snap->LastDailyUpdateTime = lastDailyUpdateTime;
+    Snap->MC1 = MC1;
+    Snap->MC10 = MC10;
+    Snap->MC100 = MC100;
+    Snap->MC1000 = MC1000;
+    Snap->MCWOOD = MCWOOD;
+    Snap->MCHERB = MCHERB;
+    Snap->FuelTemperature = FuelTemperature;
+    Snap->BI = BI;
+    Snap->ERC = ERC;
+    Snap->SC = SC;
+    Snap->IC = IC;
+    Snap->W1 = W1;
+    Snap->W10 = W10;
+    Snap->W100 = W100;
+    Snap->W1000 = W1000;
+    Snap->WWOOD = WWOOD;
+    Snap->WHERB = WHERB;
+    Snap->WDROUGHT = WDROUGHT;
+    Snap->W1P = W1P;
+    Snap->WHERBP = WHERBP;
+    Snap->WTOT = WTOT;
+    Snap->DroughtUnit = DroughtUnit;
+    Snap->fctCur = fctCur;
+    Snap->WTMCD = WTMCD;
+    Snap->WTMCL = WTMCL;
+    Snap->WTMCDE = WTMCDE;
+    Snap->WTMCLE = WTMCLE;
+    Snap->CummPrecip = CummPrecip;
+    Snap->GSI = m_GSI;
+    Snap->KBDI = KBDI;
+    Snap->YKBDI = YKBDI;
+    Snap->PrevYear = PrevYear;
+    Snap->YesterdayJDay = YesterdayJDay;
+    Snap->nConsectiveSnowDays = nConsectiveSnowDays;
+    Snap->RegObsHour = m_regObsHour;
+    Snap->PendingIndexes = m_pendingIndexes;
+    Snap->PendingWS = m_pendingWS;
+    Snap->PendingSlopeCls = m_pendingSlopeCls;
+    Snap->SnowCovered = SnowCovered;
+    return true;
+}
+
+bool NFDRS4::Restore(const NFDRS4Snapshot& Snap)
+{
+    // Check everything first, so a snapshot that does not fit changes nothing
+    if (Snap.OneHour.nodes != OneHourFM.stickNodes() || Snap.TenHour.nodes != TenHourFM.stickNodes()
+        || Snap.HundredHour.nodes != HundredHourFM.stickNodes() || Snap.ThousandHour.nodes != ThousandHourFM.stickNodes()
+        || Snap.HundredHourRate.interval != m_fm100Rate.interval() || Snap.ThousandHourRate.interval != m_fm1000Rate.interval()
+        || Snap.Herb.GSI.State.Capacity != HerbFM.GetMAPeriod() || Snap.Woody.GSI.State.Capacity != WoodyFM.GetMAPeriod()
+        || Snap.Precip.State.Capacity != qPrecip.GetCapacity() || Snap.HourlyPrecip.State.Capacity != qHourlyPrecip.GetCapacity()
+        || Snap.HourlyTemp.State.Capacity != qHourlyTemp.GetCapacity() || Snap.HourlyRH.State.Capacity != qHourlyRH.GetCapacity())
+        return false;
+    if (!OneHourFM.restore(Snap.OneHour) || !TenHourFM.restore(Snap.TenHour)
+        || !HundredHourFM.restore(Snap.HundredHour) || !ThousandHourFM.restore(Snap.ThousandHour)
+        || !m_fm100Rate.restore(Snap.HundredHourRate) || !m_fm1000Rate.restore(Snap.ThousandHourRate)
+        || !HerbFM.SetSnapshot(Snap.Herb) || !WoodyFM.SetSnapshot(Snap.Woody)
+        || !qPrecip.Restore(Snap.Precip) || !qHourlyPrecip.Restore(Snap.HourlyPrecip)
+        || !qHourlyTemp.Restore(Snap.HourlyTemp) || !qHourlyRH.Restore(Snap.HourlyRH))
+        return false;
+    m_forcing = Snap.Forcing;
+    lastUtcUpdateTime = Snap.LastUtcUpdateTime;
+    lastDailyUpdateTime = Snap.LastDailyUpdateTime;
+    MC1 = Snap.MC1;
+    MC10 = Snap.MC10;
+    MC100 = Snap.MC100;
+    MC1000 = Snap.MC1000;
+    MCWOOD = Snap.MCWOOD;
+    MCHERB = Snap.MCHERB;
+    FuelTemperature = Snap.FuelTemperature;
+    BI = Snap.BI;
+    ERC = Snap.ERC;
+    SC = Snap.SC;
+    IC = Snap.IC;
+    W1 = Snap.W1;
+    W10 = Snap.W10;
+    W100 = Snap.W100;
+    W1000 = Snap.W1000;
+    WWOOD = Snap.WWOOD;
+    WHERB = Snap.WHERB;
+    WDROUGHT = Snap.WDROUGHT;
+    W1P = Snap.W1P;
+    WHERBP = Snap.WHERBP;
+    WTOT = Snap.WTOT;
+    DroughtUnit = Snap.DroughtUnit;
+    fctCur = Snap.fctCur;
+    WTMCD = Snap.WTMCD;
+    WTMCL = Snap.WTMCL;
+    WTMCDE = Snap.WTMCDE;
+    WTMCLE = Snap.WTMCLE;
+    CummPrecip = Snap.CummPrecip;
+    m_GSI = Snap.GSI;
+    KBDI = Snap.KBDI;
+    YKBDI = Snap.YKBDI;
+    PrevYear = Snap.PrevYear;
+    YesterdayJDay = Snap.YesterdayJDay;
+    nConsectiveSnowDays = Snap.nConsectiveSnowDays;
+    m_regObsHour = Snap.RegObsHour;
+    m_pendingIndexes = Snap.PendingIndexes;
+    m_pendingWS = Snap.PendingWS;
+    m_pendingSlopeCls = Snap.PendingSlopeCls;
+    SnowCovered = Snap.SnowCovered;
+    // The model indexes held are those of this station's last update
+    m_modelsPending = !m_models.empty();
+    return true;
+}
+
 double NFDRS4::GetMinTemp()
 {
-    double minTemp = NORECORD;
-    for (std::deque<double>::iterator it = qHourlyTemp.begin(); it != qHourlyTemp.end(); ++it)
-    {
-        if ((*it) != NORECORD)
-        {
-            if (minTemp == NORECORD)
-                minTemp = *it;
-            else
-                minTemp = min(minTemp, *it);
-        }
-    }
-    return minTemp;
+    return qHourlyTemp.Min();
 }
 
 double NFDRS4::GetMaxTemp()
 {
-    double maxTemp = NORECORD;
-    for (std::deque<double>::iterator it = qHourlyTemp.begin(); it != qHourlyTemp.end(); ++it)
-    {
-        if ((*it) != NORECORD)
-        {
-            if (maxTemp == NORECORD)
-                maxTemp = *it;
-            else
-                maxTemp = max(maxTemp, *it);
-        }
-    }
-    return maxTemp;
+    return qHourlyTemp.Max();
 }
 double NFDRS4::GetMinRH()
 {
-    double minRH = NORECORD;
-    for (std::deque<double>::iterator it = qHourlyRH.begin(); it != qHourlyRH.end(); ++it)
-    {
-        if ((*it) != NORECORD)
-        {
-            if (minRH == NORECORD)
-                minRH = *it;
-            else
-                minRH = min(minRH, *it);
-        }
-    }
-    return minRH;
+    return qHourlyRH.Min();
 }
 double NFDRS4::GetPcp24()
 {
-    double pcp24 = 0.0;
-    for (std::deque<double>::iterator it = qHourlyPrecip.begin(); it != qHourlyPrecip.end(); ++it)
-    {
-        if (*it != NORECORD)
-            pcp24 += *it;
-    }
-    return pcp24;
+    return qHourlyPrecip.Sum();
 }
 
 void NFDRS4::AddCustomFuel(CFuelModelParams fmParams)
 {
-    mapFuels.emplace(fmParams.getFuelModel(), fmParams);
+    // Copied on write, as other stations may share the table
+    std::shared_ptr<std::unordered_map<char, CFuelModelParams> > fuels = std::make_shared<std::unordered_map<char, CFuelModelParams> >(*m_fuels);
+    fuels->emplace(fmParams.getFuelModel(), fmParams);
+    m_fuels = fuels;
     //iSetFuelModel(fmParams.getFuelModel());
 }
 
+const std::unordered_map<char, CFuelModelParams>& NFDRS4::GetFuelModelMap() const
+{
+    return *m_fuels;
+}
+
+bool NFDRS4::SetFuelModels(const std::string& Models, int MXD, int SCMax)
+{
+    for (size_t m = 0; m < Models.size(); m++)
+    {
+        if (m_fuels->find(Models[m]) == m_fuels->end())
+            return false;
+    }
+    m_models.assign(Models.size(), NFDRS4ModelIndexes());
+    for (size_t m = 0; m < Models.size(); m++)
+        m_models[m].FuelModel = Models[m];
+    m_modelMXD = MXD;
+    m_modelSCM = SCMax;
+    m_modelsPending = false;
+    return true;
+}
+
+int NFDRS4::GetNumFuelModels()
+{
+    return (int)m_models.size();
+}
+
+char NFDRS4::GetFuelModel(int Model)
+{
+    if (Model < 0 || Model >= (int)m_models.size())
+        return 0;
+    return m_models[Model].FuelModel;
+}
+
+// Fuel bed of model Model of SetFuelModels(), with the station's load
+// transfer and curing settings and the overrides of SetFuelModels()
+bool NFDRS4::GetModelFuelBed(int Model, NFDRS4FuelBed* Bed)
+{
+    if (Model < 0 || Model >= (int)m_models.size())
+        return false;
+    auto it = m_fuels->find(m_models[Model].FuelModel);
+    if (it == m_fuels->end())
+        return false;
+    CFuelModelParams fm = (*it).second;
+    *Bed = GetFuelBed();
+    Bed->SG1 = fm.getSG1();
+    Bed->SG10 = fm.getSG10();
+    Bed->SG100 = fm.getSG100();
+    Bed->SG1000 = fm.getSG1000();
+    Bed->SGWOOD = fm.getSGWood();
+    Bed->SGHERB = fm.getSGHerb();
+    Bed->HD = fm.getHD();
+    Bed->L1 = fm.getL1();
+    Bed->L10 = fm.getL10();
+    Bed->L100 = fm.getL100();
+    Bed->L1000 = fm.getL1000();
+    Bed->LWOOD = fm.getLWood();
+    Bed->LHERB = fm.getLHerb();
+    Bed->DEPTH = fm.getDepth();
+    Bed->MXD = (m_modelMXD > 0) ? m_modelMXD : fm.getMXD();
+    Bed->SCM = (m_modelSCM > 0) ? m_modelSCM : fm.getSCM();
+    Bed->LDROUGHT = fm.getLDrought();
+    Bed->WNDFC = fm.getWNDFC();
+    return true;
+}
+
+// Calculates the indexes of the SetFuelModels() models from the station's
+// current fuel moistures, KBDI and GSI, as iCalcIndexes() does for its own
+void NFDRS4::CalcModelIndexes(int iWS, int iSlopeCls)
+{
+    m_modelsPending = false;
+    if ((iSlopeCls < 1) || (iWS < 0) || (iSlopeCls > 5))
+        return;
+
+    double tmpKBDI = KBDI;
+    double ws = iWS;
+    NFDRS4IndexInputs in;
+    in.MC1 = &MC1;
+    in.MC10 = &MC10;
+    in.MC100 = &MC100;
+    in.MC1000 = &MC1000;
+    in.MCHERB = &MCHERB;
+    in.MCWOOD = &MCWOOD;
+    in.FuelTemperature = &FuelTemperature;
+    in.WS = &ws;
+    in.KBDI = &tmpKBDI;
+    in.GSI = &m_GSI;
+    for (int m = 0; m < (int)m_models.size(); m++)
+    {
+        NFDRS4ModelIndexes& model = m_models[m];
+        NFDRS4FuelBed bed;
+        if (!GetModelFuelBed(m, &bed))
+            continue;
+        if (!model.Fuel || !model.Fuel->Matches(bed, iSlopeCls))
+            model.Fuel = NFDRS4CompiledFuel::Get(bed, iSlopeCls);
+        double fSC, fERC, fBI, fIC;
+        NFDRS4IndexOutputs out;
+        out.SC = &fSC;
+        out.ERC = &fERC;
+        out.BI = &fBI;
+        out.IC = &fIC;
+        if (NFDRS4CalcIndexes(*model.Fuel, 1, in, out, false, &model.Cache))
+        {
+            model.SC = fSC;
+            model.ERC = fERC;
+            model.BI = fBI;
+            model.IC = fIC;
+        }
+    }
+}
+
+bool NFDRS4::GetModelIndexes(int Model, double* fSC, double* fERC, double* fBI, double* fIC)
+{
+    if (Model < 0 || Model >= (int)m_models.size())
+        return false;
+    if (m_modelsPending)
+        CalcModelIndexes(m_pendingWS, m_pendingSlopeCls);
+    const NFDRS4ModelIndexes& model = m_models[Model];
+    if (fSC) *fSC = model.SC;
+    if (fERC) *fERC = model.ERC;
+    if (fBI) *fBI = model.BI;
+    if (fIC) *fIC = model.IC;
+    return true;
+}
+
@@ -57,6 +57,7 @@ NFDRS4State::NFDRS4State(const NFDRS4State& rhs)
 
 NFDRS4State::NFDRS4State(NFDRS4 *pNFDRS)
 {
+	pNFDRS->CalcPendingIndexes();	// the indexes of the state are those of the last update
 	m_AvgPrecip = pNFDRS->AvgPrecip;
 	m_BI = pNFDRS->BI;
 	m_CummPrecip = pNFDRS->CummPrecip;
@@ -87,25 +88,17 @@ NFDRS4State::NFDRS4State(NFDRS4 *pNFDRS)
 	m_YesterdayJDay = pNFDRS->YesterdayJDay;
 	m_YKBDI = pNFDRS->YKBDI;
 	float tVal;
-	std::deque<double> qCopy = pNFDRS->qPrecip;
-	while(qCopy.size() > 0)
+	for (int i = 0; i < pNFDRS->qPrecip.Size(); i++)
 	{
-		tVal = (float)qCopy.front();
+		tVal = (float)pNFDRS->qPrecip[i];
 		m_qPrecip.push_back(tVal);
-		qCopy.pop_front();
 	}
-	//hourly deques are always 24 entries
-	std::deque<double> qTempCopy = pNFDRS->qHourlyTemp;
-	std::deque<double> qRHcopy = pNFDRS->qHourlyRH;
-	std::deque<double> qPcpCopy = pNFDRS->qHourlyPrecip;
+	//hourly windows are always 24 entries
 	for (int h = 0; h < pNFDRS->nHoursPerDay; h++)
 	{
-		m_qHourlyTemp.push_back((float)qTempCopy.front());
-		m_qHourlyRH.push_back((float)qRHcopy.front());
-		m_qHourlyPrecip.push_back((float)qPcpCopy.front());
-		qTempCopy.pop_front();
-		qRHcopy.pop_front();
-		qPcpCopy.pop_front();
+		m_qHourlyTemp.push_back((float)pNFDRS->qHourlyTemp[h]);
+		m_qHourlyRH.push_back((float)pNFDRS->qHourlyRH[h]);
+		m_qHourlyPrecip.push_back((float)pNFDRS->qHourlyPrecip[h]);
 	}
 	m_KBDIThreshold = pNFDRS->KBDIThreshold;
 	fm1State = pNFDRS->OneHourFM.GetState();
@@ -435,6 +428,22 @@ bool NFDRS4State::LoadState(std::string fileName)
 		return false;
 	}
 	m_lastDailyUpdateTime = utctime::UTCTime(utcYear + 1900, utcMonth + 1, utcDay, utcHour, 0, 0);
+	//dead fuel random streams follow; files saved before they were added end here.
+	//all four streams or none: a file that ends within them, or has anything after them, is rejected
+	int next = fgetc(in);
+	if (next != EOF)
+	{
+		ungetc(next, in);
+		if (!fm1State.ReadRandomState(in) || !fm10State.ReadRandomState(in)
+			|| !fm100State.ReadRandomState(in) || !fm1000State.ReadRandomState(in)
+			|| fgetc(in) != EOF)
+		{
+			fm1State.m_hasRandomState = fm10State.m_hasRandomState = false;
+			fm100State.m_hasRandomState = fm1000State.m_hasRandomState = false;
+			fclose(in);
+			return false;
+		}
+	}
 
 
 	fclose(in);
@@ -760,6 +769,13 @@ bool NFDRS4State::SaveState(std::string fileName)
 		fclose(out);
 		return false;
 	}
+	//dead fuel random streams, last so older readers ignore them
+	if (!fm1State.SaveRandomState(out) || !fm10State.SaveRandomState(out)
+		|| !fm100State.SaveRandomState(out) || !fm1000State.SaveRandomState(out))
+	{
+		fclose(out);
+		return false;
+	}
 	fclose(out);
 	return true;
 }
@@ -0,0 +1,310 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4ensemble.cpp
+    \brief NFDRS4Ensemble class definition and implementation.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <algorithm>
+#include <cmath>
+
+// Custom include files
+#include "nfdrs4ensemble.h"
+
+NFDRS4Ensemble::NFDRS4Ensemble()
+    : m_batchSticks(false), m_simdIndexes(false), m_batchStale(false)
+{
+    for (int c = 0; c < 4; c++)
+        m_batched[c] = false;
+}
+
+NFDRS4Ensemble::~NFDRS4Ensemble()
+{
+}
+
+bool NFDRS4Ensemble::SetPercentiles(const std::vector<double>& Percentiles)
+{
+    for (size_t p = 0; p < Percentiles.size(); p++)
+    {
+        if (!(Percentiles[p] >= 0.0 && Percentiles[p] <= 100.0))
+            return false;
+    }
+    m_percentiles = Percentiles;
+    return true;
+}
+
+const std::vector<double>& NFDRS4Ensemble::GetPercentiles() const
+{
+    return m_percentiles;
+}
+
+int NFDRS4Ensemble::GetNumStats() const
+{
+    return 3 + (int)m_percentiles.size();
+}
+
+void NFDRS4Ensemble::SetBatchSticks(bool Batch)
+{
+    m_batchSticks = Batch;
+}
+
+bool NFDRS4Ensemble::GetBatchSticks() const
+{
+    return m_batchSticks;
+}
+
+void NFDRS4Ensemble::SetSimdIndexes(bool Simd)
+{
+    m_simdIndexes = Simd;
+}
+
+bool NFDRS4Ensemble::GetSimdIndexes() const
+{
+    return m_simdIndexes;
+}
+
+bool NFDRS4Ensemble::Start(const NFDRS4& Station, int nMembers)
+{
+    m_members.clear();
+    m_batchStale = false;
+    if (nMembers < 1)
+        return false;
+    m_members.reserve(nMembers);
+    for (int m = 0; m < nMembers; m++)
+        m_members.emplace_back(Station);
+    m_in.resize(nMembers);
+    std::vector<double>* lanes[] = { &m_at, &m_rh, &m_sw, &m_ppt, &m_mc1, &m_mc10, &m_mc100, &m_mc1000,
+        &m_mcherb, &m_mcwood, &m_fuelTemp, &m_ws, &m_kbdi, &m_gsi, &m_sc, &m_erc, &m_bi, &m_ic };
+    for (size_t a = 0; a < sizeof(lanes) / sizeof(lanes[0]); a++)
+        lanes[a]->assign(nMembers, 0.0);
+    m_sorted.reserve(nMembers);
+
+    // Indexes of the starting state, kept by members whose first indexes are skipped
+    for (int m = 0; m < nMembers; m++)
+    {
+        NFDRS4& calc = m_members[m];
+        m_sc[m] = calc.GetSC();
+        m_erc[m] = calc.GetERC();
+        m_bi[m] = calc.GetBI();
+        m_ic[m] = calc.GetIC();
+        calc.SetLazyIndexes(true);
+    }
+    NFDRS4& first = m_members[0];
+    m_fuel = NFDRS4CompiledFuel::Get(first.GetFuelBed(), first.SlopeClass);
+    m_cache = NFDRS4IndexBedCache();
+
+    // Sticks updated less than hourly or on a shared forcing run member by member
+    const int intervals[4] = { 1, 1, first.Get100HourUpdateInterval(), first.Get1000HourUpdateInterval() };
+    for (int c = 0; c < 4; c++)
+        m_batched[c] = m_batchSticks && !first.GetSharedForcing() && intervals[c] <= 1 && LoadBatch(c);
+    return true;
+}
+
+bool NFDRS4Ensemble::Step(const NFDRS4Observation* Obs, double* Stats)
+{
+    const int n = (int)m_members.size();
+    if (n == 0)
+        return false;
+    const NFDRS4Observation& o = Obs[0];
+    for (int m = 1; m < n; m++)
+    {
+        if (Obs[m].Year != o.Year || Obs[m].Month != o.Month || Obs[m].Day != o.Day || Obs[m].Hour != o.Hour)
+            return false;
+    }
+    const int Julian = CalcJulianDay(o.Year, o.Month - 1, o.Day);
+
+    // Members share their dates, so a gap reinitializes all of them
+    bool reinit = false;
+    for (int m = 0; m < n; m++)
+    {
+        NFDRS4& calc = m_members[m];
+        const NFDRS4Observation& om = Obs[m];
+        int prevJDay = calc.YesterdayJDay;
+        calc.StartUpdate(om.Year, Julian, om.SnowDay);
+        if (calc.YesterdayJDay != prevJDay)
+            reinit = true;
+        m_in[m] = calc.DeadFuelInput(om.Year, om.Month, om.Day, om.Hour, om.Temp, om.RH, om.PPTAmt, om.SolarRad, om.SnowDay);
+        m_at[m] = m_in[m].Temp;
+        m_rh[m] = m_in[m].RH;
+        m_sw[m] = m_in[m].SolarRad;
+        m_ppt[m] = m_in[m].PPTAmt;
+        if (calc.GetSharedForcing())
+            calc.AdvanceSharedForcing(m_in[m].Temp, m_in[m].RH);
+    }
+    for (int c = 0; c < 4 && reinit; c++)
+    {
+        if (m_batched[c])
+            LoadBatch(c);
+    }
+
+    // Dead fuel sticks, each size class of all members at once where it can be
+    std::vector<double>* mc[4] = { &m_mc1, &m_mc10, &m_mc100, &m_mc1000 };
+    for (int c = 0; c < 4; c++)
+    {
+        std::vector<double>& out = *mc[c];
+        if (m_batched[c])
+        {
+            m_batch[c].update(o.Year, o.Month, o.Day, o.Hour, 0, 0, m_at.data(), m_rh.data(), m_sw.data(), m_ppt.data(), 0.02179999999, true);
+            for (int m = 0; m < n; m++)
+                out[m] = m_batch[c].medianRadialMoisture(m) * 100;
+            m_batchStale = true;
+        }
+        else
+        {
+            for (int m = 0; m < n; m++)
+                out[m] = m_members[m].UpdateDeadFuel(c, m_in[m]);
+        }
+    }
+
+    // Rest of each member's update, with its indexes left to the batch below
+    for (int m = 0; m < n; m++)
+    {
+        NFDRS4& calc = m_members[m];
+        const NFDRS4Observation& om = Obs[m];
+        calc.MC1 = m_mc1[m];
+        calc.MC10 = m_mc10[m];
+        calc.MC100 = m_mc100[m];
+        calc.MC1000 = m_mc1000[m];
+        calc.FuelTemperature = m_batched[0] ? m_batch[0].surfaceTemperature(m) : calc.OneHourFM.surfaceTemperature();
+        calc.FinishUpdate(om.Year, om.Month, om.Day, om.Hour, Julian, om.Temp, om.RH, om.PPTAmt, om.WS, om.SnowDay);
+        m_mc1[m] = calc.MC1;
+        m_mc10[m] = calc.MC10;
+        m_mc100[m] = calc.MC100;
+        m_mc1000[m] = calc.MC1000;
+        m_mcherb[m] = calc.MCHERB;
+        m_mcwood[m] = calc.MCWOOD;
+        m_fuelTemp[m] = calc.FuelTemperature;
+        m_ws[m] = (int)om.WS;
+        m_kbdi[m] = calc.KBDI;
+        m_gsi[m] = calc.m_GSI;
+    }
+
+    // Members with skipped indexes keep their previous ones, as NFDRS4::iCalcIndexes() does
+    NFDRS4IndexInputs in;
+    in.MC1 = m_mc1.data();
+    in.MC10 = m_mc10.data();
+    in.MC100 = m_mc100.data();
+    in.MC1000 = m_mc1000.data();
+    in.MCHERB = m_mcherb.data();
+    in.MCWOOD = m_mcwood.data();
+    in.FuelTemperature = m_fuelTemp.data();
+    in.WS = m_ws.data();
+    in.KBDI = m_kbdi.data();
+    in.GSI = m_gsi.data();
+    NFDRS4IndexOutputs out;
+    out.SC = m_sc.data();
+    out.ERC = m_erc.data();
+    out.BI = m_bi.data();
+    out.IC = m_ic.data();
+    NFDRS4CalcIndexes(*m_fuel, n, in, out, m_simdIndexes, &m_cache);
+
+    const int nStats = GetNumStats();
+    const std::vector<double>* values[EnsembleVariables] = { &m_mc1, &m_erc, &m_bi, &m_sc, &m_ic };
+    for (int v = 0; v < EnsembleVariables; v++)
+        Reduce(values[v]->data(), Stats + v * nStats);
+    return true;
+}
+
+int NFDRS4Ensemble::Run(const NFDRS4& Station, int nMembers, int nObs, const NFDRS4Observation* Obs, double* Stats)
+{
+    if (!Start(Station, nMembers))
+        return 0;
+    const int nStats = GetNumStats();
+    std::vector<NFDRS4Observation> hour(nMembers);
+    for (int i = 0; i < nObs; i++)
+    {
+        for (int m = 0; m < nMembers; m++)
+            hour[m] = Obs[(size_t)m * nObs + i];
+        if (!Step(hour.data(), Stats + (size_t)i * EnsembleVariables * nStats))
+            return i;
+    }
+    return nObs > 0 ? nObs : 0;
+}
+
+int NFDRS4Ensemble::GetNumMembers() const
+{
+    return (int)m_members.size();
+}
+
+NFDRS4& NFDRS4Ensemble::Member(int Index)
+{
+    // Brings the batched sticks of every member up to date
+    for (int c = 0; c < 4 && m_batchStale; c++)
+    {
+        for (int m = 0; m < (int)m_members.size() && m_batched[c]; m++)
+            m_batch[c].getStick(m, Stick(m, c));
+    }
+    m_batchStale = false;
+    return m_members[Index];
+}
+
+DeadFuelMoisture& NFDRS4Ensemble::Stick(int Member, int Class)
+{
+    NFDRS4& calc = m_members[Member];
+    switch (Class)
+    {
+    case 0:
+        return calc.OneHourFM;
+    case 1:
+        return calc.TenHourFM;
+    case 2:
+        return calc.HundredHourFM;
+    default:
+        return calc.ThousandHourFM;
+    }
+}
+
+// Loads the sticks of size class Class of every member into its batch; false
+// if the batch does not take them
+bool NFDRS4Ensemble::LoadBatch(int Class)
+{
+    const int n = (int)m_members.size();
+    m_batch[Class].initialize(Stick(0, Class), n);
+    for (int m = 0; m < n; m++)
+    {
+        if (!m_batch[Class].setStick(m, Stick(m, Class)))
+            return false;
+    }
+    return true;
+}
+
+// Mean, minimum, maximum and percentiles of one value per member
+void NFDRS4Ensemble::Reduce(const double* Values, double* Stats)
+{
+    const int n = (int)m_members.size();
+    double sum = 0.0, lo = Values[0], hi = Values[0];
+    for (int m = 0; m < n; m++)
+    {
+        sum += Values[m];
+        lo = std::min(lo, Values[m]);
+        hi = std::max(hi, Values[m]);
+    }
+    Stats[0] = sum / n;
+    Stats[1] = lo;
+    Stats[2] = hi;
+    if (m_percentiles.empty())
+        return;
+    m_sorted.assign(Values, Values + n);
+    std::sort(m_sorted.begin(), m_sorted.end());
+    for (size_t p = 0; p < m_percentiles.size(); p++)
+    {
+        double rank = m_percentiles[p] / 100.0 * (n - 1);
+        int below = (int)floor(rank);
+        int above = std::min(below + 1, n - 1);
+        Stats[3 + p] = m_sorted[below] + (rank - below) * (m_sorted[above] - m_sorted[below]);
+    }
+}
+
+//------------------------------------------------------------------------------
+//  End of nfdrs4ensemble.cpp
+//------------------------------------------------------------------------------
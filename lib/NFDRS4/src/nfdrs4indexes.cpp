@@ -0,0 +1,577 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4indexes.cpp
+    \brief Stateless NFDRS4 index calculations for batches of records.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+// Custom include files
+#include "nfdrs4indexes.h"
+#include "dfmsimd.h"
+
+NFDRS4FuelLoads NFDRS4CalcFuelLoads(const NFDRS4FuelBed& Bed, double KBDI, double GSI)
+{
+    NFDRS4FuelLoads w;
+    w.W1 = Bed.L1 * Bed.CTA;
+    w.W10 = Bed.L10 * Bed.CTA;
+    w.W100 = Bed.L100 * Bed.CTA;
+    w.W1000 = Bed.L1000 * Bed.CTA;
+    w.WHERB = Bed.LHERB * Bed.CTA;
+    w.WWOOD = Bed.LWOOD * Bed.CTA;
+    w.WDROUGHT = Bed.LDROUGHT * Bed.CTA;
+    w.DEPTH = Bed.DEPTH;
+    w.DroughtUnit = 0;
+    w.Drought = KBDI > Bed.KBDIThreshold;
+
+    // Drought load transfer, into the dead classes in proportion to their loads
+    if (w.Drought)
+    {
+        double WTOTD = w.W1 + w.W10 + w.W100;
+        double WTOTL = w.WHERB + w.WWOOD;
+        double WTOT = WTOTD + WTOTL;
+        double PackingRatio = WTOT / w.DEPTH;
+        if (PackingRatio == 0) PackingRatio = 1.0;
+        WTOTD = WTOTD + w.W1000;
+        w.DroughtUnit = w.WDROUGHT / (800.0 - Bed.KBDIThreshold);
+
+        w.W1 = w.W1 + (w.W1 / WTOTD) * (KBDI - Bed.KBDIThreshold) * w.DroughtUnit;
+        w.W10 = w.W10 + (w.W10 / WTOTD) * (KBDI - Bed.KBDIThreshold) * w.DroughtUnit;
+        w.W100 = w.W100 + (w.W100 / WTOTD) * (KBDI - Bed.KBDIThreshold) * w.DroughtUnit;
+        w.W1000 = w.W1000 + (w.W1000 / WTOTD) * (KBDI - Bed.KBDIThreshold) * w.DroughtUnit;
+        WTOT = w.W1 + w.W10 + w.W100 + w.W1000 + WTOTL;
+        w.DEPTH = (WTOT - w.W1000) / PackingRatio;
+    }
+
+    // Herbaceous load transfer, as in NFDRS4::Cure()
+    (GSI < Bed.GreenupThreshold) ? w.fctCur = 1 : w.fctCur = -1.0 / (1.0 - Bed.GreenupThreshold) * (GSI / Bed.MaxGSI) + 1.0 / (1.0 - Bed.GreenupThreshold);
+    if (w.fctCur < 0) w.fctCur = 0.0;
+    if (w.fctCur > 1) w.fctCur = 1.0;
+    w.W1P = w.W1 + w.WHERB * w.fctCur;
+    w.WHERBP = w.WHERB * (1 - w.fctCur);
+
+    w.WTOTD = w.W1P + w.W10 + w.W100 + w.W1000;
+    w.WTOTL = w.WHERBP + w.WWOOD;
+    w.WTOT = w.WTOTD + w.WTOTL;
+    return w;
+}
+
+static std::atomic<unsigned long> NextCompiledFuelId(1);
+
+// Slope classes 1-5, as in WIMS
+static const double SlopeFactor[5] = { 0.267, 0.533, 1.068, 2.134, 4.273 };
+
+NFDRS4CompiledFuel::NFDRS4CompiledFuel(const NFDRS4FuelBed& Bed, int SlopeClass)
+    : m_bed(Bed), m_slopeClass(SlopeClass), m_id(NextCompiledFuelId++)
+{
+    m_valid = (SlopeClass >= 1) && (SlopeClass <= 5) && (Bed.DEPTH > 0);
+    m_slopeFactor = m_valid ? SlopeFactor[SlopeClass - 1] : 0;
+    m_x1 = exp(-138.0 / (double)(Bed.SG1));
+    m_x10 = exp(-138.0 / (double)(Bed.SG10));
+    m_x100 = exp(-138.0 / (double)(Bed.SG100));
+    m_xherb = exp(-138.0 / (double)(Bed.SGHERB));
+    m_xwood = exp(-138.0 / (double)(Bed.SGWOOD));
+    if ((Bed.SGHERB == 0) || ((-500 / Bed.SGHERB) < -180.218))
+        m_hnherb = 0;
+    else
+        m_hnherb = exp(-500.0 / Bed.SGHERB);
+    if ((Bed.SGWOOD == 0) || ((-500 / Bed.SGWOOD) < -180.218))
+        m_hnwood = 0;
+    else
+        m_hnwood = exp(-500.0 / Bed.SGWOOD);
+    m_liveTotal = Bed.SGWOOD > 1200 && Bed.SGHERB > 1200;
+}
+
+// Returns the compiled fuel of Bed and SlopeClass shared by all callers,
+// compiling it if no caller holds it any more
+std::shared_ptr<const NFDRS4CompiledFuel> NFDRS4CompiledFuel::Get(const NFDRS4FuelBed& Bed, int SlopeClass)
+{
+    static std::mutex lock;
+    static std::vector<std::weak_ptr<const NFDRS4CompiledFuel> > fuels;
+
+    std::lock_guard<std::mutex> guard(lock);
+    for (size_t f = 0; f < fuels.size();)
+    {
+        std::shared_ptr<const NFDRS4CompiledFuel> fuel = fuels[f].lock();
+        if (!fuel)
+        {
+            fuels[f] = fuels.back();
+            fuels.pop_back();
+            continue;
+        }
+        if (fuel->Matches(Bed, SlopeClass))
+            return fuel;
+        f++;
+    }
+    std::shared_ptr<const NFDRS4CompiledFuel> fuel = std::make_shared<const NFDRS4CompiledFuel>(Bed, SlopeClass);
+    fuels.push_back(fuel);
+    return fuel;
+}
+
+bool NFDRS4CompiledFuel::Matches(const NFDRS4FuelBed& Bed, int SlopeClass) const
+{
+    return SlopeClass == m_slopeClass
+        && Bed.SG1 == m_bed.SG1 && Bed.SG10 == m_bed.SG10 && Bed.SG100 == m_bed.SG100
+        && Bed.SG1000 == m_bed.SG1000 && Bed.SGHERB == m_bed.SGHERB && Bed.SGWOOD == m_bed.SGWOOD
+        && Bed.L1 == m_bed.L1 && Bed.L10 == m_bed.L10 && Bed.L100 == m_bed.L100
+        && Bed.L1000 == m_bed.L1000 && Bed.LHERB == m_bed.LHERB && Bed.LWOOD == m_bed.LWOOD
+        && Bed.LDROUGHT == m_bed.LDROUGHT && Bed.DEPTH == m_bed.DEPTH && Bed.MXD == m_bed.MXD
+        && Bed.HD == m_bed.HD && Bed.SCM == m_bed.SCM && Bed.WNDFC == m_bed.WNDFC
+        && Bed.CTA == m_bed.CTA && Bed.KBDIThreshold == m_bed.KBDIThreshold
+        && Bed.GreenupThreshold == m_bed.GreenupThreshold && Bed.MaxGSI == m_bed.MaxGSI;
+}
+
+bool NFDRS4CompiledFuel::IsValid() const
+{
+    return m_valid;
+}
+
+const NFDRS4FuelBed& NFDRS4CompiledFuel::GetBed() const
+{
+    return m_bed;
+}
+
+int NFDRS4CompiledFuel::GetSlopeClass() const
+{
+    return m_slopeClass;
+}
+
+unsigned long NFDRS4CompiledFuel::GetId() const
+{
+    return m_id;
+}
+
+// Derives the quantities of the fuel bed at the transferred loads w that do
+// not depend on the fuel moistures, wind or fuel temperature; false if the
+// bed has no dead fuel
+bool NFDRS4CompiledFuel::CalcBed(const NFDRS4FuelLoads& w, DFMSimdIndexBed* b) const
+{
+    const NFDRS4FuelBed& Bed = m_bed;
+    const double STD = .0555, STL = .0555;
+    const double RHOD = 32, RHOL = 32;
+    const double ETASD = 0.4173969, ETASL = 0.4173969;
+
+    double W1N = w.W1P * (1.0 - STD);						// Net 1hr Fuel Loading
+    double W10N = w.W10 * (1.0 - STD);						// Net 10hr Fuel Loading
+    double W100N = w.W100 * (1.0 - STD);					// Net 100hr Fuel Loading
+    double WHERBN = w.WHERBP * (1.0 - STL);				// Net Herbaceous Fuel Loading
+    double WWOODN = w.WWOOD * (1.0 - STL);					// Net Woody Fuel Loading
+    double WTOTLN = w.WTOTL * (1.0 - STL);					// Net Total Live Fuel Lodaing
+    double RHOBED = (w.WTOT - w.W1000) / w.DEPTH;			// Bulk density of the fuel bed
+    double RHOBAR = ((w.WTOTL * RHOL) + (w.WTOTD * RHOD)) / w.WTOT;	// Weighted particle density of the fuel bed
+    double BETBAR = RHOBED / RHOBAR;						// Ratio of bulk density to particle density
+
+    // Heating number loadings of the live fuel moisture of extinction
+    b->live = WTOTLN > 0;
+    b->hn1 = b->hn10 = b->hn100 = b->hnSum = b->wrat = 0;
+    if (b->live)
+    {
+        double HNHERB, HNWOOD, WRAT;
+        double HN1 = W1N * m_x1;
+        double HN10 = W10N * m_x10;
+        double HN100 = W100N * m_x100;
+        HNHERB = WHERBN * m_hnherb;
+        HNWOOD = WWOODN * m_hnwood;
+        if ((HNHERB + HNWOOD) == 0)
+            WRAT = 0;
+        else
+            WRAT = (HN1 + HN10 + HN100) / (HNHERB + HNWOOD);
+        b->hn1 = HN1;
+        b->hn10 = HN10;
+        b->hn100 = HN100;
+        b->hnSum = HN1 + HN10 + HN100;
+        b->wrat = 2.9 * WRAT;
+    }
+    b->mxd = Bed.MXD;
+
+    double SA1 = (w.W1P / RHOD) * Bed.SG1;			// Surface area of dead 1hr fuel
+    double SA10 = (w.W10 / RHOD) * Bed.SG10;		// Surface area of dead 10hr fuel
+    double SA100 = (w.W100 / RHOD) * Bed.SG100;		// Surface area of dead 100hr fuel
+    double SAHERB = (w.WHERBP / RHOL) * Bed.SGHERB;	// Surface area of live herbaceous fuel
+    double SAWOOD = (w.WWOOD / RHOL) * Bed.SGWOOD;	// Surface area of live woody fuel
+    double SADEAD = SA1 + SA10 + SA100;				// Surface area of dead fuel
+    double SALIVE = SAHERB + SAWOOD;				// Surface area of live fuel
+    if (SADEAD <= 0)
+        return false;
+
+    double F1 = SA1 / SADEAD;
+    double F10 = SA10 / SADEAD;
+    double F100 = SA100 / SADEAD;
+    double FHERB = 0, FWOOD = 0;
+    if (w.WTOTL > 0)
+    {
+        FHERB = SAHERB / SALIVE;
+        FWOOD = SAWOOD / SALIVE;
+    }
+    double FDEAD = SADEAD / (SADEAD + SALIVE);
+    double FLIVE = SALIVE / (SADEAD + SALIVE);
+    double WDEADN = (F1 * W1N) + (F10 * W10N) + (F100 * W100N);
+    double WLIVEN;
+    if (m_liveTotal)
+        WLIVEN = WTOTLN;
+    else
+        WLIVEN = (FWOOD * WWOODN) + (FHERB * WHERBN);
+
+    // Characteristic surface area-to-volume ratios, surface area weighted
+    double SGBRD = (F1 * Bed.SG1) + (F10 * Bed.SG10) + (F100 * Bed.SG100);
+    double SGBRL = (FHERB * Bed.SGHERB) + (FWOOD * Bed.SGWOOD);
+    double SGBRT = (FDEAD * SGBRD) + (FLIVE * SGBRL);
+
+    double BETOP = 3.348 * pow(SGBRT, -0.8189);
+    double GMAMX = pow(SGBRT, 1.5) / (495.0 + 0.0594 * pow(SGBRT, 1.5));
+    double AD = 133 * pow(SGBRT, -0.7913);
+    double GMAOP = GMAMX * pow((BETBAR / BETOP), AD) * exp(AD * (1.0 - (BETBAR / BETOP)));
+    double ZETA = exp((0.792 + 0.681 * pow(SGBRT, 0.5)) * (BETBAR + 0.1));
+    ZETA = ZETA / (192.0 + 0.2595 * SGBRT);
+    double B = 0.02526 * pow(SGBRT, 0.54);
+    double C = 7.47 * exp(-0.133 * pow(SGBRT, 0.55));
+    double E = 0.715 * exp(-3.59 * pow(10.0, -4.0) * SGBRT);
+    double UFACT = C * pow(BETBAR / BETOP, -1 * E);
+
+    double SLPBAR = pow(BETBAR, -0.3);
+    double PHISLP = m_slopeFactor * SLPBAR;
+
+    b->f1 = F1;
+    b->f10 = F10;
+    b->f100 = F100;
+    b->fherb = FHERB;
+    b->fwood = FWOOD;
+    b->xf1 = F1 * m_x1;
+    b->xf10 = F10 * m_x10;
+    b->xf100 = F100 * m_x100;
+    b->xfherb = FHERB * m_xherb;
+    b->xfwood = FWOOD * m_xwood;
+    b->rhobed = RHOBED;
+    b->fdead = FDEAD;
+    b->flive = FLIVE;
+    b->gmaop = GMAOP;
+    b->ird = WDEADN * Bed.HD * ETASD;
+    b->irl = WLIVEN * Bed.HD * ETASL;
+    b->ufact = UFACT;
+    b->b = B;
+    b->wndfc = Bed.WNDFC;
+    b->slope1 = 1.0 + PHISLP;
+    b->slopebar = SLPBAR;
+    b->zeta = ZETA;
+
+    // Loading weighted quantities of the energy release component
+    b->f1e = w.W1P / w.WTOTD;
+    b->f10e = w.W10 / w.WTOTD;
+    b->f100e = w.W100 / w.WTOTD;
+    b->f1000e = w.W1000 / w.WTOTD;
+    b->fherbe = 0;
+    b->fwoode = 0;
+    if (w.WTOTL > 0)
+    {
+        b->fherbe = w.WHERBP / w.WTOTL;
+        b->fwoode = w.WWOOD / w.WTOTL;
+    }
+    double FDEADE = w.WTOTD / w.WTOT;
+    double FLIVEE = w.WTOTL / w.WTOT;
+    double WDEDNE = w.WTOTD * (1.0 - STD);
+    double WLIVNE = w.WTOTL * (1.0 - STL);
+    double SGBRDE = (b->f1e * Bed.SG1) + (b->f10e * Bed.SG10) + (b->f100e * Bed.SG100) + (b->f1000e * Bed.SG1000);
+    double SGBRLE = (b->fherbe * Bed.SGHERB) + (b->fwoode * Bed.SGWOOD);
+    double SGBRTE = (FDEADE * SGBRDE) + (FLIVEE * SGBRLE);
+    double BETOPE = 3.348 * pow(SGBRTE, -0.8189);
+    double GMAMXE = pow(SGBRTE, 1.5) / (495.0 + 0.0594 * pow(SGBRTE, 1.5));
+    double ADE = 133 * pow(SGBRTE, -0.7913);
+    b->gmaope = GMAMXE * pow((BETBAR / BETOPE), ADE) * exp(ADE * (1.0 - (BETBAR / BETOPE)));
+    b->ired = FDEADE * WDEDNE * Bed.HD * ETASD;
+    b->irel = FLIVEE * WLIVNE * (double)(Bed.HD) * ETASL;
+    b->tau = 384.0 / SGBRT;
+    b->scm = Bed.SCM;
+    return true;
+}
+
+// Quantities of one record that depend on neither its wind speed nor its
+// slope class.  Those of the spread component are only set if Spread, and
+// PI only if Ignition.
+struct IndexTerms
+{
+    double IRZ;         // Reaction intensity times the propagating flux ratio
+    double IR;          // Reaction intensity
+    double HTSINK;      // Heat sink
+    double ERC;
+    double PI;          // Probability of ignition (%), negative if it does not apply
+    double WTMCD, WTMCL, WTMCDE, WTMCLE;
+};
+
+static void CalcIndexTerms(const DFMSimdIndexBed& b, const double* in, IndexTerms* t, bool Spread = true, bool Ignition = true)
+{
+    const double MC1 = in[DFM_IndexMC1], MC10 = in[DFM_IndexMC10], MC100 = in[DFM_IndexMC100];
+    const double MC1000 = in[DFM_IndexMC1000], MCHERB = in[DFM_IndexMCHERB], MCWOOD = in[DFM_IndexMCWOOD];
+
+    double MXL = 0;
+    if (b.live)
+    {
+        double MCLFE = ((MC1 * b.hn1) + (MC10 * b.hn10) + (MC100 * b.hn100)) / b.hnSum;
+        MXL = (b.wrat * (1.0 - MCLFE / b.mxd) - 0.226) * 100;
+    }
+    if (MXL < b.mxd) MXL = b.mxd;
+
+    double WTMCD = (b.f1 * MC1) + (b.f10 * MC10) + (b.f100 * MC100);
+    double WTMCL = (b.fherb * MCHERB) + (b.fwood * MCWOOD);
+    if (Spread)
+    {
+        double DEDRT = WTMCD / b.mxd;
+        double LIVRT = WTMCL / MXL;
+        double ETAMD = 1.0 - 2.59 * DEDRT + 5.11 * pow(DEDRT, 2.0) - 3.52 * pow(DEDRT, 3.0);
+        double ETAML = 1.0 - 2.59 * LIVRT + 5.11 * pow(LIVRT, 2.0) - 3.52 * pow(LIVRT, 3.0);
+        if (ETAMD < 0) ETAMD = 0;
+        if (ETAMD > 1) ETAMD = 1;
+        if (ETAML < 0) ETAML = 0;
+        if (ETAML > 1) ETAML = 1;
+
+        /* HL = HD */
+        double IR = b.gmaop * ((b.ird * ETAMD) + (b.irl * ETAML));
+
+        double XF1 = b.xf1 * (250.0 + 11.16 * MC1);
+        double XF10 = b.xf10 * (250.0 + 11.16 * MC10);
+        double XF100 = b.xf100 * (250.0 + 11.16 * MC100);
+        double XFHERB = b.xfherb * (250.0 + 11.16 * MCHERB);
+        double XFWOOD = b.xfwood * (250.0 + 11.16 * MCWOOD);
+        t->IRZ = IR * b.zeta;
+        t->IR = IR;
+        t->HTSINK = b.rhobed * (b.fdead * (XF1 + XF10 + XF100) + b.flive * (XFHERB + XFWOOD));
+    }
+
+    double WTMCDE = (b.f1e * MC1) + (b.f10e * MC10) + (b.f100e * MC100) + (b.f1000e * MC1000);
+    double WTMCLE = (b.fherbe * MCHERB) + (b.fwoode * MCWOOD);
+    double DEDRTE = WTMCDE / b.mxd;
+    double LIVRTE = WTMCLE / MXL;
+    double ETAMDE = 1.0 - 2.0 * DEDRTE + 1.5 * pow(DEDRTE, 2.0) - 0.5 * pow(DEDRTE, 3.0);
+    double ETAMLE = 1.0 - 2.0 * LIVRTE + 1.5 * pow(LIVRTE, 2.0) - 0.5 * pow(LIVRTE, 3.0);
+    if (ETAMDE < 0) ETAMDE = 0;
+    if (ETAMDE > 1) ETAMDE = 1;
+    if (ETAMLE < 0) ETAMLE = 0;
+    if (ETAMLE > 1) ETAMLE = 1;
+
+    double IRE = b.ired * ETAMDE;
+    IRE = b.gmaope * (IRE + (b.irel * ETAMLE));
+
+    // Probability of ignition, from the Nelson-derived fuel surface temperature
+    double PNORM1 = 0.00232, PNORM2 = 0.99767;
+    double TMPPRM = in[DFM_IndexFuelTemp];
+    double PI = -1;
+    if (Ignition)
+    {
+        double QIGN = 144.5 - (0.266 * TMPPRM) - (0.00058 * TMPPRM * TMPPRM)
+                 - (0.01 * TMPPRM * MC1)
+              + 18.54 * (1.0 - exp(-0.151 * MC1))
+              + 6.4 * MC1;
+        if (QIGN < 344.0)
+        {
+            double CHI = (344.0 - QIGN) / 10.0;
+            if ((pow(CHI, 3.66) * 0.000923 / 50.0) > PNORM1)
+            {
+                PI = ((pow(CHI, 3.66) * 0.000923 / 50.0) - PNORM1) * 100.0 / PNORM2;
+                if (PI < 0.0) PI = 0.0;
+                if (PI > 100.0) PI = 100.0;
+            }
+        }
+    }
+
+    t->ERC = 0.04 * IRE * b.tau;
+    t->PI = PI;
+    t->WTMCD = WTMCD;
+    t->WTMCL = WTMCL;
+    t->WTMCDE = WTMCDE;
+    t->WTMCLE = WTMCLE;
+}
+
+// Spread component, burning index and ignition component of a record at a
+// wind speed, on a slope whose 1 + slope factor is Slope1
+static void CalcIndexWind(const DFMSimdIndexBed& b, const IndexTerms& t, double WS, double Slope1,
+    double* SC, double* BI, double* IC)
+{
+    double PHIWND;
+    if (88.0 * WS * b.wndfc > 0.9 * t.IR)
+        PHIWND = b.ufact * pow(0.9 * t.IR, b.b);
+    else
+        PHIWND = b.ufact * pow(WS * 88.0 * b.wndfc, b.b);
+    double sc = t.IRZ * (Slope1 + PHIWND) / t.HTSINK;
+
+    double ic = 0.0;
+    if (t.PI >= 0)
+    {
+        double SCN = 100.0 * sc / b.scm;
+        if (SCN > 100.0) SCN = 100.0;
+        double PFI = pow(SCN, 0.5);
+        ic = 0.10 * t.PI * PFI;
+    }
+    if (sc < 0.00001) ic = 0.0;
+
+    *SC = sc;
+    *BI = (.301 * pow((sc * t.ERC), 0.46)) * 10.0;
+    *IC = ic;
+}
+
+// Indexes of one record, in the order of operations of NFDRS4::iCalcIndexes().
+// SC, BI and IC are only calculated if Spread, and IC is only nonzero if Ignition.
+static void CalcIndexRecord(const DFMSimdIndexBed& b, const double* in, double* out, bool Spread = true, bool Ignition = true)
+{
+    IndexTerms t;
+    CalcIndexTerms(b, in, &t, Spread, Ignition);
+    if (Spread)
+        CalcIndexWind(b, t, in[DFM_IndexWS], b.slope1, &out[DFM_IndexSC], &out[DFM_IndexBI], &out[DFM_IndexIC]);
+    out[DFM_IndexERC] = t.ERC;
+    out[DFM_IndexWTMCD] = t.WTMCD;
+    out[DFM_IndexWTMCL] = t.WTMCL;
+    out[DFM_IndexWTMCDE] = t.WTMCDE;
+    out[DFM_IndexWTMCLE] = t.WTMCLE;
+}
+
+bool NFDRS4UpdateIndexBed(const NFDRS4CompiledFuel& Fuel, double KBDI, double GSI, NFDRS4IndexBedCache* Cache)
+{
+    if (Cache->FuelId != Fuel.GetId() || KBDI != Cache->KBDI || GSI != Cache->GSI)
+    {
+        Cache->KBDI = KBDI;
+        Cache->GSI = GSI;
+        Cache->Loads = NFDRS4CalcFuelLoads(Fuel.GetBed(), KBDI, GSI);
+        Cache->Valid = Fuel.CalcBed(Cache->Loads, &Cache->Bed);
+        Cache->FuelId = Fuel.GetId();
+    }
+    return Cache->Valid;
+}
+
+int NFDRS4CalcIndexes(const NFDRS4FuelBed& Bed, int SlopeClass, int n, const NFDRS4IndexInputs& In,
+    const NFDRS4IndexOutputs& Out, bool Simd)
+{
+    return NFDRS4CalcIndexes(NFDRS4CompiledFuel(Bed, SlopeClass), n, In, Out, Simd);
+}
+
+int NFDRS4CalcIndexes(const NFDRS4CompiledFuel& Fuel, int n, const NFDRS4IndexInputs& In,
+    const NFDRS4IndexOutputs& Out, bool Simd, NFDRS4IndexBedCache* Cache)
+{
+    if (!Fuel.IsValid())
+        return 0;
+
+    const double* in[DFM_IndexInputs] = { In.MC1, In.MC10, In.MC100, In.MC1000, In.MCHERB, In.MCWOOD, In.WS, In.FuelTemperature };
+    double* out[DFM_IndexOutputs] = { Out.SC, Out.ERC, Out.BI, Out.IC, Out.WTMCD, Out.WTMCL, Out.WTMCDE, Out.WTMCLE };
+    const bool spread = Out.SC || Out.BI || Out.IC;    // Stages the exact path can skip
+    const bool ignition = Out.IC != NULL;
+
+    // Records of the current fuel bed gathered for the SIMD path, a block at a time
+    const int Block = 64;
+    int rec[Block];
+    double bin[DFM_IndexInputs][Block], bout[DFM_IndexOutputs][Block];
+    const double* binp[DFM_IndexInputs];
+    double* boutp[DFM_IndexOutputs];
+    for (int k = 0; k < DFM_IndexInputs; k++)
+        binp[k] = bin[k];
+    for (int k = 0; k < DFM_IndexOutputs; k++)
+        boutp[k] = out[k] ? bout[k] : NULL;
+    int nrec = 0;
+
+    // Fuel bed of the current run of records, carried over from the last call if it applies
+    NFDRS4IndexBedCache local;
+    NFDRS4IndexBedCache& c = Cache ? *Cache : local;
+    bool haveBed = c.FuelId == Fuel.GetId();
+    int computed = 0;
+    for (int i = 0; i <= n; i++)
+    {
+        bool newBed = i == n || !haveBed || In.KBDI[i] != c.KBDI || In.GSI[i] != c.GSI;
+        if (nrec > 0 && (newBed || nrec == Block))
+        {
+            DFMSimd::indexes(c.Bed, nrec, binp, boutp);
+            for (int k = 0; k < DFM_IndexOutputs; k++)
+            {
+                if (!out[k])
+                    continue;
+                for (int r = 0; r < nrec; r++)
+                    out[k][rec[r]] = bout[k][r];
+            }
+            nrec = 0;
+        }
+        if (i == n)
+            break;
+        if (In.WS[i] < 0)
+            continue;
+        if (newBed)
+        {
+            NFDRS4UpdateIndexBed(Fuel, In.KBDI[i], In.GSI[i], &c);
+            haveBed = true;
+        }
+        if (!c.Valid)
+            continue;
+        if (Simd)
+        {
+            rec[nrec] = i;
+            for (int k = 0; k < DFM_IndexInputs; k++)
+                bin[k][nrec] = in[k][i];
+            nrec++;
+        }
+        else
+        {
+            double rin[DFM_IndexInputs], rout[DFM_IndexOutputs] = {};
+            for (int k = 0; k < DFM_IndexInputs; k++)
+                rin[k] = in[k][i];
+            CalcIndexRecord(c.Bed, rin, rout, spread, ignition);
+            for (int k = 0; k < DFM_IndexOutputs; k++)
+            {
+                if (out[k])
+                    out[k][i] = rout[k];
+            }
+        }
+        computed++;
+    }
+    return computed;
+}
+
+int NFDRS4CalcIndexSweep(const NFDRS4CompiledFuel& Fuel, const NFDRS4IndexInputs& In, int nWinds, const double* WindSpeeds,
+    int nSlopes, const int* SlopeClasses, const NFDRS4SweepOutputs& Out, NFDRS4IndexBedCache* Cache)
+{
+    if (!Fuel.IsValid())
+        return 0;
+
+    NFDRS4IndexBedCache local;
+    NFDRS4IndexBedCache& c = Cache ? *Cache : local;
+    if (!NFDRS4UpdateIndexBed(Fuel, In.KBDI[0], In.GSI[0], &c))
+        return 0;
+
+    // Everything upstream of the wind and slope factors, once for the whole table
+    const double rin[DFM_IndexInputs] = { In.MC1[0], In.MC10[0], In.MC100[0], In.MC1000[0], In.MCHERB[0], In.MCWOOD[0], 0, In.FuelTemperature[0] };
+    IndexTerms t;
+    CalcIndexTerms(c.Bed, rin, &t);
+    if (Out.ERC)
+        *Out.ERC = t.ERC;
+
+    int computed = 0;
+    for (int s = 0; s < nSlopes; s++)
+    {
+        if ((SlopeClasses[s] < 1) || (SlopeClasses[s] > 5))
+            continue;
+        double slope1 = 1.0 + SlopeFactor[SlopeClasses[s] - 1] * c.Bed.slopebar;
+        for (int w = 0; w < nWinds; w++)
+        {
+            if (WindSpeeds[w] < 0)
+                continue;
+            double sc, bi, ic;
+            CalcIndexWind(c.Bed, t, WindSpeeds[w], slope1, &sc, &bi, &ic);
+            int cell = s * nWinds + w;
+            if (Out.SC)
+                Out.SC[cell] = sc;
+            if (Out.BI)
+                Out.BI[cell] = bi;
+            if (Out.IC)
+                Out.IC[cell] = ic;
+            computed++;
+        }
+    }
+    return computed;
+}
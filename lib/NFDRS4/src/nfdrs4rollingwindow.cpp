@@ -0,0 +1,216 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4rollingwindow.cpp
+    \brief NFDRS4RollingWindow class definition and implementation.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Custom include files
+#include "nfdrs4rollingwindow.h"
+
+NFDRS4RollingWindow::NFDRS4RollingWindow(int Capacity, double NoRecord)
+    : m_capacity(0), m_noRecord(NoRecord)
+{
+    Clear();
+    SetCapacity(Capacity);
+}
+
+// Changes the capacity, keeping the newest values that fit
+void NFDRS4RollingWindow::SetCapacity(int Capacity)
+{
+    if (Capacity < 0)
+        Capacity = 0;
+    if (Capacity == m_capacity && !m_values.empty())
+        return;
+    std::vector<double> kept;
+    for (int i = (m_size > Capacity) ? m_size - Capacity : 0; i < m_size && m_capacity > 0; i++)
+        kept.push_back((*this)[i]);
+    m_capacity = Capacity;
+    m_values.assign(Capacity > 0 ? Capacity : 1, m_noRecord);
+    m_minQ.assign(m_values.size(), 0);
+    m_maxQ.assign(m_values.size(), 0);
+    Clear();
+    for (int i = 0; i < (int)kept.size(); i++)
+        Push(kept[i]);
+}
+
+int NFDRS4RollingWindow::GetCapacity() const
+{
+    return m_capacity;
+}
+
+void NFDRS4RollingWindow::Clear()
+{
+    m_head = 0;
+    m_size = 0;
+    m_count = 0;
+    m_minHead = m_minSize = 0;
+    m_maxHead = m_maxSize = 0;
+}
+
+// Pushes Value as the newest value, dropping the oldest if the window is full
+void NFDRS4RollingWindow::Push(double Value)
+{
+    if (m_capacity == 0)
+        return;
+    if (m_size == m_capacity)
+        Evict();
+    const int slot = Wrap(m_head + m_size);
+    m_values[slot] = Value;
+    m_size++;
+    if (Value != m_noRecord)
+    {
+        m_count++;
+        while (m_maxSize > 0 && m_values[m_maxQ[Wrap(m_maxHead + m_maxSize - 1)]] <= Value)
+            m_maxSize--;
+        m_maxQ[Wrap(m_maxHead + m_maxSize)] = slot;
+        m_maxSize++;
+        while (m_minSize > 0 && m_values[m_minQ[Wrap(m_minHead + m_minSize - 1)]] >= Value)
+            m_minSize--;
+        m_minQ[Wrap(m_minHead + m_minSize)] = slot;
+        m_minSize++;
+    }
+}
+
+// Pushes n no record values, as for a gap of n hours or days
+void NFDRS4RollingWindow::PushMissing(long long n)
+{
+    if (n > m_capacity)
+        n = m_capacity;
+    for (long long i = 0; i < n; i++)
+        Push(m_noRecord);
+}
+
+// Drops the n oldest values
+void NFDRS4RollingWindow::PopFront(int n)
+{
+    for (int i = 0; i < n && m_size > 0; i++)
+        Evict();
+}
+
+// Number of values in the window, including no record values
+int NFDRS4RollingWindow::Size() const
+{
+    return m_size;
+}
+
+// Number of values in the window other than no record values
+int NFDRS4RollingWindow::Count() const
+{
+    return m_count;
+}
+
+// Sum of the values other than no record values, summed from the oldest; 0
+// if there are none
+double NFDRS4RollingWindow::Sum() const
+{
+    return SumLast(m_size);
+}
+
+// Sum of the newest n values other than no record values, summed from the
+// oldest of them; Sum() if n is at least Size()
+double NFDRS4RollingWindow::SumLast(int n) const
+{
+    if (n > m_size)
+        n = m_size;
+    double val = 0.0;
+    for (int i = m_size - n, slot = Wrap(m_head + i); i < m_size; i++, slot = Next(slot))
+    {
+        if (m_values[slot] != m_noRecord)
+            val += m_values[slot];
+    }
+    return val;
+}
+
+// Smallest value other than no record values, the no record value if there are none
+double NFDRS4RollingWindow::Min() const
+{
+    return (m_minSize > 0) ? m_values[m_minQ[m_minHead]] : m_noRecord;
+}
+
+// Largest value other than no record values, the no record value if there are none
+double NFDRS4RollingWindow::Max() const
+{
+    return (m_maxSize > 0) ? m_values[m_maxQ[m_maxHead]] : m_noRecord;
+}
+
+// Value i of the window, 0 being the oldest
+double NFDRS4RollingWindow::operator[](int i) const
+{
+    return m_values[Wrap(m_head + i)];
+}
+
+// Copies the ring into arrays of MaxCapacity elements; false if it does not fit
+bool NFDRS4RollingWindow::Save(double* Values, int* MinQ, int* MaxQ, int MaxCapacity, NFDRS4RollingWindowState* State) const
+{
+    if (m_capacity > MaxCapacity)
+        return false;
+    for (int i = 0; i < m_capacity; i++)
+    {
+        Values[i] = m_values[i];
+        MinQ[i] = m_minQ[i];
+        MaxQ[i] = m_maxQ[i];
+    }
+    State->Capacity = m_capacity;
+    State->Head = m_head;
+    State->Size = m_size;
+    State->Count = m_count;
+    State->MinHead = m_minHead;
+    State->MinSize = m_minSize;
+    State->MaxHead = m_maxHead;
+    State->MaxSize = m_maxSize;
+    return true;
+}
+
+// Copies a ring saved by Save() back; false, leaving the window unchanged, if
+// its capacity differs
+bool NFDRS4RollingWindow::Load(const double* Values, const int* MinQ, const int* MaxQ, int MaxCapacity, const NFDRS4RollingWindowState& State)
+{
+    if (State.Capacity != m_capacity || m_capacity > MaxCapacity)
+        return false;
+    for (int i = 0; i < m_capacity; i++)
+    {
+        m_values[i] = Values[i];
+        m_minQ[i] = MinQ[i];
+        m_maxQ[i] = MaxQ[i];
+    }
+    m_head = State.Head;
+    m_size = State.Size;
+    m_count = State.Count;
+    m_minHead = State.MinHead;
+    m_minSize = State.MinSize;
+    m_maxHead = State.MaxHead;
+    m_maxSize = State.MaxSize;
+    return true;
+}
+
+// Drops the oldest value
+void NFDRS4RollingWindow::Evict()
+{
+    const int slot = m_head;
+    const double value = m_values[slot];
+    m_head = Next(m_head);
+    m_size--;
+    if (value == m_noRecord)
+        return;
+    m_count--;
+    if (m_maxSize > 0 && m_maxQ[m_maxHead] == slot)
+    {
+        m_maxHead = Next(m_maxHead);
+        m_maxSize--;
+    }
+    if (m_minSize > 0 && m_minQ[m_minHead] == slot)
+    {
+        m_minHead = Next(m_minHead);
+        m_minSize--;
+    }
+}
@@ -0,0 +1,388 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4stationpool.cpp
+    \brief NFDRS4StationPool class definition and implementation.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+// Custom include files
+#include "nfdrs4stationpool.h"
+#include "utctime.h"
+
+// Cache line size assumed for the separation of stations and queues (bytes)
+static const size_t CacheLine = 64;
+
+//------------------------------------------------------------------------------
+/*! \struct NFDRS4StationSlot
+    \brief A station of an NFDRS4StationPool, with its input and outputs.
+ */
+
+struct alignas(64) NFDRS4StationSlot
+{
+    NFDRS4 Calc;                            // Station calculator
+    std::string ID;                         // Station identifier
+    std::vector<NFDRS4Observation> Obs;     // Observations queued for the next Run()
+    NFDRS4Outputs Out;                      // Caller's output arrays
+    std::string Error;                      // Error met in the last Run()
+};
+
+namespace {
+
+// A chunk of a station's observations, from Begin to Begin + chunk hours
+struct StationChunk
+{
+    int Station;
+    int Begin;
+};
+
+// A worker's chunks, in a cache line of its own
+struct alignas(64) WorkQueue
+{
+    std::mutex Lock;
+    std::deque<StationChunk> Chunks;
+};
+
+// Allocates and constructs \a n objects on a cache line boundary, keeping
+// the allocated address just below the first object (operator new is only
+// over-aligned from C++17 on)
+template <class T>
+T* alignedNew(size_t n)
+{
+    char* raw = static_cast<char*>(::operator new(n * sizeof(T) + CacheLine + sizeof(void*)));
+    uintptr_t p = reinterpret_cast<uintptr_t>(raw + sizeof(void*));
+    p = (p + CacheLine - 1) & ~(uintptr_t)(CacheLine - 1);
+    reinterpret_cast<void**>(p)[-1] = raw;
+    T* objs = reinterpret_cast<T*>(p);
+    for (size_t i = 0; i < n; i++)
+        new (objs + i) T();
+    return objs;
+}
+
+template <class T>
+void alignedDelete(T* objs, size_t n)
+{
+    if (!objs)
+        return;
+    for (size_t i = 0; i < n; i++)
+        objs[i].~T();
+    ::operator delete(reinterpret_cast<void**>(objs)[-1]);
+}
+
+// Pins the calling thread to processor \a cpu, where supported
+void pinThread(int cpu)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % CPU_SETSIZE, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32)
+    SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << (cpu % (8 * sizeof(DWORD_PTR))));
+#else
+    (void)cpu;
+#endif
+}
+
+// Output arrays of \a out from observation \a first on, for a station
+// evaluating \a nModels fuel models besides its own
+NFDRS4Outputs offsetOutputs(const NFDRS4Outputs& out, int first, int nModels)
+{
+    NFDRS4Outputs o;
+    if (out.MC1) o.MC1 = out.MC1 + first;
+    if (out.MC10) o.MC10 = out.MC10 + first;
+    if (out.MC100) o.MC100 = out.MC100 + first;
+    if (out.MC1000) o.MC1000 = out.MC1000 + first;
+    if (out.MCHERB) o.MCHERB = out.MCHERB + first;
+    if (out.MCWOOD) o.MCWOOD = out.MCWOOD + first;
+    if (out.FuelTemperature) o.FuelTemperature = out.FuelTemperature + first;
+    if (out.BI) o.BI = out.BI + first;
+    if (out.ERC) o.ERC = out.ERC + first;
+    if (out.SC) o.SC = out.SC + first;
+    if (out.IC) o.IC = out.IC + first;
+    if (out.GSI) o.GSI = out.GSI + first;
+    if (out.KBDI) o.KBDI = out.KBDI + first;
+    o.IndexHour = out.IndexHour;
+    if (out.ModelBI) o.ModelBI = out.ModelBI + first * nModels;
+    if (out.ModelERC) o.ModelERC = out.ModelERC + first * nModels;
+    if (out.ModelSC) o.ModelSC = out.ModelSC + first * nModels;
+    if (out.ModelIC) o.ModelIC = out.ModelIC + first * nModels;
+    return o;
+}
+
+// Work stealing scheduler of the chunks of one NFDRS4StationPool::Run()
+class ChunkScheduler
+{
+    public:
+        ChunkScheduler(const std::vector<NFDRS4StationSlot*>& Slots, int ChunkHours, int nWorkers)
+            : m_slots(Slots), m_chunkHours(ChunkHours), m_nWorkers(nWorkers), m_remaining(0)
+        {
+            m_queues = alignedNew<WorkQueue>(nWorkers);
+            // Deal the first chunks round robin; later chunks follow their station
+            int w = 0;
+            for (size_t s = 0; s < m_slots.size(); s++)
+            {
+                if (m_slots[s]->Obs.empty())
+                    continue;
+                StationChunk c = { (int)s, 0 };
+                m_queues[w].Chunks.push_back(c);
+                w = (w + 1) % m_nWorkers;
+                m_remaining++;
+            }
+        }
+        ~ChunkScheduler()
+        {
+            alignedDelete(m_queues, m_nWorkers);
+        }
+
+        // Runs chunks as worker \a w until every station is done
+        void Work(int w)
+        {
+            StationChunk c;
+            while (m_remaining.load() > 0)
+            {
+                if (!Next(w, &c))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (RunChunk(&c))
+                {
+                    std::lock_guard<std::mutex> guard(m_queues[w].Lock);
+                    m_queues[w].Chunks.push_back(c);
+                }
+                else
+                    m_remaining--;
+            }
+        }
+
+    private:
+        // Takes the newest chunk of worker \a w, or else the oldest chunk of another
+        bool Next(int w, StationChunk* c)
+        {
+            for (int k = 0; k < m_nWorkers; k++)
+            {
+                WorkQueue& q = m_queues[(w + k) % m_nWorkers];
+                std::lock_guard<std::mutex> guard(q.Lock);
+                if (q.Chunks.empty())
+                    continue;
+                if (k == 0)
+                {
+                    *c = q.Chunks.back();
+                    q.Chunks.pop_back();
+                }
+                else
+                {
+                    *c = q.Chunks.front();
+                    q.Chunks.pop_front();
+                }
+                return true;
+            }
+            return false;
+        }
+
+        // Runs chunk \a c and advances it to the station's next chunk; false if
+        // the station is done or failed
+        bool RunChunk(StationChunk* c)
+        {
+            NFDRS4StationSlot& s = *m_slots[c->Station];
+            const int nObs = (int)s.Obs.size();
+            const int n = (nObs - c->Begin < m_chunkHours) ? nObs - c->Begin : m_chunkHours;
+            try
+            {
+                s.Calc.Run(&s.Obs[c->Begin], n, offsetOutputs(s.Out, c->Begin, s.Calc.GetNumFuelModels()));
+            }
+            catch (const utctime::UTCTimeException& e)
+            {
+                s.Error = e.what();
+                return false;
+            }
+            catch (const std::exception& e)
+            {
+                s.Error = e.what();
+                return false;
+            }
+            catch (...)
+            {
+                s.Error = "unknown error";
+                return false;
+            }
+            c->Begin += n;
+            return c->Begin < nObs;
+        }
+
+        const std::vector<NFDRS4StationSlot*>& m_slots;
+        int m_chunkHours;
+        int m_nWorkers;
+        WorkQueue* m_queues;
+        std::atomic<int> m_remaining;
+};
+
+}
+
+NFDRS4StationPool::NFDRS4StationPool()
+    : m_chunkHours(24), m_pinThreads(false)
+{
+}
+
+NFDRS4StationPool::~NFDRS4StationPool()
+{
+    for (size_t i = 0; i < m_slots.size(); i++)
+        alignedDelete(m_slots[i], 1);
+}
+
+int NFDRS4StationPool::AddStation(const std::string& ID)
+{
+    NFDRS4StationSlot* slot = alignedNew<NFDRS4StationSlot>(1);
+    slot->ID = ID;
+    m_slots.push_back(slot);
+    return (int)m_slots.size() - 1;
+}
+
+NFDRS4& NFDRS4StationPool::Station(int Index)
+{
+    return m_slots.at(Index)->Calc;
+}
+
+const NFDRS4& NFDRS4StationPool::Station(int Index) const
+{
+    return m_slots.at(Index)->Calc;
+}
+
+const std::string& NFDRS4StationPool::GetStationID(int Index) const
+{
+    return m_slots.at(Index)->ID;
+}
+
+int NFDRS4StationPool::GetNumStations() const
+{
+    return (int)m_slots.size();
+}
+
+void NFDRS4StationPool::AddObservation(int Index, const NFDRS4Observation& Obs)
+{
+    m_slots.at(Index)->Obs.push_back(Obs);
+}
+
+void NFDRS4StationPool::SetObservations(int Index, const NFDRS4Observation* Obs, int nObs)
+{
+    std::vector<NFDRS4Observation>& obs = m_slots.at(Index)->Obs;
+    obs.clear();
+    if (Obs && nObs > 0)
+        obs.assign(Obs, Obs + nObs);
+}
+
+int NFDRS4StationPool::GetNumObservations(int Index) const
+{
+    return (int)m_slots.at(Index)->Obs.size();
+}
+
+void NFDRS4StationPool::SetOutputs(int Index, const NFDRS4Outputs& Out)
+{
+    m_slots.at(Index)->Out = Out;
+}
+
+// Runs every station over its queued observations: each worker thread takes
+// its own newest chunk, so a station tends to stay on one thread while it
+// has observations left, and steals the oldest chunk of another worker when
+// it has none.  Stations are independent and each one's chunks run in
+// order, so the results do not depend on the number of threads.
+bool NFDRS4StationPool::Run(int nThreads)
+{
+    if (nThreads <= 0)
+        nThreads = (int)std::thread::hardware_concurrency();
+    if (nThreads > (int)m_slots.size())
+        nThreads = (int)m_slots.size();
+    if (nThreads < 1)
+        nThreads = 1;
+    for (size_t i = 0; i < m_slots.size(); i++)
+        m_slots[i]->Error.clear();
+
+    {
+        ChunkScheduler scheduler(m_slots, m_chunkHours, nThreads);
+        if (nThreads == 1)
+            scheduler.Work(0);
+        else
+        {
+            const bool pin = m_pinThreads;
+            std::vector<std::thread> workers;
+            for (int w = 0; w < nThreads; w++)
+            {
+                workers.push_back(std::thread([&scheduler, pin, w]() {
+                    if (pin)
+                        pinThread(w);
+                    scheduler.Work(w);
+                }));
+            }
+            for (size_t w = 0; w < workers.size(); w++)
+                workers[w].join();
+        }
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < m_slots.size(); i++)
+    {
+        m_slots[i]->Obs.clear();
+        if (!m_slots[i]->Error.empty())
+            ok = false;
+    }
+    return ok;
+}
+
+const std::string& NFDRS4StationPool::GetError(int Index) const
+{
+    return m_slots.at(Index)->Error;
+}
+
+/// @brief Sets the number of observations per scheduled chunk (default 24).
+/// Shorter chunks balance uneven series better, longer ones cost less scheduling.
+void NFDRS4StationPool::SetChunkHours(int Hours)
+{
+    m_chunkHours = Hours < 1 ? 1 : Hours;
+}
+
+int NFDRS4StationPool::GetChunkHours() const
+{
+    return m_chunkHours;
+}
+
+/// @brief Pins worker thread w of Run() to processor w (Linux and Windows only).
+void NFDRS4StationPool::SetPinThreads(bool Pin)
+{
+    m_pinThreads = Pin;
+}
+
+bool NFDRS4StationPool::GetPinThreads() const
+{
+    return m_pinThreads;
+}
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+/*! \file dfmbatchtest.cpp
+    \brief Regression test: a DeadFuelMoistureBatch gives exactly the results
+    of the same sticks updated one by one.
+
+    Each standard size class is run over 60 days of hourly weather as a
+    batch of stations with their own weather and stick parameters, and as
+    one DeadFuelMoisture stick per station; the 1-h class is run again with
+    tabulated diffusivity.  The test fails if any lane's moisture,
+    temperature or state differs from its scalar stick at any hour.  Builds
+    with FP_COMPUTE_TYPE float, where the batch still computes in double,
+    skip the test.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Custom include files
+#include "deadfuelmoisturebatch.h"
+
+static const int Days = 60;
+static const int Lanes = 7;
+
+// Hourly weather of hour Index, from June 1, at station Lane: air temperature
+// (oC), relative humidity (fraction), solar radiation (W/m2) and rainfall (cm)
+static void Weather(int Index, int Lane, double* at, double* rh, double* sW, double* rain)
+{
+    int day = Index / 24, hour = Index % 24;
+    double cycle = sin((hour - 9 + 0.5 * Lane) / 24.0 * 6.2832);
+    *at = 20.0 + Lane + 10.0 * cycle + 4.0 * sin(day / 9.0);
+    *rh = (55.0 - 30.0 * cycle - 10.0 * sin((day + Lane) / 9.0)) / 100.0;
+    *sW = (hour > 6 && hour < 19) ? (800.0 - 40.0 * Lane) * sin((hour - 6) / 13.0 * 3.1416) : 0.0;
+    *rain = 0.0;
+    if ((day + Lane) % 7 == 3 && hour >= 14 && hour < 17)
+        *rain = 0.2;                    // Afternoon shower
+    if (Lane % 2 == 0 && day >= 30 && day < 32 && hour % 3 == 0)
+        *rain = 0.4;                    // Two days of soaking rain
+}
+
+// Runs Lanes sticks like Prototype as a batch and one by one; returns the failures
+static int Compare(const DeadFuelMoisture& Prototype, const char* Name)
+{
+    std::vector<DeadFuelMoisture> sticks(Lanes, Prototype);
+    DeadFuelMoistureBatch batch(Prototype, Lanes);
+    for (int k = 0; k < Lanes; k++)
+    {
+        sticks[k].setStickDensity(0.38 + 0.01 * k);
+        sticks[k].setAdsorptionRate(0.06 + 0.005 * k);
+        if (!batch.setStick(k, sticks[k]))
+        {
+            printf("FAIL: %s stick, lane %d is rejected by the batch\n", Name, k);
+            return 1;
+        }
+    }
+
+    int failures = 0;
+    double at[Lanes], rh[Lanes], sW[Lanes], rain[Lanes];
+    for (int i = 0; i < Days * 24 && failures == 0; i++)
+    {
+        int year = 2020, month = 6 + i / (24 * 30), day = 1 + (i / 24) % 30, hour = i % 24;
+        for (int k = 0; k < Lanes; k++)
+        {
+            Weather(i, k, &at[k], &rh[k], &sW[k], &rain[k]);
+            sticks[k].update(year, month, day, hour, 0, 0, at[k], rh[k], sW[k], rain[k], 0.0218, true);
+        }
+        batch.update(year, month, day, hour, 0, 0, at, rh, sW, rain, 0.0218, true);
+        for (int k = 0; k < Lanes; k++)
+        {
+            if (batch.medianRadialMoisture(k) != sticks[k].medianRadialMoisture()
+                || batch.meanWtdMoisture(k) != sticks[k].meanWtdMoisture()
+                || batch.surfaceMoisture(k) != sticks[k].surfaceMoisture()
+                || batch.meanWtdTemperature(k) != sticks[k].meanWtdTemperature()
+                || batch.surfaceTemperature(k) != sticks[k].surfaceTemperature()
+                || batch.state(k) != sticks[k].state())
+            {
+                printf("FAIL: %s stick, lane %d differs from its scalar stick at hour %d\n", Name, k, i);
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+int main()
+{
+    if (sizeof(FP_COMPUTE_TYPE) != sizeof(double))
+    {
+        printf("Skipped: the batch computes in double and the sticks in FP_COMPUTE_TYPE\n");
+        return 77;
+    }
+
+    DeadFuelMoisture prototypes[4];
+    prototypes[0].initDeadFuelMoisture1();
+    prototypes[1].initDeadFuelMoisture10();
+    prototypes[2].initDeadFuelMoisture100();
+    prototypes[3].initDeadFuelMoisture1000();
+    const char* names[4] = { "1-h", "10-h", "100-h", "1000-h" };
+
+    int failures = 0;
+    for (int s = 0; s < 4; s++)
+        failures += Compare(prototypes[s], names[s]);
+    DeadFuelMoisture tabulated(prototypes[0]);
+    tabulated.setTabulatedDiffusivity(true);
+    failures += Compare(tabulated, "tabulated 1-h");
+
+    if (failures == 0)
+        printf("Batched sticks give exactly the results of the scalar sticks\n");
+    return failures == 0 ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+//  End of dfmbatchtest.cpp
+//------------------------------------------------------------------------------
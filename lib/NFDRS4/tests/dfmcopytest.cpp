@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+/*! \file dfmcopytest.cpp
+    \brief Regression test: copies of dead fuel sticks and stations continue
+    exactly as the originals.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <cmath>
+#include <cstdio>
+
+// Custom include files
+#include "nfdrs4.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char* what, int hour)
+{
+    if (!ok)
+    {
+        printf("FAIL: %s differs from the original at hour %d\n", what, hour);
+        failures++;
+    }
+}
+
+// Hourly weather of day Day (0 based, from June 1) with a morning shower every fourth day
+static void Update(NFDRS4& Station, int Day, int Hour)
+{
+    double temp = 70.0 + 20.0 * sin((Hour - 9) / 24.0 * 6.2832);
+    double rh = 50.0 - 30.0 * sin((Hour - 9) / 24.0 * 6.2832);
+    double ppt = (Day % 4 == 0 && Hour >= 5 && Hour < 8) ? 0.05 : 0.0;
+    double solar = (Hour > 6 && Hour < 19) ? 800.0 * sin((Hour - 6) / 13.0 * 3.1416) : 0.0;
+    Station.Update(2020, 6 + Day / 30, 1 + Day % 30, Hour, temp, rh, ppt, solar, 8.0, false);
+}
+
+// Same observation for a lone stick, at the inputs NFDRS4 would pass it
+static void Update(DeadFuelMoisture& Stick, int Day, int Hour)
+{
+    double at = (70.0 + 20.0 * sin((Hour - 9) / 24.0 * 6.2832) - 32.0) * 5.0 / 9.0;
+    double rh = (50.0 - 30.0 * sin((Hour - 9) / 24.0 * 6.2832)) / 100.0;
+    double ppt = (Day % 4 == 0 && Hour >= 5 && Hour < 8) ? 0.05 * 2.54 : 0.0;
+    Stick.update(2020, 6 + Day / 30, 1 + Day % 30, Hour, 0, 0, at, rh, 0.0, ppt, 0.0218, true);
+}
+
+int main()
+{
+    NFDRS4 station(45.0, 'Y', 1, 30.0, true, true, false);
+    for (int d = 0; d < 20; d++)
+        for (int h = 0; h < 24; h++)
+            Update(station, d, h);
+
+    // Copy constructed station
+    NFDRS4 copy(station);
+    for (int i = 0; i < 72; i++)
+    {
+        int d = 20 + i / 24, h = i % 24;
+        Update(station, d, h);
+        Update(copy, d, h);
+        check(copy.MC1 == station.MC1 && copy.MC10 == station.MC10 && copy.MC100 == station.MC100
+            && copy.MC1000 == station.MC1000, "copied station moisture", i);
+        check(copy.GetERC() == station.GetERC() && copy.GetBI() == station.GetBI(), "copied station indexes", i);
+    }
+
+    // Copy constructed and assigned sticks, the first update after the copy included
+    DeadFuelMoistureStandard& stick = station.OneHourFM;
+    DeadFuelMoistureStandard copyStick(stick);
+    DeadFuelMoisture assignedStick(0.2, "assigned");
+    assignedStick = stick;
+    for (int i = 0; i < 48; i++)
+    {
+        int d = 23 + i / 24, h = i % 24;
+        Update(stick, d, h);
+        Update(copyStick, d, h);
+        Update(assignedStick, d, h);
+        check(copyStick.medianRadialMoisture() == stick.medianRadialMoisture()
+            && copyStick.surfaceTemperature() == stick.surfaceTemperature(), "copied stick", i);
+        check(assignedStick.medianRadialMoisture() == stick.medianRadialMoisture()
+            && assignedStick.surfaceTemperature() == stick.surfaceTemperature(), "assigned stick", i);
+    }
+
+    if (failures == 0)
+        printf("Copies of sticks and stations continue exactly as the originals\n");
+    return failures == 0 ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+//  End of dfmcopytest.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+/*! \file dfmimplicittest.cpp
+    \brief Comparison harness: the implicit dead fuel solver against Nelson's
+    explicit scheme on the 1-h, 10-h, 100-h and 1000-h sticks.
+
+    Each standard stick is run over 90 days of hourly weather, with
+    diurnal cycles, showers and a soaking rain, by Nelson's explicit scheme
+    at ten times its derived steps, taken as the converged solution, and at
+    its derived steps, and by the implicit solver at the derived steps and
+    at the reduced steps of the README (48/12/8/4).  The moisture
+    differences from the converged solution and the moisture time steps per
+    update are reported.  The test fails if the implicit solver strays
+    beyond the bounds below, is not closer on average to the converged
+    solution than the explicit scheme at its derived steps, or does not
+    take the steps it was given.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+// Custom include files
+#include "deadfuelmoisture.h"
+
+static const int Days = 90;
+
+// Hourly weather of hour Index, from June 1: air temperature (oC), relative
+// humidity (fraction), solar radiation (W/m2) and rainfall (cm)
+static void Weather(int Index, double* at, double* rh, double* sW, double* rain)
+{
+    int day = Index / 24, hour = Index % 24;
+    double cycle = sin((hour - 9) / 24.0 * 6.2832);
+    *at = 22.0 + 10.0 * cycle + 4.0 * sin(day / 9.0);
+    *rh = (55.0 - 30.0 * cycle - 10.0 * sin(day / 9.0)) / 100.0;
+    *sW = (hour > 6 && hour < 19) ? 800.0 * sin((hour - 6) / 13.0 * 3.1416) : 0.0;
+    *rain = 0.0;
+    if (day % 7 == 3 && hour >= 14 && hour < 17)
+        *rain = 0.2;                    // Afternoon shower
+    if (day >= 40 && day < 42 && hour % 3 == 0)
+        *rain = 0.4;                    // Two days of soaking rain
+}
+
+struct Comparison
+{
+    double meanDiff, maxDiff;       // Moisture content difference from the converged solution (%)
+    int steps;                      // Moisture time steps taken by the last update
+};
+
+// Runs Stick over the weather; Reference holds the converged moistures (%), or is filled if Fill
+static Comparison Run(DeadFuelMoisture& Stick, double* Reference, bool Fill)
+{
+    Comparison c = { 0.0, 0.0, 0 };
+    const int hours = Days * 24;
+    for (int i = 0; i < hours; i++)
+    {
+        double at, rh, sW, rain;
+        Weather(i, &at, &rh, &sW, &rain);
+        Stick.update(2020, 6 + i / (24 * 30), 1 + (i / 24) % 30, i % 24, 0, 0, at, rh, sW, rain, 0.0218, true);
+        double mc = Stick.medianRadialMoisture() * 100.0;
+        if (Fill)
+            Reference[i] = mc;
+        double diff = std::isfinite(mc) ? fabs(mc - Reference[i]) : 1.0e9;
+        c.meanDiff += diff;
+        if (diff > c.maxDiff)
+            c.maxDiff = diff;
+    }
+    c.meanDiff /= hours;
+    c.steps = Stick.substeps();
+    return c;
+}
+
+int main()
+{
+    typedef DeadFuelMoisture* (*Factory)(const std::string&);
+    const Factory factories[4] = { DeadFuelMoisture::createDeadFuelMoisture1, DeadFuelMoisture::createDeadFuelMoisture10,
+        DeadFuelMoisture::createDeadFuelMoisture100, DeadFuelMoisture::createDeadFuelMoisture1000 };
+    const char* names[4] = { "1-h", "10-h", "100-h", "1000-h" };
+    const int reducedSteps[4] = { 48, 12, 8, 4 };
+    // Largest mean and maximum differences (%) accepted from the implicit solver
+    const double meanLimit[4] = { 0.12, 0.16, 0.07, 0.02 };
+    const double maxLimit[4] = { 5.5, 2.8, 0.3, 0.1 };
+
+    int failures = 0;
+    static double reference[Days * 24];
+    printf("%-7s %-20s %9s %9s %6s\n", "Stick", "Scheme", "Mean diff", "Max diff", "Steps");
+    for (int s = 0; s < 4; s++)
+    {
+        std::unique_ptr<DeadFuelMoisture> conv(factories[s](names[s]));
+        std::unique_ptr<DeadFuelMoisture> expl(factories[s](names[s]));
+        std::unique_ptr<DeadFuelMoisture> impl(factories[s](names[s]));
+        std::unique_ptr<DeadFuelMoisture> reduced(factories[s](names[s]));
+        const int derivedSteps = expl->moistureSteps();
+        conv->setMoistureSteps(10 * derivedSteps);
+        impl->setImplicitSolver(true);
+        reduced->setImplicitSolver(true, reducedSteps[s]);
+
+        Run(*conv, reference, true);
+        Comparison e = Run(*expl, reference, false);
+        Comparison i = Run(*impl, reference, false);
+        Comparison r = Run(*reduced, reference, false);
+        char label[32];
+        printf("%-7s %-20s %9.4f %9.4f %6d\n", names[s], "explicit", e.meanDiff, e.maxDiff, e.steps);
+        printf("%-7s %-20s %9.4f %9.4f %6d\n", names[s], "implicit", i.meanDiff, i.maxDiff, i.steps);
+        snprintf(label, sizeof(label), "implicit %d steps", reducedSteps[s]);
+        printf("%-7s %-20s %9.4f %9.4f %6d\n", names[s], label, r.meanDiff, r.maxDiff, r.steps);
+
+        const Comparison* runs[2] = { &i, &r };
+        for (int k = 0; k < 2; k++)
+        {
+            if (runs[k]->meanDiff > meanLimit[s] || runs[k]->maxDiff > maxLimit[s])
+            {
+                printf("FAIL: %s stick, implicit%s, strays beyond %g%% mean / %g%% max\n",
+                    names[s], k ? " at reduced steps" : "", meanLimit[s], maxLimit[s]);
+                failures++;
+            }
+            if (runs[k]->meanDiff > e.meanDiff)
+            {
+                printf("FAIL: %s stick, implicit%s, is further from the converged solution than the explicit scheme\n",
+                    names[s], k ? " at reduced steps" : "");
+                failures++;
+            }
+        }
+        // Nelson's loop takes one step more than it is given, the implicit solver none
+        if (e.steps != derivedSteps + 1 || i.steps != derivedSteps || r.steps != reducedSteps[s])
+        {
+            printf("FAIL: %s stick, the implicit solver does not take the steps it was given\n", names[s]);
+            failures++;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+//  End of dfmimplicittest.cpp
+//------------------------------------------------------------------------------
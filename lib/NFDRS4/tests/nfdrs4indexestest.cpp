@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4indexestest.cpp
+    \brief Regression test: the SIMD path of NFDRS4CalcIndexes() stays within
+    its stated tolerance of the exact path.
+
+    A month of hourly records, with dead and live fuel moistures from very
+    dry to wet, calm to strong winds and a KBDI and GSI that change daily,
+    is run through the exact and SIMD paths for every standard fuel model
+    and slope class, at every instruction set the host supports.  The test
+    fails if an SC, ERC, BI or IC differs by 1.0e-11 or more, relative to
+    the index or to 1 if the index is smaller, if a weighted moisture
+    differs likewise, or if the paths compute or skip different records.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Custom include files
+#include "nfdrs4.h"
+#include "nfdrs4indexes.h"
+
+static const int Records = 30 * 24;
+static const double Tolerance = 1.0e-11;
+static const double Unwritten = -12345.0;
+
+// Inputs of the records
+struct IndexRecords
+{
+    std::vector<double> MC1, MC10, MC100, MC1000, MCHERB, MCWOOD, FuelTemperature, WS, KBDI, GSI;
+
+    IndexRecords() : MC1(Records), MC10(Records), MC100(Records), MC1000(Records), MCHERB(Records),
+        MCWOOD(Records), FuelTemperature(Records), WS(Records), KBDI(Records), GSI(Records)
+    {
+        for (int i = 0; i < Records; i++)
+        {
+            int day = i / 24, hour = i % 24;
+            double cycle = sin((hour - 9) / 24.0 * 6.2832), season = sin(day / 4.0);
+            MC1[i] = 12.0 - 9.0 * cycle + 8.0 * season + (day % 6 == 0 ? 20.0 : 0.0);
+            MC10[i] = 14.0 - 6.0 * cycle + 7.0 * season;
+            MC100[i] = 16.0 + 6.0 * season;
+            MC1000[i] = 18.0 + 5.0 * sin(day / 9.0);
+            MCHERB[i] = 30.0 + 110.0 * (1.0 + sin(day / 5.0));
+            MCWOOD[i] = 60.0 + 70.0 * (1.0 + sin(day / 7.0));
+            FuelTemperature[i] = 20.0 + 15.0 * cycle;
+            WS[i] = floor(12.0 + 10.0 * cycle + 8.0 * season + 0.5);
+            if (day % 11 == 5 && hour == 3)
+                WS[i] = -1.0;           // Skipped record
+            KBDI[i] = (day * 37) % 800;
+            GSI[i] = 0.5 + 0.5 * sin(day / 3.0);
+        }
+    }
+
+    NFDRS4IndexInputs Inputs() const
+    {
+        NFDRS4IndexInputs in;
+        in.MC1 = &MC1[0];
+        in.MC10 = &MC10[0];
+        in.MC100 = &MC100[0];
+        in.MC1000 = &MC1000[0];
+        in.MCHERB = &MCHERB[0];
+        in.MCWOOD = &MCWOOD[0];
+        in.FuelTemperature = &FuelTemperature[0];
+        in.WS = &WS[0];
+        in.KBDI = &KBDI[0];
+        in.GSI = &GSI[0];
+        return in;
+    }
+};
+
+// Outputs of the records
+struct Indexes
+{
+    std::vector<double> Values[8];
+
+    Indexes()
+    {
+        for (int k = 0; k < 8; k++)
+            Values[k].assign(Records, Unwritten);
+    }
+
+    NFDRS4IndexOutputs Outputs()
+    {
+        NFDRS4IndexOutputs out;
+        out.SC = &Values[0][0];
+        out.ERC = &Values[1][0];
+        out.BI = &Values[2][0];
+        out.IC = &Values[3][0];
+        out.WTMCD = &Values[4][0];
+        out.WTMCL = &Values[5][0];
+        out.WTMCDE = &Values[6][0];
+        out.WTMCLE = &Values[7][0];
+        return out;
+    }
+};
+
+int main()
+{
+    static const char* outputNames[8] = { "SC", "ERC", "BI", "IC", "WTMCD", "WTMCL", "WTMCDE", "WTMCLE" };
+    const IndexRecords records;
+    NFDRS4 station;
+    std::vector<char> models;
+    for (const auto& fm : station.GetFuelModelMap())
+        models.push_back(fm.first);
+    std::sort(models.begin(), models.end());
+
+    int failures = 0;
+    const DFMSimdLevel host = DFMSimd::level();
+    for (int level = DFM_SimdScalar; level <= DFM_SimdAVX512; level++)
+    {
+        if (!DFMSimd::setLevel((DFMSimdLevel)level))
+            continue;
+        double largest = 0.0;
+        for (char model : models)
+        {
+            station.iSetFuelModel(model);
+            NFDRS4FuelBed bed = station.GetFuelBed();
+            for (int slope = 1; slope <= 5; slope++)
+            {
+                Indexes exact, simd;
+                int nExact = NFDRS4CalcIndexes(bed, slope, Records, records.Inputs(), exact.Outputs(), false);
+                int nSimd = NFDRS4CalcIndexes(bed, slope, Records, records.Inputs(), simd.Outputs(), true);
+                if (nExact == 0 || nExact != nSimd)
+                {
+                    printf("FAIL: %s, fuel model %c, slope class %d computes %d records, the exact path %d\n",
+                        DFMSimd::levelName((DFMSimdLevel)level), model, slope, nSimd, nExact);
+                    failures++;
+                    continue;
+                }
+                for (int k = 0; k < 8; k++)
+                {
+                    for (int i = 0; i < Records; i++)
+                    {
+                        double e = exact.Values[k][i], s = simd.Values[k][i];
+                        double diff = (e == Unwritten || s == Unwritten) ? (e == s ? 0.0 : 1.0)
+                            : fabs(s - e) / std::max(fabs(e), 1.0);
+                        largest = std::max(largest, diff);
+                        if (!(diff < Tolerance))
+                        {
+                            printf("FAIL: %s, fuel model %c, slope class %d, record %d: %s %.17g, exact %.17g\n",
+                                DFMSimd::levelName((DFMSimdLevel)level), model, slope, i, outputNames[k], s, e);
+                            failures++;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        printf("%-8s largest difference from the exact path %.3g\n", DFMSimd::levelName((DFMSimdLevel)level), largest);
+    }
+    DFMSimd::setLevel(host);
+
+    if (failures == 0)
+        printf("SIMD indexes are within %g of the exact path\n", Tolerance);
+    return failures == 0 ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+//  End of nfdrs4indexestest.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,171 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4lazytest.cpp
+    \brief Regression test: lazy indexes give exactly the values of eager
+    updates, whatever the caller reads and when.
+
+    A station on each standard fuel model, with two more fuel models of
+    NFDRS4::SetFuelModels(), is run over 40 days of hourly weather eagerly
+    and with NFDRS4::SetLazyIndexes().  From hour to hour the lazy station
+    has all its indexes read, only ERC, none, or all in another order; its
+    members are checked after CalcPendingIndexes() once a day, and lazy
+    indexes are turned off and on again every ten days.  The same stations
+    are then run by NFDRS4::Run(), lazily with NFDRS4Outputs::IndexHour.
+    The test fails if any value read differs from the eager one.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Custom include files
+#include "nfdrs4.h"
+
+static const int Days = 40;
+static const int IndexHour = 13;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what, char Model, int Hour)
+{
+    if (!ok)
+    {
+        printf("FAIL: fuel model %c, %s differs from the eager update at hour %d\n", Model, what, Hour);
+        failures++;
+    }
+}
+
+// Observation of hour Index, from June 1, with an afternoon shower every fourth day
+static NFDRS4Observation Observation(int Index)
+{
+    int day = Index / 24, hour = Index % 24;
+    double cycle = sin((hour - 9) / 24.0 * 6.2832);
+    NFDRS4Observation obs;
+    obs.Year = 2020;
+    obs.Month = 6 + day / 30;
+    obs.Day = 1 + day % 30;
+    obs.Hour = hour;
+    obs.Temp = 72.0 + 20.0 * cycle;
+    obs.RH = 48.0 - 30.0 * cycle;
+    obs.PPTAmt = (day % 4 == 1 && hour >= 14 && hour < 17) ? 0.05 : 0.0;
+    obs.SolarRad = (hour > 6 && hour < 19) ? 800.0 * sin((hour - 6) / 13.0 * 3.1416) : 0.0;
+    obs.WS = 7.0 + 6.0 * cycle;
+    obs.SnowDay = false;
+    return obs;
+}
+
+static void Update(NFDRS4& Station, const NFDRS4Observation& Obs)
+{
+    Station.Update(Obs.Year, Obs.Month, Obs.Day, Obs.Hour, Obs.Temp, Obs.RH, Obs.PPTAmt, Obs.SolarRad, Obs.WS, Obs.SnowDay);
+}
+
+// Compares the indexes of SetFuelModels() models of both stations
+static void CompareModels(NFDRS4& Lazy, NFDRS4& Eager, char Model, int Hour)
+{
+    for (int m = 0; m < Eager.GetNumFuelModels(); m++)
+    {
+        double lazy[4], eager[4];
+        Lazy.GetModelIndexes(m, &lazy[0], &lazy[1], &lazy[2], &lazy[3]);
+        Eager.GetModelIndexes(m, &eager[0], &eager[1], &eager[2], &eager[3]);
+        check(lazy[0] == eager[0] && lazy[1] == eager[1] && lazy[2] == eager[2] && lazy[3] == eager[3],
+            "a SetFuelModels() model", Model, Hour);
+    }
+}
+
+// Sizes SC, ERC, BI and IC arrays Out of n elements and points Run() outputs at them
+static NFDRS4Outputs IndexOutputs(std::vector<double>* Out, int n)
+{
+    for (int k = 0; k < 4; k++)
+        Out[k].assign(n, -1.0);
+    NFDRS4Outputs outs;
+    outs.SC = &Out[0][0];
+    outs.ERC = &Out[1][0];
+    outs.BI = &Out[2][0];
+    outs.IC = &Out[3][0];
+    return outs;
+}
+
+int main()
+{
+    const char models[] = "VWXYZ";
+    std::vector<NFDRS4Observation> obs;
+    for (int i = 0; i < Days * 24; i++)
+        obs.push_back(Observation(i));
+
+    for (int m = 0; m < 5; m++)
+    {
+        const char model = models[m];
+        NFDRS4 eager(38.0, model, 3, 20.0, true, true, m % 2 == 1);
+        eager.SetFuelModels(m < 2 ? "YZ" : "VW");
+        NFDRS4 lazy(eager);
+        lazy.SetLazyIndexes(true);
+        for (int i = 0; i < Days * 24; i++)
+        {
+            Update(eager, obs[i]);
+            Update(lazy, obs[i]);
+            if (i % 240 == 120)
+                lazy.SetLazyIndexes(false);
+            else if (i % 240 == 130)
+                lazy.SetLazyIndexes(true);
+            check(lazy.MC1 == eager.MC1 && lazy.MC1000 == eager.MC1000 && lazy.MCHERB == eager.MCHERB
+                && lazy.KBDI == eager.KBDI, "moisture", model, i);
+            switch (i % 4)
+            {
+                case 0:
+                    check(lazy.GetSC() == eager.SC && lazy.GetERC() == eager.ERC && lazy.GetBI() == eager.BI
+                        && lazy.GetIC() == eager.IC, "reading all indexes", model, i);
+                    CompareModels(lazy, eager, model, i);
+                    break;
+                case 1:
+                    check(lazy.GetERC() == eager.ERC, "reading ERC only", model, i);
+                    break;
+                case 2:
+                    break;
+                case 3:
+                    check(lazy.GetIC() == eager.IC && lazy.GetBI() == eager.BI && lazy.GetERC() == eager.ERC
+                        && lazy.GetSC() == eager.SC, "reading IC first", model, i);
+                    CompareModels(lazy, eager, model, i);
+                    break;
+            }
+            if (i % 24 == 21)
+            {
+                lazy.CalcPendingIndexes();
+                check(lazy.SC == eager.SC && lazy.ERC == eager.ERC && lazy.BI == eager.BI && lazy.IC == eager.IC,
+                    "members after CalcPendingIndexes()", model, i);
+            }
+        }
+
+        // NFDRS4::Run(), lazily limited to the index hour
+        NFDRS4 eagerRun(38.0, model, 3, 20.0, true, true, m % 2 == 1);
+        NFDRS4 lazyRun(eagerRun);
+        lazyRun.SetLazyIndexes(true);
+        const int n = Days * 24;
+        std::vector<double> eagerOut[4], lazyOut[4];
+        NFDRS4Outputs eagerOuts = IndexOutputs(eagerOut, n), lazyOuts = IndexOutputs(lazyOut, n);
+        lazyOuts.IndexHour = IndexHour;
+        eagerRun.Run(&obs[0], n, eagerOuts);
+        lazyRun.Run(&obs[0], n, lazyOuts);
+        for (int i = IndexHour; i < n; i += 24)
+            check(lazyOut[0][i] == eagerOut[0][i] && lazyOut[1][i] == eagerOut[1][i] && lazyOut[2][i] == eagerOut[2][i]
+                && lazyOut[3][i] == eagerOut[3][i], "Run() at the index hour", model, i);
+    }
+
+    if (failures == 0)
+        printf("Lazy indexes equal the eager ones\n");
+    return failures == 0 ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+//  End of nfdrs4lazytest.cpp
+//------------------------------------------------------------------------------
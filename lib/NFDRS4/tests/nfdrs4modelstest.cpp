@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4modelstest.cpp
+    \brief Regression test: the indexes of NFDRS4::SetFuelModels() models
+    equal those of separate stations on each model.
+
+    A station on fuel model Y evaluates the five standard fuel models on its
+    moisture simulation over 40 days of hourly weather, without and with
+    moisture of extinction and spread component overrides, beside one
+    station per model with the same overrides.  The same runs are repeated
+    through NFDRS4::Run() and its model outputs.  The test fails if any
+    model's SC, ERC, BI or IC differs from its separate station.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Custom include files
+#include "nfdrs4.h"
+
+static const int Days = 40;
+static const std::string Models = "VWXYZ";
+
+static int failures = 0;
+
+// Observation of hour Index, from June 1, with an afternoon shower every sixth day
+static NFDRS4Observation Observation(int Index)
+{
+    int day = Index / 24, hour = Index % 24;
+    double cycle = sin((hour - 9) / 24.0 * 6.2832);
+    NFDRS4Observation obs;
+    obs.Year = 2020;
+    obs.Month = 6 + day / 30;
+    obs.Day = 1 + day % 30;
+    obs.Hour = hour;
+    obs.Temp = 74.0 + 19.0 * cycle;
+    obs.RH = 45.0 - 28.0 * cycle;
+    obs.PPTAmt = (day % 6 == 4 && hour >= 15 && hour < 18) ? 0.07 : 0.0;
+    obs.SolarRad = (hour > 6 && hour < 19) ? 800.0 * sin((hour - 6) / 13.0 * 3.1416) : 0.0;
+    obs.WS = 9.0 + 7.0 * cycle;
+    obs.SnowDay = false;
+    return obs;
+}
+
+// Station on FuelModel, with the overrides of SetFuelModels() if positive
+static NFDRS4* CreateStation(char FuelModel, int MXD, int SCMax)
+{
+    NFDRS4* station = new NFDRS4(42.0, FuelModel, 2, 22.0, true, true, false);
+    if (MXD > 0)
+        station->SetMXD(MXD);
+    if (SCMax > 0)
+        station->SetSCMax(SCMax);
+    return station;
+}
+
+// Compares the models of Multi, updated hour by hour, with one station per model
+static void CompareUpdates(const std::vector<NFDRS4Observation>& Obs, int MXD, int SCMax)
+{
+    std::unique_ptr<NFDRS4> multi(CreateStation('Y', 0, 0));
+    multi->SetFuelModels(Models, MXD, SCMax);
+    std::vector<std::unique_ptr<NFDRS4> > single;
+    for (size_t m = 0; m < Models.size(); m++)
+        single.emplace_back(CreateStation(Models[m], MXD, SCMax));
+
+    for (size_t i = 0; i < Obs.size(); i++)
+    {
+        const NFDRS4Observation& o = Obs[i];
+        multi->Update(o.Year, o.Month, o.Day, o.Hour, o.Temp, o.RH, o.PPTAmt, o.SolarRad, o.WS, o.SnowDay);
+        for (size_t m = 0; m < Models.size(); m++)
+        {
+            single[m]->Update(o.Year, o.Month, o.Day, o.Hour, o.Temp, o.RH, o.PPTAmt, o.SolarRad, o.WS, o.SnowDay);
+            double sc, erc, bi, ic;
+            multi->GetModelIndexes((int)m, &sc, &erc, &bi, &ic);
+            if (sc != single[m]->GetSC() || erc != single[m]->GetERC() || bi != single[m]->GetBI() || ic != single[m]->GetIC())
+            {
+                printf("FAIL: fuel model %c, MXD %d, SCMax %d, differs from its own station at hour %d\n",
+                    Models[m], MXD, SCMax, (int)i);
+                failures++;
+                return;
+            }
+        }
+    }
+}
+
+// Compares the model outputs of Run() with the index outputs of one Run() per model
+static void CompareRuns(const std::vector<NFDRS4Observation>& Obs, int MXD, int SCMax)
+{
+    const int n = (int)Obs.size(), nModels = (int)Models.size();
+    std::unique_ptr<NFDRS4> multi(CreateStation('Y', 0, 0));
+    multi->SetFuelModels(Models, MXD, SCMax);
+    std::vector<double> modelOut[4];
+    for (int k = 0; k < 4; k++)
+        modelOut[k].assign(n * nModels, -1.0);
+    NFDRS4Outputs multiOuts;
+    multiOuts.ModelSC = &modelOut[0][0];
+    multiOuts.ModelERC = &modelOut[1][0];
+    multiOuts.ModelBI = &modelOut[2][0];
+    multiOuts.ModelIC = &modelOut[3][0];
+    multi->Run(&Obs[0], n, multiOuts);
+
+    for (int m = 0; m < nModels; m++)
+    {
+        std::unique_ptr<NFDRS4> single(CreateStation(Models[m], MXD, SCMax));
+        std::vector<double> out[4];
+        for (int k = 0; k < 4; k++)
+            out[k].assign(n, -1.0);
+        NFDRS4Outputs outs;
+        outs.SC = &out[0][0];
+        outs.ERC = &out[1][0];
+        outs.BI = &out[2][0];
+        outs.IC = &out[3][0];
+        single->Run(&Obs[0], n, outs);
+        for (int i = 0; i < n; i++)
+        {
+            int e = i * nModels + m;
+            if (modelOut[0][e] != out[0][i] || modelOut[1][e] != out[1][i] || modelOut[2][e] != out[2][i]
+                || modelOut[3][e] != out[3][i])
+            {
+                printf("FAIL: fuel model %c, MXD %d, SCMax %d, Run() differs from its own station at hour %d\n",
+                    Models[m], MXD, SCMax, i);
+                failures++;
+                break;
+            }
+        }
+    }
+}
+
+int main()
+{
+    std::vector<NFDRS4Observation> obs;
+    for (int i = 0; i < Days * 24; i++)
+        obs.push_back(Observation(i));
+
+    CompareUpdates(obs, 0, 0);
+    CompareUpdates(obs, 30, 80);
+    CompareRuns(obs, 0, 0);
+    CompareRuns(obs, 30, 80);
+
+    if (failures == 0)
+        printf("Fuel model indexes equal those of separate stations\n");
+    return failures == 0 ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+//  End of nfdrs4modelstest.cpp
+//------------------------------------------------------------------------------
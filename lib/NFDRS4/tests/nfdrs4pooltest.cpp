@@ -0,0 +1,165 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4pooltest.cpp
+    \brief Regression test: the results of an NFDRS4StationPool do not depend
+    on its number of threads or chunk size.
+
+    Stations on different fuel models, slope classes and latitudes, with
+    series of different lengths, are run by NFDRS4::Run() one at a time,
+    then by pools of 1, 2, 3 and 8 threads with several chunk sizes, in two
+    Run() calls each.  The test fails if any pool output differs from the
+    station run on its own, or if a pool reports an error.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Custom include files
+#include "nfdrs4stationpool.h"
+
+static const int Stations = 7;
+static const char FuelModels[] = "VWXYZ";
+
+// Observation Index of the series of station Station, from June 1
+static NFDRS4Observation Observation(int Station, int Index)
+{
+    int day = Index / 24, hour = Index % 24;
+    double cycle = sin((hour - 9 + Station) / 24.0 * 6.2832);
+    NFDRS4Observation obs;
+    obs.Year = 2020;
+    obs.Month = 6 + day / 30;
+    obs.Day = 1 + day % 30;
+    obs.Hour = hour;
+    obs.Temp = 68.0 + 2.0 * Station + 18.0 * cycle;
+    obs.RH = 50.0 - 30.0 * cycle;
+    obs.PPTAmt = ((day + Station) % 5 == 0 && hour >= 15 && hour < 18) ? 0.04 : 0.0;
+    obs.SolarRad = (hour > 6 && hour < 19) ? 800.0 * sin((hour - 6) / 13.0 * 3.1416) : 0.0;
+    obs.WS = 4.0 + Station + 6.0 * cycle;
+    obs.SnowDay = false;
+    return obs;
+}
+
+// Hours of observations of station Station
+static int Hours(int Station)
+{
+    return 24 * (10 + 2 * Station) + 5 * Station;
+}
+
+static void Init(NFDRS4& Station, int Index)
+{
+    Station.Init(35.0 + 2.0 * Index, FuelModels[Index % 5], 1 + Index % 5, 15.0 + 3.0 * Index, true, true, Index % 2 == 0, 100);
+}
+
+// Output arrays of one station
+struct Results
+{
+    std::vector<double> MC1, MC10, MC100, MC1000, MCHERB, MCWOOD, BI, ERC, SC, IC, GSI;
+    std::vector<int> KBDI;
+
+    explicit Results(int n) : MC1(n), MC10(n), MC100(n), MC1000(n), MCHERB(n), MCWOOD(n), BI(n), ERC(n), SC(n), IC(n),
+        GSI(n), KBDI(n) {}
+
+    NFDRS4Outputs Outputs(int First)
+    {
+        NFDRS4Outputs out;
+        out.MC1 = &MC1[First];
+        out.MC10 = &MC10[First];
+        out.MC100 = &MC100[First];
+        out.MC1000 = &MC1000[First];
+        out.MCHERB = &MCHERB[First];
+        out.MCWOOD = &MCWOOD[First];
+        out.BI = &BI[First];
+        out.ERC = &ERC[First];
+        out.SC = &SC[First];
+        out.IC = &IC[First];
+        out.GSI = &GSI[First];
+        out.KBDI = &KBDI[First];
+        return out;
+    }
+
+    bool operator==(const Results& r) const
+    {
+        return MC1 == r.MC1 && MC10 == r.MC10 && MC100 == r.MC100 && MC1000 == r.MC1000 && MCHERB == r.MCHERB
+            && MCWOOD == r.MCWOOD && BI == r.BI && ERC == r.ERC && SC == r.SC && IC == r.IC && GSI == r.GSI
+            && KBDI == r.KBDI;
+    }
+};
+
+int main()
+{
+    std::vector<std::vector<NFDRS4Observation> > series(Stations);
+    std::vector<Results> reference;
+    for (int k = 0; k < Stations; k++)
+    {
+        for (int i = 0; i < Hours(k); i++)
+            series[k].push_back(Observation(k, i));
+        reference.push_back(Results(Hours(k)));
+        NFDRS4 station;
+        Init(station, k);
+        station.Run(&series[k][0], Hours(k), reference[k].Outputs(0));
+    }
+
+    int failures = 0;
+    const int threads[4] = { 1, 2, 3, 8 };
+    const int chunkHours[3] = { 24, 7, 1000 };
+    for (int t = 0; t < 4; t++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            NFDRS4StationPool pool;
+            pool.SetChunkHours(chunkHours[c]);
+            std::vector<Results> results;
+            for (int k = 0; k < Stations; k++)
+            {
+                Init(pool.Station(pool.AddStation("S" + std::to_string(k))), k);
+                results.push_back(Results(Hours(k)));
+            }
+            // The series in two runs, split at a different hour for each station
+            for (int run = 0; run < 2; run++)
+            {
+                for (int k = 0; k < Stations; k++)
+                {
+                    int split = Hours(k) / 3 + 11 * k;
+                    int first = run ? split : 0, n = run ? Hours(k) - split : split;
+                    pool.SetObservations(k, &series[k][first], n);
+                    pool.SetOutputs(k, results[k].Outputs(first));
+                }
+                if (!pool.Run(threads[t]))
+                {
+                    printf("FAIL: %d threads, %d hour chunks, run %d reports an error\n", threads[t], chunkHours[c], run);
+                    failures++;
+                }
+            }
+            for (int k = 0; k < Stations; k++)
+            {
+                if (!(results[k] == reference[k]))
+                {
+                    printf("FAIL: %d threads, %d hour chunks, station %d differs from the station run on its own\n",
+                        threads[t], chunkHours[c], k);
+                    failures++;
+                }
+            }
+        }
+    }
+
+    if (failures == 0)
+        printf("Pool results are identical whatever the number of threads and chunk size\n");
+    return failures == 0 ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+//  End of nfdrs4pooltest.cpp
+//------------------------------------------------------------------------------
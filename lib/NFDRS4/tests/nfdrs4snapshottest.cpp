@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4snapshottest.cpp
+    \brief Regression test: a station restored from a snapshot continues
+    exactly as the station the snapshot was taken from.
+
+    A station with the default settings, and one with multi-rate 100-h and
+    1000-h sticks, lazy indexes, two SetFuelModels() models and a randomly
+    perturbed 1-h stick, is run for 25 days and a few hours, so that the
+    multi-rate sticks have gathered observations, and a snapshot is taken.
+    The hours after it are then run from the original, from the same
+    station restored after running a different scenario, and from another
+    station with a different history restored from a memcpy() copy of the
+    snapshot.  The test fails if any fuel moisture, KBDI or index of
+    the restored runs differs from the original, or if a snapshot is
+    restored into a station with other update intervals.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Custom include files
+#include "nfdrs4.h"
+
+static const int WarmupHours = 25 * 24 + 7;
+static const int ForecastHours = 10 * 24;
+
+static int failures = 0;
+
+// Hourly weather of hour Index, from June 1, of scenario Scenario; scenarios
+// differ in their temperature, humidity and showers
+static void Update(NFDRS4& Station, int Index, int Scenario)
+{
+    int day = Index / 24, hour = Index % 24;
+    double cycle = sin((hour - 9) / 24.0 * 6.2832);
+    double ppt = ((day + Scenario) % 5 == 2 && hour >= 15 && hour < 18) ? 0.05 + 0.02 * Scenario : 0.0;
+    double solar = (hour > 6 && hour < 19) ? 800.0 * sin((hour - 6) / 13.0 * 3.1416) : 0.0;
+    Station.Update(2020, 6 + day / 30, 1 + day % 30, hour, 72.0 + 4.0 * Scenario + 18.0 * cycle,
+        48.0 - 6.0 * Scenario - 28.0 * cycle, ppt, solar, 8.0 + 5.0 * cycle, false);
+}
+
+// Settings of configuration Config, which are not part of a snapshot
+static void Setup(NFDRS4& Station, int Config)
+{
+    if (Config == 0)
+        return;
+    Station.Set100HourUpdateInterval(4);
+    Station.Set1000HourUpdateInterval(6);
+    Station.SetLazyIndexes(true);
+    Station.SetFuelModels("VX");
+    Station.OneHourFM.setRandomSeed(7);
+}
+
+// Runs Station over the forecast hours after the snapshot and returns its results
+static std::vector<double> Forecast(NFDRS4& Station)
+{
+    std::vector<double> trace;
+    for (int i = WarmupHours; i < WarmupHours + ForecastHours; i++)
+    {
+        Update(Station, i, 0);
+        const double values[] = { Station.MC1, Station.MC10, Station.MC100, Station.MC1000, Station.MCHERB,
+            Station.MCWOOD, Station.FuelTemperature, (double)Station.KBDI, Station.GetSC(), Station.GetERC(),
+            Station.GetBI(), Station.GetIC() };
+        trace.insert(trace.end(), values, values + sizeof(values) / sizeof(values[0]));
+        for (int m = 0; m < Station.GetNumFuelModels(); m++)
+        {
+            double model[4];
+            Station.GetModelIndexes(m, &model[0], &model[1], &model[2], &model[3]);
+            trace.insert(trace.end(), model, model + 4);
+        }
+    }
+    return trace;
+}
+
+static void check(bool ok, const char* what, int Config)
+{
+    if (!ok)
+    {
+        printf("FAIL: configuration %d, %s\n", Config, what);
+        failures++;
+    }
+}
+
+int main()
+{
+    for (int config = 0; config < 2; config++)
+    {
+        NFDRS4 station(40.0, 'Y', 2, 25.0, true, true, false);
+        Setup(station, config);
+        for (int i = 0; i < WarmupHours; i++)
+            Update(station, i, 0);
+        NFDRS4Snapshot snap;
+        check(station.Snapshot(&snap), "Snapshot() fails", config);
+        check(config == 0 || snap.HundredHourRate.count > 0, "the 100-h stick has no gathered observations", config);
+        const std::vector<double> reference = Forecast(station);
+
+        // The same station, restored after running another scenario from the snapshot
+        check(station.Restore(snap), "Restore() into the same station fails", config);
+        for (int i = WarmupHours; i < WarmupHours + 48; i++)
+            Update(station, i, 1);
+        check(station.Restore(snap), "Restore() after another scenario fails", config);
+        check(Forecast(station) == reference, "the restored station differs from the original", config);
+
+        // Another station with its own history, restored from a copy of the snapshot
+        NFDRS4Snapshot* copy = new NFDRS4Snapshot;
+        memcpy(copy, &snap, sizeof(NFDRS4Snapshot));
+        NFDRS4 other(40.0, 'Y', 2, 25.0, true, true, false);
+        Setup(other, config);
+        for (int i = 0; i < 72; i++)
+            Update(other, i, 2);
+        check(other.Restore(*copy), "Restore() into another station fails", config);
+        check(Forecast(other) == reference, "another station restored from a copy differs from the original", config);
+        delete copy;
+
+        // A station with other update intervals rejects the snapshot and is left unchanged
+        NFDRS4 mismatch(40.0, 'Y', 2, 25.0, true, true, false);
+        Setup(mismatch, config);
+        mismatch.Set100HourUpdateInterval(config == 0 ? 3 : 1);
+        for (int i = 0; i < WarmupHours; i++)
+            Update(mismatch, i, 0);
+        NFDRS4 unchanged(mismatch);
+        check(!mismatch.Restore(snap), "Restore() accepts a station with other update intervals", config);
+        check(Forecast(mismatch) == Forecast(unchanged), "a rejected Restore() changes the station", config);
+    }
+
+    if (failures == 0)
+        printf("Restored stations continue exactly as the originals\n");
+    return failures == 0 ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+//  End of nfdrs4snapshottest.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+/*! \file nfdrs4sweeptest.cpp
+    \brief Regression test: every cell of NFDRS4::iCalcIndexSweep() equals
+    the NFDRS4::iCalcIndexes() call for its wind speed and slope class.
+
+    A station on each standard fuel model is run over 30 days of hourly
+    weather.  Twice a day its current fuel moistures are swept over a table
+    of wind speeds and slope classes, with and without GSI and KBDI
+    overrides, and every cell is compared with iCalcIndexes() on a copy of
+    the station.  The table includes a negative wind speed and an invalid
+    slope class, whose cells must be left unwritten.  The station is run
+    alongside a twin that is never swept, and must keep giving the same
+    indexes.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <cmath>
+#include <cstdio>
+
+// Custom include files
+#include "nfdrs4.h"
+
+static const int Days = 30;
+static const int Winds = 12;
+static const int Slopes = 6;
+static const double Unwritten = -12345.0;
+
+static int failures = 0;
+
+// Hourly weather of day Day (0 based, from June 1) with an afternoon shower every fifth day
+static void Update(NFDRS4& Station, int Day, int Hour)
+{
+    double cycle = sin((Hour - 9) / 24.0 * 6.2832);
+    double ppt = (Day % 5 == 2 && Hour >= 15 && Hour < 18) ? 0.06 : 0.0;
+    double solar = (Hour > 6 && Hour < 19) ? 800.0 * sin((Hour - 6) / 13.0 * 3.1416) : 0.0;
+    Station.Update(2020, 6 + Day / 30, 1 + Day % 30, Hour, 75.0 + 18.0 * cycle, 45.0 - 28.0 * cycle, ppt, solar,
+        8.0 + 5.0 * cycle, false);
+}
+
+// Sweeps Station and compares each cell with iCalcIndexes() on a copy of it
+static void Compare(NFDRS4& Station, char Model, int Day, int Hour, double GSI, double KBDI)
+{
+    const int ws[Winds] = { 0, 1, 3, 5, 8, 12, -4, 17, 22, 30, 45, 80 };
+    const int slopes[Slopes] = { 1, 2, 3, 0, 4, 5 };
+    double sc[Slopes * Winds], bi[Slopes * Winds], ic[Slopes * Winds];
+    for (int c = 0; c < Slopes * Winds; c++)
+        sc[c] = bi[c] = ic[c] = Unwritten;
+    double before[4] = { Station.SC, Station.ERC, Station.BI, Station.IC };
+
+    int cells = Station.iCalcIndexSweep(Winds, ws, Slopes, slopes, sc, bi, ic, GSI, KBDI);
+    if (cells != (Slopes - 1) * (Winds - 1))
+    {
+        printf("FAIL: fuel model %c, day %d hour %d, the sweep computes %d cells\n", Model, Day, Hour, cells);
+        failures++;
+    }
+    if (Station.SC != before[0] || Station.ERC != before[1] || Station.BI != before[2] || Station.IC != before[3])
+    {
+        printf("FAIL: fuel model %c, day %d hour %d, the sweep changes the station's indexes\n", Model, Day, Hour);
+        failures++;
+    }
+    for (int s = 0; s < Slopes; s++)
+    {
+        for (int w = 0; w < Winds; w++)
+        {
+            int c = s * Winds + w;
+            double pointSC = Unwritten, pointERC, pointBI = Unwritten, pointIC = Unwritten;
+            if (ws[w] >= 0 && slopes[s] >= 1 && slopes[s] <= 5)
+            {
+                NFDRS4 point(Station);
+                point.iCalcIndexes(ws[w], slopes[s], &pointSC, &pointERC, &pointBI, &pointIC, GSI, KBDI);
+            }
+            if (sc[c] != pointSC || bi[c] != pointBI || ic[c] != pointIC)
+            {
+                printf("FAIL: fuel model %c, day %d hour %d, wind %d slope class %d: sweep %g/%g/%g, point %g/%g/%g\n",
+                    Model, Day, Hour, ws[w], slopes[s], sc[c], bi[c], ic[c], pointSC, pointBI, pointIC);
+                failures++;
+                return;
+            }
+        }
+    }
+}
+
+int main()
+{
+    const char models[] = "VWXYZ";
+    for (int m = 0; m < 5; m++)
+    {
+        NFDRS4 station(40.0, models[m], 2, 25.0, true, true, m % 2 == 0);
+        NFDRS4 twin(station);
+        for (int d = 0; d < Days; d++)
+        {
+            for (int h = 0; h < 24; h++)
+            {
+                Update(station, d, h);
+                Update(twin, d, h);
+                if (station.GetSC() != twin.GetSC() || station.GetERC() != twin.GetERC()
+                    || station.GetBI() != twin.GetBI() || station.GetIC() != twin.GetIC())
+                {
+                    printf("FAIL: fuel model %c, day %d hour %d, the swept station differs from its twin\n", models[m], d, h);
+                    failures++;
+                }
+                if (h == 6 || h == 15)
+                {
+                    Compare(station, models[m], d, h, -999, -999);
+                    Compare(station, models[m], d, h, 0.1 + 0.03 * d, 25.0 * d);
+                }
+            }
+        }
+    }
+
+    if (failures == 0)
+        printf("Sweep cells equal the iCalcIndexes() calls\n");
+    return failures == 0 ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+//  End of nfdrs4sweeptest.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+/*! \file diagnostics.h
+    \brief Diagnostics and DiagnosticSink class interface and declarations.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+#ifndef _DIAGNOSTICS_H_INCLUDED_
+#define _DIAGNOSTICS_H_INCLUDED_
+
+#include <string>
+
+//------------------------------------------------------------------------------
+/*! \enum DiagnosticCategory
+    \brief Groups of diagnostics with a shared counter.
+ */
+
+enum DiagnosticCategory
+{
+    DiagCategory_Time=0,        //!< Invalid dates and times (utctime).
+    DiagCategory_Observation=1, //!< Weather observations rejected by the fuel moisture models (NFDRS4).
+    DiagCategory_Model=2,       //!< Inconsistent arguments to the NFDRS4 calculator.
+    DiagCategory_Input=3,       //!< Unreadable, incomplete or out of range weather file records (fw21).
+    DiagCategories=4            //!< Number of categories.
+};
+
+//------------------------------------------------------------------------------
+/*! \enum DiagnosticCode
+    \brief Condition reported to Diagnostics::report().
+ */
+
+enum DiagnosticCode
+{
+    Diag_InvalidDate=0,         //!< utctime: date or time component out of range.
+    Diag_RegressiveTime,        //!< DeadFuelMoisture: observation not after the previous one.
+    Diag_RegressiveRainfall,    //!< DeadFuelMoisture: cumulative rainfall decreased.
+    Diag_HumidityRange,         //!< DeadFuelMoisture: relative humidity out of range.
+    Diag_TemperatureRange,      //!< DeadFuelMoisture: air temperature out of range.
+    Diag_InsolationRange,       //!< DeadFuelMoisture: solar insolation out of range.
+    Diag_JulianMismatch,        //!< NFDRS4: passed Julian day disagrees with the date.
+    Diag_StickNodes,            //!< NFDRS4: stick node count has no fixed node kernel.
+    Diag_FileOpen,              //!< CFW21Data: file cannot be opened.
+    Diag_MissingField,          //!< CFW21Data: required field missing from the header.
+    Diag_ShortLine,             //!< CFW21Data: record has too few fields.
+    Diag_BadDate,               //!< CFW21Data: record date is blank or invalid.
+    Diag_BlankField,            //!< CFW21Data: required record field is blank.
+    Diag_BadValue,              //!< CFW21Data: record value out of range, record skipped.
+    Diag_QuestionableValue,     //!< CFW21Data: record value out of range, record kept.
+    Diag_RecordOrder,           //!< CFW21Data: record not after the previous one.
+    DiagnosticCodes             //!< Number of codes.
+};
+
+//------------------------------------------------------------------------------
+/*! \class DiagnosticSink diagnostics.h
+    \brief Receives diagnostic messages installed by Diagnostics::setSink().
+
+    Calls may come from several threads at once.
+ */
+
+class DiagnosticSink
+{
+// Public methods
+public:
+    virtual ~DiagnosticSink( void ) {}
+    //! Return FALSE for codes that are only to be counted; no text is then formatted for them.
+    virtual bool wantsText( DiagnosticCode code ) const { (void) code; return( true ); }
+    //! Receives the text for \a code, without a trailing newline.
+    virtual void message( DiagnosticCode code, const std::string& text ) = 0;
+};
+
+//------------------------------------------------------------------------------
+/*! \class Diagnostics diagnostics.h
+    \brief Process wide diagnostics shared by the NFDRS4, fw21 and utctime
+    libraries.
+
+    Library code reports a condition by its code, and formats text only if
+    report() asks for it:
+
+    -- if ( Diagnostics::report( Diag_HumidityRange ) )
+    -- {
+    --     Diagnostics::format( Diag_HumidityRange, "... %f g/g.", rh );
+    -- }
+
+    report() always increments the code's counter.  It returns TRUE if the
+    installed DiagnosticSink wants text for the code and the rate limit
+    (if any) has not been reached.  Without a sink the messages go to the
+    console streams the libraries have always written them to (stdout or
+    stderr, none for Diag_InvalidDate whose text is carried by the
+    exception).  The counters, sink and rate limit are safe to use from
+    concurrent threads.
+ */
+
+class Diagnostics
+{
+// Public methods
+public:
+    static bool report( DiagnosticCode code ) ;
+    static void message( DiagnosticCode code, const std::string& text ) ;
+    static void format( DiagnosticCode code, const char* fmt, ... ) ;
+
+    static void setSink( DiagnosticSink* sink ) ;
+    static DiagnosticSink* sink( void ) ;
+    static void setRateLimit( unsigned long messagesPerCode ) ;
+    static unsigned long rateLimit( void ) ;
+
+    static unsigned long count( DiagnosticCode code ) ;
+    static unsigned long count( DiagnosticCategory category ) ;
+    static void resetCounts( void ) ;
+
+    static DiagnosticCategory category( DiagnosticCode code ) ;
+    static bool isError( DiagnosticCode code ) ;
+    static const char* name( DiagnosticCode code ) ;
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of diagnostics.h
+//------------------------------------------------------------------------------
@@ -0,0 +1,260 @@
+//------------------------------------------------------------------------------
+/*! \file diagnostics.cpp
+    \brief Diagnostics class definition and implementation.
+
+    \par Licensed under GNU GPL
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the
+    Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+ */
+
+// Standard include files
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+
+// Custom include files
+#include "diagnostics.h"
+
+// Console stream used when no sink is installed
+enum DiagStream { Stream_None, Stream_Out, Stream_Err };
+
+// Fixed properties of each DiagnosticCode
+struct DiagInfo
+{
+    const char*         name;
+    DiagnosticCategory  category;
+    bool                error;
+    DiagStream          stream;
+};
+
+static const DiagInfo Info[DiagnosticCodes] =
+{
+    { "InvalidDate",        DiagCategory_Time,          true,  Stream_None },
+    { "RegressiveTime",     DiagCategory_Observation,   true,  Stream_Err },
+    { "RegressiveRainfall", DiagCategory_Observation,   true,  Stream_Err },
+    { "HumidityRange",      DiagCategory_Observation,   true,  Stream_Err },
+    { "TemperatureRange",   DiagCategory_Observation,   true,  Stream_Err },
+    { "InsolationRange",    DiagCategory_Observation,   true,  Stream_Err },
+    { "JulianMismatch",     DiagCategory_Model,         false, Stream_Out },
+    { "StickNodes",         DiagCategory_Model,         false, Stream_Out },
+    { "FileOpen",           DiagCategory_Input,         true,  Stream_Out },
+    { "MissingField",       DiagCategory_Input,         true,  Stream_Out },
+    { "ShortLine",          DiagCategory_Input,         false, Stream_Out },
+    { "BadDate",            DiagCategory_Input,         true,  Stream_Out },
+    { "BlankField",         DiagCategory_Input,         true,  Stream_Out },
+    { "BadValue",           DiagCategory_Input,         true,  Stream_Out },
+    { "QuestionableValue",  DiagCategory_Input,         false, Stream_Out },
+    { "RecordOrder",        DiagCategory_Input,         true,  Stream_Out },
+};
+
+static std::atomic<unsigned long> Counts[DiagnosticCodes];
+static std::atomic<unsigned long> Texts[DiagnosticCodes];
+static std::atomic<DiagnosticSink*> Sink( nullptr );
+static std::atomic<unsigned long> RateLimit( 0 );
+static std::mutex ConsoleLock;
+
+//------------------------------------------------------------------------------
+/*! \brief Counts an occurrence of \a code and determines if its text is wanted.
+
+    \param[in] code Condition being reported.
+
+    \retval TRUE if the caller should format the text and pass it to
+    message() or format().
+    \retval FALSE if the occurrence is only counted.
+ */
+
+bool Diagnostics::report( DiagnosticCode code )
+{
+    Counts[code].fetch_add( 1, std::memory_order_relaxed );
+    DiagnosticSink* sink = Sink.load( std::memory_order_acquire );
+    if ( sink ? ! sink->wantsText( code ) : Info[code].stream == Stream_None )
+    {
+        return( false );
+    }
+    unsigned long limit = RateLimit.load( std::memory_order_relaxed );
+    return( limit == 0
+         || Texts[code].fetch_add( 1, std::memory_order_relaxed ) < limit );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Passes the text of a reported \a code to the sink, or writes it to
+    the console if no sink is installed.
+
+    \param[in] code Condition being reported.
+    \param[in] text Message, without a trailing newline.
+ */
+
+void Diagnostics::message( DiagnosticCode code, const std::string& text )
+{
+    DiagnosticSink* sink = Sink.load( std::memory_order_acquire );
+    if ( sink )
+    {
+        sink->message( code, text );
+        return;
+    }
+    if ( Info[code].stream == Stream_None )
+    {
+        return;
+    }
+    FILE* stream = ( Info[code].stream == Stream_Err ) ? stderr : stdout;
+    std::lock_guard<std::mutex> guard( ConsoleLock );
+    fputs( text.c_str(), stream );
+    fputc( '\n', stream );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Formats the text of a reported \a code printf() style and passes it
+    to message().
+
+    \param[in] code Condition being reported.
+    \param[in] fmt  printf() format string, without a trailing newline.
+ */
+
+void Diagnostics::format( DiagnosticCode code, const char* fmt, ... )
+{
+    char buf[1024];
+    va_list args;
+    va_start( args, fmt );
+    int n = vsnprintf( buf, sizeof( buf ), fmt, args );
+    va_end( args );
+    if ( n < (int) sizeof( buf ) )
+    {
+        message( code, std::string( buf, n < 0 ? 0 : n ) );
+        return;
+    }
+    std::string text( n + 1, '\0' );
+    va_start( args, fmt );
+    vsnprintf( &text[0], text.size(), fmt, args );
+    va_end( args );
+    text.resize( n );
+    message( code, text );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Installs the sink receiving all diagnostic text.
+
+    \param[in] sink Sink, which must outlive its installation, or NULL to
+    restore console output.
+ */
+
+void Diagnostics::setSink( DiagnosticSink* sink )
+{
+    Sink.store( sink, std::memory_order_release );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the installed sink, or NULL for console output.
+ */
+
+DiagnosticSink* Diagnostics::sink( void )
+{
+    return( Sink.load( std::memory_order_acquire ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Limits the number of texts requested by report() for each code.
+
+    Occurrences past the limit are still counted.  Resetting the counts
+    with resetCounts() restarts the limit.
+
+    \param[in] messagesPerCode Largest number of texts per code, or 0 for
+    no limit (the default).
+ */
+
+void Diagnostics::setRateLimit( unsigned long messagesPerCode )
+{
+    RateLimit.store( messagesPerCode, std::memory_order_relaxed );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of texts per code, 0 for no limit.
+ */
+
+unsigned long Diagnostics::rateLimit( void )
+{
+    return( RateLimit.load( std::memory_order_relaxed ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of times \a code has been reported.
+ */
+
+unsigned long Diagnostics::count( DiagnosticCode code )
+{
+    return( Counts[code].load( std::memory_order_relaxed ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of times codes of \a category have been
+    reported.
+ */
+
+unsigned long Diagnostics::count( DiagnosticCategory category )
+{
+    unsigned long n = 0;
+    for ( int i=0; i<DiagnosticCodes; i++ )
+    {
+        if ( Info[i].category == category )
+        {
+            n += Counts[i].load( std::memory_order_relaxed );
+        }
+    }
+    return( n );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Zeroes all counters and rate limits.
+ */
+
+void Diagnostics::resetCounts( void )
+{
+    for ( int i=0; i<DiagnosticCodes; i++ )
+    {
+        Counts[i].store( 0, std::memory_order_relaxed );
+        Texts[i].store( 0, std::memory_order_relaxed );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the category of \a code.
+ */
+
+DiagnosticCategory Diagnostics::category( DiagnosticCode code )
+{
+    return( Info[code].category );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if \a code rejects data (TRUE) or only warns (FALSE).
+ */
+
+bool Diagnostics::isError( DiagnosticCode code )
+{
+    return( Info[code].error );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the name of \a code (e.g. "HumidityRange").
+ */
+
+const char* Diagnostics::name( DiagnosticCode code )
+{
+    return( Info[code].name );
+}
+
+//------------------------------------------------------------------------------
+//  End of diagnostics.cpp
+//------------------------------------------------------------------------------
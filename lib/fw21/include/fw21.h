@@ -15,6 +15,7 @@ public:
 
 	//accessors
 	std::string GetStation() { return m_station; }
+	std::string GetMember() { return m_member; }
 	TM GetDateTime() { return m_dateTime; }
 	int GetTimeZoneOffset() { return m_tzOffset; }
 	int GetYear() { return m_dateTime.tm_year + 1900;}
@@ -44,6 +45,7 @@ public:
 	int GetKBDI() { return m_KBDI; }
 	//setters
 	void SetStation(std::string station) { m_station = station; }
+	void SetMember(std::string member) { m_member = member; }
 	void SetDateTime(TM dateTime) { m_dateTime = dateTime; }
 	void SetTimeZoneOffset(int tzOffset) { m_tzOffset = tzOffset; }
 	void SetTemp(double temp) { m_temp = temp; }
@@ -67,6 +69,7 @@ public:
 	void SetKBDI(int kbdi) { m_KBDI = kbdi; }
 private:
 	std::string m_station;
+	std::string m_member;//weather ensemble member, empty if none
 	TM m_dateTime;
 	int m_tzOffset;
 	double m_temp;//always stored in degrees F
@@ -131,7 +134,7 @@ public:
 		FW21_DFM1, FW21_DFM10, FW21_DFM100, FW21_DFM1000, 
 		FW21_LFMHERB, FW21_LFMWOOD, FW21_FUELTEMPC, 
 		FW21_BI, FW21_ERC, FW21_SC, FW21_IC, FW21_GSI, FW21_KBDI,
-		FW21_TEMPC, FW21_PCPMM, FW21_WSKPH, FW21_GSKPH, FW21_END
+		FW21_TEMPC, FW21_PCPMM, FW21_WSKPH, FW21_GSKPH, FW21_MEMBER, FW21_END
 	};
 	static std::string GetFieldName(FW21FIELDS fieldNum);
 
@@ -140,6 +143,7 @@ public:
 	NFDRSDailyRec GetNFDRSDailyRec(size_t recNum);//zero based! valid: 0->GetNumRecs() - 1
 	size_t GetNumRecs() { return m_recs.size(); }
 	bool TimeIsZulu() {return m_bTimeIsZulu; }
+	bool HasMembers() { return m_bHasMembers; }
 	TM ParseISO8061(const std::string input, int *tzOffset);
 	std::string DateToOriginal(TM inTm, int tzOffset);
 	int AddRecord(FW21Record rec);
@@ -148,6 +152,7 @@ private:
 	std::string m_fileName;
 	std::vector< FW21Record> m_recs;
 	bool m_bTimeIsZulu;
+	bool m_bHasMembers;//file has a Member column
 	int m_timeZoneOffset;
 	//ensure field names match FW21FIELDS enum values if any additions made
 	static std::vector<std::string> m_vFieldNames;// = { "StationID",DateTime","Temperature(F)","RelativeHumidity(%)","Precipitation(in)",
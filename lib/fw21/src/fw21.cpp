@@ -3,6 +3,7 @@
 #include <vector>
 #include "csv_readrow.h"
 #include "utctime.h"
+#include "diagnostics.h"
 #include <iostream>
 #include <iomanip>
 #include <cstring>
@@ -140,6 +141,7 @@ string CFW21Data::DateToOriginal(TM inTm, int tzOffset)
 FW21Record::FW21Record()
 {
 	m_station = "";
+	m_member = "";
 	memset(&m_dateTime, 0, sizeof(m_dateTime));
 	m_tzOffset = 0;
 	m_temp = dNODATA;
@@ -165,6 +167,7 @@ FW21Record::FW21Record()
 FW21Record::FW21Record(const FW21Record& rhs)
 {
 	m_station = rhs.m_station;
+	m_member = rhs.m_member;
 	m_dateTime = rhs.m_dateTime;
 	m_tzOffset = rhs.m_tzOffset;
 	m_temp = rhs.m_temp;
@@ -233,13 +236,15 @@ vector<string> CFW21Data::m_vFieldNames = { "StationID","DateTime","Temperature(
 		"1000HourDFM(%)","HerbLFM(%)","WoodyLFM(%)","FuelTemp(C)",
 		//"MinTemp(F)","MaxTemp(F)","MinRH(%)","Pcp24(in)",
 		"BI","ERC","SC","IC","GSI","KBDI",
-		"Temperature(C)","Precipitation(mm)","WindSpeed(kph)","GustSpeed(kph)"
+		"Temperature(C)","Precipitation(mm)","WindSpeed(kph)","GustSpeed(kph)",
+		"Member"
 };
 
 CFW21Data::CFW21Data()
 {
 	m_fileName = "";
 	m_bTimeIsZulu = false;
+	m_bHasMembers = false;
 	m_timeZoneOffset = 0;
 }
 
@@ -268,7 +273,8 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 	stream.open(m_fileName);
 	if (!stream.is_open())
 	{
-		printf("Error opening %s as input\n", m_fileName.c_str());
+		if (Diagnostics::report(Diag_FileOpen))
+			Diagnostics::format(Diag_FileOpen, "Error opening %s as input", m_fileName.c_str());
 		return -1;
 	}
 	char buf[1024];
@@ -284,7 +290,7 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 		fuelTempIdx, 
 		//minTempFIdx, maxTempFIdx, minRhIdx, pcp24Idx, 
 		biIdx, ercIdx, scIdx, icIdx,
-		gsiIdx, kbdiIdx;
+		gsiIdx, kbdiIdx, memberIdx;
 	staIdx = getColIndex(m_vFieldNames[FW21_STATION], vFields);
 	dtIdx = getColIndex(m_vFieldNames[FW21_DATE], vFields);
 	tmpIdx = getColIndex(m_vFieldNames[FW21_TEMPF], vFields);
@@ -313,6 +319,8 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 	icIdx = getColIndex(m_vFieldNames[FW21_IC], vFields);
 	gsiIdx = getColIndex(m_vFieldNames[FW21_GSI], vFields);
 	kbdiIdx = getColIndex(m_vFieldNames[FW21_KBDI], vFields);
+	memberIdx = getColIndex(m_vFieldNames[FW21_MEMBER], vFields);
+	m_bHasMembers = memberIdx >= 0;
 
 	bool hasStationID = false;
 	if (staIdx >= 0)
@@ -324,46 +332,48 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 	{
 		//if(staIdx < 0)
 		//	printf("Error, field %s not found in header\n", m_vFieldNames[FW21_STATION].c_str());
-		if (dtIdx < 0)
-			printf("Error, field %s not found in header\n", m_vFieldNames[FW21_DATE].c_str());
-		if (tmpIdx < 0 && tmpCIdx < 0)
-			printf("Error, field %s or %s not found in header\n", m_vFieldNames[FW21_TEMPF].c_str(), m_vFieldNames[FW21_TEMPC].c_str());
-		if (rhIdx < 0)
-			printf("Error, field %s not found in header\n", m_vFieldNames[FW21_RH].c_str());
-		if (pcpIdx < 0 && pcpmmIdx < 0)
-			printf("Error, field %s or %s not found in header\n", m_vFieldNames[FW21_PCPIN].c_str(), m_vFieldNames[FW21_PCPMM].c_str());
-		if (wsIdx < 0 && wsKphIdx < 0)
-			printf("Error, field %s or %s not found in header\n", m_vFieldNames[FW21_WSMPH].c_str(), m_vFieldNames[FW21_WSKPH].c_str());
-		if (wdirIdx < 0)
-			printf("Error, field %s not found in header\n", m_vFieldNames[FW21_WAZI].c_str());
-		if (srIdx < 0)
-			printf("Error, field %s not found in header\n", m_vFieldNames[FW21_SOLRAD].c_str());
-		if (snowIdx < 0)
-			printf("Error, field %s not found in header\n", m_vFieldNames[FW21_SNOWFLAG].c_str());
-		printf("Header line is:\n%s\n", buf);
+		if (dtIdx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s not found in header", m_vFieldNames[FW21_DATE].c_str());
+		if (tmpIdx < 0 && tmpCIdx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s or %s not found in header", m_vFieldNames[FW21_TEMPF].c_str(), m_vFieldNames[FW21_TEMPC].c_str());
+		if (rhIdx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s not found in header", m_vFieldNames[FW21_RH].c_str());
+		if (pcpIdx < 0 && pcpmmIdx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s or %s not found in header", m_vFieldNames[FW21_PCPIN].c_str(), m_vFieldNames[FW21_PCPMM].c_str());
+		if (wsIdx < 0 && wsKphIdx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s or %s not found in header", m_vFieldNames[FW21_WSMPH].c_str(), m_vFieldNames[FW21_WSKPH].c_str());
+		if (wdirIdx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s not found in header", m_vFieldNames[FW21_WAZI].c_str());
+		if (srIdx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s not found in header", m_vFieldNames[FW21_SOLRAD].c_str());
+		if (snowIdx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s not found in header", m_vFieldNames[FW21_SNOWFLAG].c_str());
+		if (Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Header line is:\n%s", buf);
 		stream.close();
 		return -2;
 	}
 	if (needMxFields && (fm1Idx < 0 || fm10Idx < 0 || fm100Idx < 0 || fm1000Idx < 0 || fmHerbIdx < 0 
 		|| fmWoodIdx < 0 || fuelTempIdx < 0 || gsiIdx < 0))
 	{
-		if (fm1Idx < 0)
-			printf("Error, field %s not found in header\n", m_vFieldNames[FW21_DFM1].c_str());
-		if (fm10Idx < 0)
-			printf("Error, field %s not found in header\n", m_vFieldNames[FW21_DFM10].c_str());
-		if (fm100Idx < 0)
-			printf("Error, field %s not found in header\n", m_vFieldNames[FW21_DFM100].c_str());
-		if (fm1000Idx < 0)
-			printf("Error, field %s not found in header\n", m_vFieldNames[FW21_DFM1000].c_str());
-		if (fmHerbIdx < 0)
-			printf("Error, field %s not found in header\n", m_vFieldNames[FW21_LFMHERB].c_str());
-		if (fmWoodIdx < 0)
-			printf("Error, field %s not found in header\n", m_vFieldNames[FW21_LFMWOOD].c_str());
-		if (fuelTempIdx < 0)
-			printf("Error, field %s not found in header\n", m_vFieldNames[FW21_FUELTEMPC].c_str());
-		if(gsiIdx < 0)
-			printf("Error, field %s not found in header\n", m_vFieldNames[FW21_GSI].c_str());
-		printf("Header line is:\n%s\n", buf);
+		if (fm1Idx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s not found in header", m_vFieldNames[FW21_DFM1].c_str());
+		if (fm10Idx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s not found in header", m_vFieldNames[FW21_DFM10].c_str());
+		if (fm100Idx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s not found in header", m_vFieldNames[FW21_DFM100].c_str());
+		if (fm1000Idx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s not found in header", m_vFieldNames[FW21_DFM1000].c_str());
+		if (fmHerbIdx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s not found in header", m_vFieldNames[FW21_LFMHERB].c_str());
+		if (fmWoodIdx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s not found in header", m_vFieldNames[FW21_LFMWOOD].c_str());
+		if (fuelTempIdx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s not found in header", m_vFieldNames[FW21_FUELTEMPC].c_str());
+		if(gsiIdx < 0 && Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Error, field %s not found in header", m_vFieldNames[FW21_GSI].c_str());
+		if (Diagnostics::report(Diag_MissingField))
+			Diagnostics::format(Diag_MissingField, "Header line is:\n%s", buf);
 		stream.close();
 		return -3;
 	}
@@ -378,7 +388,8 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 		vFields = csv_read_row(line, ',');
 		if (vFields.size() < nExpectedFields)
 		{
-			printf("Warning, line %d has less than %d fields, skipping record\n", lineNo, nExpectedFields);
+			if (Diagnostics::report(Diag_ShortLine))
+				Diagnostics::format(Diag_ShortLine, "Warning, line %d has less than %d fields, skipping record", lineNo, nExpectedFields);
 			continue;
 		}
 		//added 4/26/2024 StationID is now optional, if not present all are assumed to be 'station' parameter
@@ -392,11 +403,19 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 			strStation = station;
 		FW21Record thisRec;
 		thisRec.SetStation(strStation);
+		//optional ensemble member, records of all members are kept in file order
+		if (memberIdx >= 0)
+		{
+			string strMember = vFields[memberIdx];
+			trim(strMember);
+			thisRec.SetMember(strMember);
+		}
 		strDate = vFields[dtIdx];
 		trim(strDate);
 		if (strDate.empty())
 		{
-			printf("Error: DateTime is blank, line %d\n", lineNo);
+			if (Diagnostics::report(Diag_BadDate))
+				Diagnostics::format(Diag_BadDate, "Error: DateTime is blank, line %d", lineNo);
 			continue;
 		}
 		if (firstRec)
@@ -410,7 +429,8 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 		TM recTime = ParseISO8061(strDate, &tzOffset);
 		if (recTime.tm_mon < 0 || recTime.tm_mday <= 0 || recTime.tm_hour < 0 || recTime.tm_min < 0 || recTime.tm_sec < 0)
 		{
-			printf("Error, line %d date (%s) is invalid, skipping record\n", lineNo, strDate.c_str());
+			if (Diagnostics::report(Diag_BadDate))
+				Diagnostics::format(Diag_BadDate, "Error, line %d date (%s) is invalid, skipping record", lineNo, strDate.c_str());
 			continue;
 		}
 		thisRec.SetDateTime(recTime);
@@ -504,58 +524,69 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 		//first, check for blanks on key fields
 		if (strDate.length() <= 0)
 		{
-			printf("Error: DateTime is blank, line %d\n", lineNo);
+			if (Diagnostics::report(Diag_BadDate))
+				Diagnostics::format(Diag_BadDate, "Error: DateTime is blank, line %d", lineNo);
 			continue;
 		}
 		if (strTemp.length() <= 0)
 		{
-			printf("Error: Temperature(F) is blank, line %d, DateTime: %s\n", lineNo, strDate.c_str());
+			if (Diagnostics::report(Diag_BlankField))
+				Diagnostics::format(Diag_BlankField, "Error: Temperature(F) is blank, line %d, DateTime: %s", lineNo, strDate.c_str());
 			continue;
 		}
 		if (strRH.length() <= 0)
 		{
-			printf("Error: RelativeHumidity(%%) is blank, line %d, DateTime: %s\n", lineNo, strDate.c_str());
+			if (Diagnostics::report(Diag_BlankField))
+				Diagnostics::format(Diag_BlankField, "Error: RelativeHumidity(%%) is blank, line %d, DateTime: %s", lineNo, strDate.c_str());
 			continue;
 		}
 		if (strPcp.length() <= 0)
 		{
-			printf("Error: Precipitation(in) is blank, line %d, DateTime: %s\n", lineNo, strDate.c_str());
+			if (Diagnostics::report(Diag_BlankField))
+				Diagnostics::format(Diag_BlankField, "Error: Precipitation(in) is blank, line %d, DateTime: %s", lineNo, strDate.c_str());
 			continue;
 		}
 		if (strSolRad.length() <= 0)
 		{
-			printf("Error: SolarRadiation(W/m2) is blank, line %d, DateTime: %s\n", lineNo, strDate.c_str());
+			if (Diagnostics::report(Diag_BlankField))
+				Diagnostics::format(Diag_BlankField, "Error: SolarRadiation(W/m2) is blank, line %d, DateTime: %s", lineNo, strDate.c_str());
 			continue;
 		}
 		//now some range checks
 		if (thisRec.GetTemp() < -76.0 || thisRec.GetTemp() > 140.0)
 		{
-			printf("Error: Bad Temperature(F) line %d, %.1f, DateTime: %s\n", lineNo, thisRec.GetTemp(), strDate.c_str());
+			if (Diagnostics::report(Diag_BadValue))
+				Diagnostics::format(Diag_BadValue, "Error: Bad Temperature(F) line %d, %.1f, DateTime: %s", lineNo, thisRec.GetTemp(), strDate.c_str());
 			continue;
 		}
 		if (thisRec.GetRH() <= 0.0 || thisRec.GetRH() > 100.0)
 		{
-			printf("Error: Bad RelativeHumidity(%%) line %d, %.1f, DateTime: %s\n", lineNo, thisRec.GetRH(), strDate.c_str());
+			if (Diagnostics::report(Diag_BadValue))
+				Diagnostics::format(Diag_BadValue, "Error: Bad RelativeHumidity(%%) line %d, %.1f, DateTime: %s", lineNo, thisRec.GetRH(), strDate.c_str());
 			continue;
 		}
 		if (thisRec.GetPrecip() < 0.0 || thisRec.GetPrecip() > 20.0)
 		{
-			printf("Error: Bad Precipitation(in) line %d, %.1f, DateTime: %s\n", lineNo, thisRec.GetPrecip(), strDate.c_str());
+			if (Diagnostics::report(Diag_BadValue))
+				Diagnostics::format(Diag_BadValue, "Error: Bad Precipitation(in) line %d, %.1f, DateTime: %s", lineNo, thisRec.GetPrecip(), strDate.c_str());
 			continue;
 		}
 		if (thisRec.GetSolarRadiation() < 0.0 || thisRec.GetSolarRadiation() > 2000.0)
 		{
-			printf("Error: Bad SolarRadiation(W/m2) line %d, %.1f, DateTime: %s\n", lineNo, thisRec.GetSolarRadiation(), strDate.c_str());
+			if (Diagnostics::report(Diag_BadValue))
+				Diagnostics::format(Diag_BadValue, "Error: Bad SolarRadiation(W/m2) line %d, %.1f, DateTime: %s", lineNo, thisRec.GetSolarRadiation(), strDate.c_str());
 			continue;
 		}
 		//non-fatal warnings
 		if (thisRec.GetWindSpeed() < 0.0 || thisRec.GetWindSpeed() > 99.0)
 		{
-			printf("Warning: Bad WindSpeed(mph) line %d, %.1f, DateTime: %s\n", lineNo, thisRec.GetWindSpeed(), strDate.c_str());
+			if (Diagnostics::report(Diag_QuestionableValue))
+				Diagnostics::format(Diag_QuestionableValue, "Warning: Bad WindSpeed(mph) line %d, %.1f, DateTime: %s", lineNo, thisRec.GetWindSpeed(), strDate.c_str());
 		}
 		if (thisRec.GetWindAzimuth() < 0 || thisRec.GetWindAzimuth() > 360)
 		{
-			printf("Warning: Bad WindAzimuth(degrees) line %d, %d, DateTime: %s\n", lineNo, thisRec.GetWindAzimuth(), strDate.c_str());
+			if (Diagnostics::report(Diag_QuestionableValue))
+				Diagnostics::format(Diag_QuestionableValue, "Warning: Bad WindAzimuth(degrees) line %d, %d, DateTime: %s", lineNo, thisRec.GetWindAzimuth(), strDate.c_str());
 		}
 		if (needMxFields)
 		{
@@ -566,10 +597,11 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 				thisRec.SetMx1(atof(fm1.c_str()));
 			else
 			{
-				printf("Error: %s is blank, line %d, DateTime:: %s\n",
-					m_vFieldNames[FW21_DFM1].c_str(),
-					lineNo,
-					strDate.c_str());
+				if (Diagnostics::report(Diag_BlankField))
+					Diagnostics::format(Diag_BlankField, "Error: %s is blank, line %d, DateTime:: %s",
+						m_vFieldNames[FW21_DFM1].c_str(),
+						lineNo,
+						strDate.c_str());
 				continue;
 			}
 			fm10 = vFields[fm10Idx];
@@ -578,10 +610,11 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 				thisRec.SetMx10(atof(fm10.c_str()));
 			else
 			{
-				printf("Error: %s is blank, line %d, DateTime:: %s\n",
-					m_vFieldNames[FW21_DFM10].c_str(),
-					lineNo,
-					strDate.c_str());
+				if (Diagnostics::report(Diag_BlankField))
+					Diagnostics::format(Diag_BlankField, "Error: %s is blank, line %d, DateTime:: %s",
+						m_vFieldNames[FW21_DFM10].c_str(),
+						lineNo,
+						strDate.c_str());
 				continue;
 			}
 			fm100 = vFields[fm100Idx];
@@ -590,10 +623,11 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 				thisRec.SetMx100(atof(fm100.c_str()));
 			else
 			{
-				printf("Error: %s is blank, line %d, DateTime:: %s\n",
-					m_vFieldNames[FW21_DFM100].c_str(),
-					lineNo,
-					strDate.c_str());
+				if (Diagnostics::report(Diag_BlankField))
+					Diagnostics::format(Diag_BlankField, "Error: %s is blank, line %d, DateTime:: %s",
+						m_vFieldNames[FW21_DFM100].c_str(),
+						lineNo,
+						strDate.c_str());
 				continue;
 			}
 			fm1000 = vFields[fm1000Idx];
@@ -602,10 +636,11 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 				thisRec.SetMx1000(atof(fm1000.c_str()));
 			else
 			{
-				printf("Error: %s is blank, line %d, DateTime:: %s\n",
-					m_vFieldNames[FW21_DFM1000].c_str(),
-					lineNo,
-					strDate.c_str());
+				if (Diagnostics::report(Diag_BlankField))
+					Diagnostics::format(Diag_BlankField, "Error: %s is blank, line %d, DateTime:: %s",
+						m_vFieldNames[FW21_DFM1000].c_str(),
+						lineNo,
+						strDate.c_str());
 				continue;
 			}
 			fmHerb = vFields[fmHerbIdx];
@@ -614,10 +649,11 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 				thisRec.SetMxHerb(atof(fmHerb.c_str()));
 			else
 			{
-				printf("Error: %s is blank, line %d, DateTime:: %s\n",
-					m_vFieldNames[FW21_LFMHERB].c_str(),
-					lineNo,
-					strDate.c_str());
+				if (Diagnostics::report(Diag_BlankField))
+					Diagnostics::format(Diag_BlankField, "Error: %s is blank, line %d, DateTime:: %s",
+						m_vFieldNames[FW21_LFMHERB].c_str(),
+						lineNo,
+						strDate.c_str());
 				continue;
 			}
 			fmWood = vFields[fmWoodIdx];
@@ -626,10 +662,11 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 				thisRec.SetMxWood(atof(fmWood.c_str()));
 			else
 			{
-				printf("Error: %s is blank, line %d, DateTime:: %s\n",
-					m_vFieldNames[FW21_LFMWOOD].c_str(),
-					lineNo,
-					strDate.c_str());
+				if (Diagnostics::report(Diag_BlankField))
+					Diagnostics::format(Diag_BlankField, "Error: %s is blank, line %d, DateTime:: %s",
+						m_vFieldNames[FW21_LFMWOOD].c_str(),
+						lineNo,
+						strDate.c_str());
 				continue;
 			}
 			fuelTemp = vFields[fuelTempIdx];
@@ -638,10 +675,11 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 				thisRec.SetFuelTempC(atof(fuelTemp.c_str()));
 			else
 			{
-				printf("Error: %s is blank, line %d, DateTime:: %s\n",
-					m_vFieldNames[FW21_FUELTEMPC].c_str(),
-					lineNo,
-					strDate.c_str());
+				if (Diagnostics::report(Diag_BlankField))
+					Diagnostics::format(Diag_BlankField, "Error: %s is blank, line %d, DateTime:: %s",
+						m_vFieldNames[FW21_FUELTEMPC].c_str(),
+						lineNo,
+						strDate.c_str());
 				continue;
 			}
 			gsi = vFields[gsiIdx];
@@ -650,10 +688,11 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 				thisRec.SetGSI(atof(gsi.c_str()));
 			else
 			{
-				printf("Error: %s is blank, line %d, DateTime:: %s\n",
-					m_vFieldNames[FW21_GSI].c_str(),
-					lineNo,
-					strDate.c_str());
+				if (Diagnostics::report(Diag_BlankField))
+					Diagnostics::format(Diag_BlankField, "Error: %s is blank, line %d, DateTime:: %s",
+						m_vFieldNames[FW21_GSI].c_str(),
+						lineNo,
+						strDate.c_str());
 				continue;
 			}
 			kbdi = vFields[kbdiIdx];
@@ -662,10 +701,11 @@ int CFW21Data::LoadFile(const char *fw21FileName, std::string station, int tzOff
 				thisRec.SetKBDI(atoi(kbdi.c_str()));
 			else
 			{
-				printf("Error: %s is blank, line %d, DateTime:: %s\n",
-					m_vFieldNames[FW21_KBDI].c_str(),
-					lineNo,
-					strDate.c_str());
+				if (Diagnostics::report(Diag_BlankField))
+					Diagnostics::format(Diag_BlankField, "Error: %s is blank, line %d, DateTime:: %s",
+						m_vFieldNames[FW21_KBDI].c_str(),
+						lineNo,
+						strDate.c_str());
 				continue;
 			}
 		}
@@ -740,7 +780,8 @@ int CFW21Data::AddRecord(FW21Record rec)
 		UTCTime recUtc(rec.GetYear(), rec.GetMonth(), rec.GetDay(), rec.GetHour(), rec.GetMinutes(), 0);
 		if (rec.GetStation().compare(lastRec.GetStation()) == 0 && recUtc <= lastUtc)
 		{
-			cout << "Error, rectime is <= last record time" << endl;
+			if (Diagnostics::report(Diag_RecordOrder))
+				Diagnostics::message(Diag_RecordOrder, "Error, rectime is <= last record time");
 			return -1;
 		}
 	}
@@ -13,6 +13,7 @@
 #include <cassert>
 #include "utctime.h"
 #include "time64.h"
+#include "diagnostics.h"
 
 using namespace utctime;
 /*using std::time;
@@ -45,7 +46,8 @@ UTCTime::UTCTime() :
         throw bad_time_init();
     }
 
-    TM* ptm = gmtime64(&m_timestamp);
+    TM ptm_buf;
+    TM* ptm = gmtime64_r(&m_timestamp, &ptm_buf);
     if ( ptm == 0 ) {
         throw bad_time_init();
     }
@@ -148,7 +150,8 @@ TM UTCTime::get_tm() const {
  */
 
 std::string UTCTime::time_string() const {
-    TM* utc_tm = gmtime64(&m_timestamp);
+    TM utc_tm_buf;
+    TM* utc_tm = gmtime64_r(&m_timestamp, &utc_tm_buf);
     if ( utc_tm == 0 ) {
         throw bad_time();
     }
@@ -168,7 +171,8 @@ std::string UTCTime::time_string() const {
  */
 
 std::string UTCTime::time_string_inet() const {
-    TM* utc_tm = gmtime64(&m_timestamp);
+    TM utc_tm_buf;
+    TM* utc_tm = gmtime64_r(&m_timestamp, &utc_tm_buf);
     if ( utc_tm == 0 ) {
         throw bad_time();
     }
@@ -196,6 +200,20 @@ Time64_T UTCTime::timestamp() const {
  ********************************************************************/
 
 
+/*!
+ * \brief       Reports an invalid date to the diagnostics and throws.
+ * \param msg The reason the date is invalid.
+ * \throws      invalid_date always.
+ */
+
+static void report_invalid_date(const std::string& msg) {
+    if ( Diagnostics::report(Diag_InvalidDate) ) {
+        Diagnostics::message(Diag_InvalidDate, msg);
+    }
+    throw invalid_date(msg);
+}
+
+
 /*!
  * \brief       Checks whether a supplied date is valid.
  * \details     Checks whether a supplied date is valid.
@@ -224,33 +242,33 @@ bool utctime::validate_date(const int year, const int month,
     if ( year == 0 ) {
         std::ostringstream oss;
         oss << "Invalid year: " << year;
-        throw invalid_date(oss.str());
+        report_invalid_date(oss.str());
     } else if ( month < 1 || month > 12 ) {
         std::ostringstream oss;
         oss << "Invalid month: " << month;
-        throw invalid_date(oss.str());
+        report_invalid_date(oss.str());
     } else if ( day < 1 ) {
         std::ostringstream oss;
         oss << "Invalid day: " << day;
-        throw invalid_date(oss.str());
+        report_invalid_date(oss.str());
     } else if ( day > days_in_month[month - 1] &&
                 !(month == 2 && day == 29 && is_leap_year(year)) ) {
         std::ostringstream oss;
         oss << "Invalid day: " << day << " of " << month_names[month - 1]
             << ", " << year;
-        throw invalid_date(oss.str());
+        report_invalid_date(oss.str());
     } else if ( hour < 0 || hour > 23 ) {
         std::ostringstream oss;
         oss << "Invalid hour: " << hour;
-        throw invalid_date(oss.str());
+        report_invalid_date(oss.str());
     } else if ( minute < 0 || minute > 59 ) {
         std::ostringstream oss;
         oss << "Invalid minute: " << minute;
-        throw invalid_date(oss.str());
+        report_invalid_date(oss.str());
     } else if ( second < 0 || second > 59 ) {
         std::ostringstream oss;
         oss << "Invalid second: " << second;
-        throw invalid_date(oss.str());
+        report_invalid_date(oss.str());
     }
 
     return true;
@@ -285,7 +303,8 @@ bool utctime::check_utc_timestamp(const Time64_T check_time, int& secs_diff,
                                   const int year, const int month,
                                   const int day, const int hour,
                                   const int minute, const int second) {
-    TM* ptm = gmtime64(&check_time);
+    TM ptm_buf;
+    TM* ptm = gmtime64_r(&check_time, &ptm_buf);
     if ( ptm == 0 ) {
         throw bad_time();
     }
@@ -1003,7 +1022,8 @@ int utctime::get_utc_timestamp_sec_diff(const Time64_T check_time,
     //  Get a struct tm representing UTC time for the provided
     //  timestamp.
 
-    TM* ptm = gmtime64(&check_time);
+    TM ptm_buf;
+    TM* ptm = gmtime64_r(&check_time, &ptm_buf);
     if ( ptm == 0 ) {
         throw bad_time();
     }
@@ -22,6 +22,9 @@
 %{
 #include "../lib/utctime/include/utctime.h"
 %}
+%{
+#include "../lib/diagnostics/include/diagnostics.h"
+%}
 %include typemaps.i
 %include "std_vector.i"
 %include "std_string.i"
@@ -79,3 +82,4 @@ typedef long time_t;
 //%include "../lib/NFDRS4/include/station.h"
 %include "../lib/NFDRS4/include/nfdrs4.h"
 %include "../lib/utctime/include/utctime.h"
+%include "../lib/diagnostics/include/diagnostics.h"
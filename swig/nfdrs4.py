@@ -195,10 +195,6 @@ class DeadFuelMoisture(object):
     def deriveStickNodes(radius):
         return _nfdrs4.DeadFuelMoisture_deriveStickNodes(radius)
 
-    @staticmethod
-    def uniformRandom(min, max):
-        return _nfdrs4.DeadFuelMoisture_uniformRandom(min, max)
-
     def initializeEnvironment(self, *args):
         return _nfdrs4.DeadFuelMoisture_initializeEnvironment(self, *args)
 
@@ -901,6 +897,9 @@ class NFDRS4(object):
 
     def AddCustomFuel(self, fmParams):
         return _nfdrs4.NFDRS4_AddCustomFuel(self, fmParams)
+
+    def GetFuelModelMap(self):
+        return _nfdrs4.NFDRS4_GetFuelModelMap(self)
     CTA = property(_nfdrs4.NFDRS4_CTA_get, _nfdrs4.NFDRS4_CTA_set)
     Lat = property(_nfdrs4.NFDRS4_Lat_get, _nfdrs4.NFDRS4_Lat_set)
     NFDRSVersion = property(_nfdrs4.NFDRS4_NFDRSVersion_get, _nfdrs4.NFDRS4_NFDRSVersion_set)
@@ -979,7 +978,6 @@ class NFDRS4(object):
     qHourlyPrecip = property(_nfdrs4.NFDRS4_qHourlyPrecip_get, _nfdrs4.NFDRS4_qHourlyPrecip_set)
     qHourlyTemp = property(_nfdrs4.NFDRS4_qHourlyTemp_get, _nfdrs4.NFDRS4_qHourlyTemp_set)
     qHourlyRH = property(_nfdrs4.NFDRS4_qHourlyRH_get, _nfdrs4.NFDRS4_qHourlyRH_set)
-    mapFuels = property(_nfdrs4.NFDRS4_mapFuels_get, _nfdrs4.NFDRS4_mapFuels_set)
 
 # Register NFDRS4 in _nfdrs4:
 _nfdrs4.NFDRS4_swigregister(NFDRS4)
@@ -5851,37 +5851,6 @@ fail:
 }
 
 
-SWIGINTERN PyObject *_wrap_DeadFuelMoisture_uniformRandom(PyObject *self, PyObject *args) {
-  PyObject *resultobj = 0;
-  double arg1 ;
-  double arg2 ;
-  double val1 ;
-  int ecode1 = 0 ;
-  double val2 ;
-  int ecode2 = 0 ;
-  PyObject *swig_obj[2] ;
-  double result;
-  
-  (void)self;
-  if (!SWIG_Python_UnpackTuple(args, "DeadFuelMoisture_uniformRandom", 2, 2, swig_obj)) SWIG_fail;
-  ecode1 = SWIG_AsVal_double(swig_obj[0], &val1);
-  if (!SWIG_IsOK(ecode1)) {
-    SWIG_exception_fail(SWIG_ArgError(ecode1), "in method '" "DeadFuelMoisture_uniformRandom" "', argument " "1"" of type '" "double""'");
-  } 
-  arg1 = static_cast< double >(val1);
-  ecode2 = SWIG_AsVal_double(swig_obj[1], &val2);
-  if (!SWIG_IsOK(ecode2)) {
-    SWIG_exception_fail(SWIG_ArgError(ecode2), "in method '" "DeadFuelMoisture_uniformRandom" "', argument " "2"" of type '" "double""'");
-  } 
-  arg2 = static_cast< double >(val2);
-  result = (double)DeadFuelMoisture::uniformRandom(arg1,arg2);
-  resultobj = SWIG_From_double(static_cast< double >(result));
-  return resultobj;
-fail:
-  return NULL;
-}
-
-
 SWIGINTERN PyObject *_wrap_DeadFuelMoisture_initializeEnvironment__SWIG_0(PyObject *self, Py_ssize_t nobjs, PyObject **swig_obj) {
   PyObject *resultobj = 0;
   DeadFuelMoisture *arg1 = (DeadFuelMoisture *) 0 ;
@@ -27913,6 +27882,30 @@ fail:
 }
 
 
+SWIGINTERN PyObject *_wrap_NFDRS4_GetFuelModelMap(PyObject *self, PyObject *args) {
+  PyObject *resultobj = 0;
+  NFDRS4 *arg1 = (NFDRS4 *) 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  PyObject *swig_obj[1] ;
+  std::unordered_map< char,CFuelModelParams > *result = 0 ;
+  
+  (void)self;
+  if (!args) SWIG_fail;
+  swig_obj[0] = args;
+  res1 = SWIG_ConvertPtr(swig_obj[0], &argp1,SWIGTYPE_p_NFDRS4, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "NFDRS4_GetFuelModelMap" "', argument " "1"" of type '" "NFDRS4 const *""'"); 
+  }
+  arg1 = reinterpret_cast< NFDRS4 * >(argp1);
+  result = (std::unordered_map< char,CFuelModelParams > *) &((NFDRS4 const *)arg1)->GetFuelModelMap();
+  resultobj = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_std__unordered_mapT_char_CFuelModelParams_t, 0 |  0 );
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
 SWIGINTERN PyObject *_wrap_NFDRS4_CTA_set(PyObject *self, PyObject *args) {
   PyObject *resultobj = 0;
   NFDRS4 *arg1 = (NFDRS4 *) 0 ;
@@ -32164,60 +32157,6 @@ fail:
 }
 
 
-SWIGINTERN PyObject *_wrap_NFDRS4_mapFuels_set(PyObject *self, PyObject *args) {
-  PyObject *resultobj = 0;
-  NFDRS4 *arg1 = (NFDRS4 *) 0 ;
-  std::unordered_map< char,CFuelModelParams > *arg2 = (std::unordered_map< char,CFuelModelParams > *) 0 ;
-  void *argp1 = 0 ;
-  int res1 = 0 ;
-  void *argp2 = 0 ;
-  int res2 = 0 ;
-  PyObject *swig_obj[2] ;
-  
-  (void)self;
-  if (!SWIG_Python_UnpackTuple(args, "NFDRS4_mapFuels_set", 2, 2, swig_obj)) SWIG_fail;
-  res1 = SWIG_ConvertPtr(swig_obj[0], &argp1,SWIGTYPE_p_NFDRS4, 0 |  0 );
-  if (!SWIG_IsOK(res1)) {
-    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "NFDRS4_mapFuels_set" "', argument " "1"" of type '" "NFDRS4 *""'"); 
-  }
-  arg1 = reinterpret_cast< NFDRS4 * >(argp1);
-  res2 = SWIG_ConvertPtr(swig_obj[1], &argp2,SWIGTYPE_p_std__unordered_mapT_char_CFuelModelParams_t, 0 |  0 );
-  if (!SWIG_IsOK(res2)) {
-    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "NFDRS4_mapFuels_set" "', argument " "2"" of type '" "std::unordered_map< char,CFuelModelParams > *""'"); 
-  }
-  arg2 = reinterpret_cast< std::unordered_map< char,CFuelModelParams > * >(argp2);
-  if (arg1) (arg1)->mapFuels = *arg2;
-  resultobj = SWIG_Py_Void();
-  return resultobj;
-fail:
-  return NULL;
-}
-
-
-SWIGINTERN PyObject *_wrap_NFDRS4_mapFuels_get(PyObject *self, PyObject *args) {
-  PyObject *resultobj = 0;
-  NFDRS4 *arg1 = (NFDRS4 *) 0 ;
-  void *argp1 = 0 ;
-  int res1 = 0 ;
-  PyObject *swig_obj[1] ;
-  std::unordered_map< char,CFuelModelParams > *result = 0 ;
-  
-  (void)self;
-  if (!args) SWIG_fail;
-  swig_obj[0] = args;
-  res1 = SWIG_ConvertPtr(swig_obj[0], &argp1,SWIGTYPE_p_NFDRS4, 0 |  0 );
-  if (!SWIG_IsOK(res1)) {
-    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "NFDRS4_mapFuels_get" "', argument " "1"" of type '" "NFDRS4 *""'"); 
-  }
-  arg1 = reinterpret_cast< NFDRS4 * >(argp1);
-  result = (std::unordered_map< char,CFuelModelParams > *)& ((arg1)->mapFuels);
-  resultobj = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_std__unordered_mapT_char_CFuelModelParams_t, 0 |  0 );
-  return resultobj;
-fail:
-  return NULL;
-}
-
-
 SWIGINTERN PyObject *NFDRS4_swigregister(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *obj;
   if (!SWIG_Python_UnpackTuple(args, "swigregister", 1, 1, &obj)) return NULL;
@@ -34313,7 +34252,6 @@ static PyMethodDef SwigMethods[] = {
 	 { "DeadFuelMoisture_derivePlanarHeatTransferRate", _wrap_DeadFuelMoisture_derivePlanarHeatTransferRate, METH_O, NULL},
 	 { "DeadFuelMoisture_deriveRainfallRunoffFactor", _wrap_DeadFuelMoisture_deriveRainfallRunoffFactor, METH_O, NULL},
 	 { "DeadFuelMoisture_deriveStickNodes", _wrap_DeadFuelMoisture_deriveStickNodes, METH_O, NULL},
-	 { "DeadFuelMoisture_uniformRandom", _wrap_DeadFuelMoisture_uniformRandom, METH_VARARGS, NULL},
 	 { "DeadFuelMoisture_initializeEnvironment", _wrap_DeadFuelMoisture_initializeEnvironment, METH_VARARGS, NULL},
 	 { "DeadFuelMoisture_update", _wrap_DeadFuelMoisture_update, METH_VARARGS, NULL},
 	 { "DeadFuelMoisture_zero", _wrap_DeadFuelMoisture_zero, METH_O, NULL},
@@ -34700,6 +34638,7 @@ static PyMethodDef SwigMethods[] = {
 	 { "NFDRS4_GetMinRH", _wrap_NFDRS4_GetMinRH, METH_O, NULL},
 	 { "NFDRS4_GetPcp24", _wrap_NFDRS4_GetPcp24, METH_O, NULL},
 	 { "NFDRS4_AddCustomFuel", _wrap_NFDRS4_AddCustomFuel, METH_VARARGS, NULL},
+	 { "NFDRS4_GetFuelModelMap", _wrap_NFDRS4_GetFuelModelMap, METH_O, NULL},
 	 { "NFDRS4_CTA_set", _wrap_NFDRS4_CTA_set, METH_VARARGS, NULL},
 	 { "NFDRS4_CTA_get", _wrap_NFDRS4_CTA_get, METH_O, NULL},
 	 { "NFDRS4_Lat_set", _wrap_NFDRS4_Lat_set, METH_VARARGS, NULL},
@@ -34856,8 +34795,6 @@ static PyMethodDef SwigMethods[] = {
 	 { "NFDRS4_qHourlyTemp_get", _wrap_NFDRS4_qHourlyTemp_get, METH_O, NULL},
 	 { "NFDRS4_qHourlyRH_set", _wrap_NFDRS4_qHourlyRH_set, METH_VARARGS, NULL},
 	 { "NFDRS4_qHourlyRH_get", _wrap_NFDRS4_qHourlyRH_get, METH_O, NULL},
-	 { "NFDRS4_mapFuels_set", _wrap_NFDRS4_mapFuels_set, METH_VARARGS, NULL},
-	 { "NFDRS4_mapFuels_get", _wrap_NFDRS4_mapFuels_get, METH_O, NULL},
 	 { "NFDRS4_swigregister", NFDRS4_swigregister, METH_O, NULL},
 	 { "NFDRS4_swiginit", NFDRS4_swiginit, METH_VARARGS, NULL},
 	 { "new_UTCTimeException", _wrap_new_UTCTimeException, METH_VARARGS, NULL},